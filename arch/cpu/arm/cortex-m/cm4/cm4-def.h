@@ -45,6 +45,11 @@
 /*---------------------------------------------------------------------------*/
 #include "arm-def.h"
 /*---------------------------------------------------------------------------*/
+/* 32-bit loads may be unaligned: sum the Internet checksum a word at a time */
+#ifndef UIP_CHKSUM_CONF_WORD
+#define UIP_CHKSUM_CONF_WORD 1
+#endif /* UIP_CHKSUM_CONF_WORD */
+/*---------------------------------------------------------------------------*/
 #endif /* CM4_DEF_H_ */
 /*---------------------------------------------------------------------------*/
 /**
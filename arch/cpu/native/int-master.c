@@ -31,18 +31,22 @@
 /*---------------------------------------------------------------------------*/
 #include "contiki.h"
 #include "sys/int-master.h"
+#include "sys/rtimer.h"
 
 #include <stdbool.h>
 /*---------------------------------------------------------------------------*/
 #define DISABLED 0
 #define ENABLED  1
 /*---------------------------------------------------------------------------*/
-static int_master_status_t stat = DISABLED;
+/* Signals are delivered from the start, and the rtimer signal handler
+   reads the status, hence it starts enabled and is volatile. */
+static volatile int_master_status_t stat = ENABLED;
 /*---------------------------------------------------------------------------*/
 void
 int_master_enable(void)
 {
   stat = ENABLED;
+  rtimer_arch_run_pending();
 }
 /*---------------------------------------------------------------------------*/
 int_master_status_t
@@ -57,6 +61,9 @@ void
 int_master_status_set(int_master_status_t status)
 {
   stat = status;
+  if(status != DISABLED) {
+    rtimer_arch_run_pending();
+  }
 }
 /*---------------------------------------------------------------------------*/
 bool
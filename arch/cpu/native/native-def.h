@@ -35,5 +35,27 @@
 #define GPIO_HAL_CONF_ARCH_SW_TOGGLE     1
 #define GPIO_HAL_CONF_PORT_PIN_NUMBERING 0
 /*---------------------------------------------------------------------------*/
+#ifndef UIP_CHKSUM_CONF_ARCH_HEADER_PATH
+#define UIP_CHKSUM_CONF_ARCH_HEADER_PATH "native-chksum.h"
+#endif /* UIP_CHKSUM_CONF_ARCH_HEADER_PATH */
+/*---------------------------------------------------------------------------*/
+/*
+ * Runs real-time tasks from the main loop when a timerfd on
+ * CLOCK_MONOTONIC expires, with nanosecond rtimer ticks, instead of
+ * from a SIGALRM handler with clock_time() ticks.
+ */
+#ifdef RTIMER_ARCH_CONF_TIMERFD
+#define RTIMER_ARCH_TIMERFD RTIMER_ARCH_CONF_TIMERFD
+#elif defined(__linux__)
+#define RTIMER_ARCH_TIMERFD 1
+#else
+#define RTIMER_ARCH_TIMERFD 0
+#endif
+
+/* Nanosecond ticks would wrap in seconds with a 32-bit rtimer clock */
+#if RTIMER_ARCH_TIMERFD && !defined(RTIMER_CONF_CLOCK_SIZE)
+#define RTIMER_CONF_CLOCK_SIZE 8
+#endif
+/*---------------------------------------------------------------------------*/
 #endif /* NATIVE_DEF_H_ */
 /*---------------------------------------------------------------------------*/
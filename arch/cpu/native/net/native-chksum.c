@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Internet checksum for the native platform, with the vector
+ *         instructions of the host
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-chksum.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+/*---------------------------------------------------------------------------*/
+#if defined(__SSE2__) || defined(__ARM_NEON)
+/*
+ * The vector loops add the data as native 16-bit words into 32-bit lanes,
+ * which cannot overflow with at most 64 KiB of data. The lanes are then
+ * folded into a 16-bit sum, byte-swapped back to the host order sum of
+ * big-endian words (RFC 1071), and the remaining bytes are added by the
+ * word-at-a-time routine.
+ */
+uint16_t
+native_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint32_t lanes[8];
+  uint64_t acc;
+  int i;
+
+  if(len < 32) {
+    return uip_chksum_add_word(sum, data, len);
+  }
+
+#if defined(__AVX2__)
+  {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i vacc0 = _mm256_setzero_si256();
+    __m256i vacc1 = _mm256_setzero_si256();
+
+    while(len >= 32) {
+      __m256i v = _mm256_loadu_si256((const __m256i *)data);
+      vacc0 = _mm256_add_epi32(vacc0, _mm256_unpacklo_epi16(v, zero));
+      vacc1 = _mm256_add_epi32(vacc1, _mm256_unpackhi_epi16(v, zero));
+      data += 32;
+      len -= 32;
+    }
+    _mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi32(vacc0, vacc1));
+  }
+#elif defined(__SSE2__)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vacc0 = _mm_setzero_si128();
+    __m128i vacc1 = _mm_setzero_si128();
+
+    /* Two accumulators, so that the additions do not wait for each other */
+    while(len >= 32) {
+      __m128i v0 = _mm_loadu_si128((const __m128i *)data);
+      __m128i v1 = _mm_loadu_si128((const __m128i *)(data + 16));
+      vacc0 = _mm_add_epi32(vacc0, _mm_unpacklo_epi16(v0, zero));
+      vacc1 = _mm_add_epi32(vacc1, _mm_unpackhi_epi16(v0, zero));
+      vacc0 = _mm_add_epi32(vacc0, _mm_unpacklo_epi16(v1, zero));
+      vacc1 = _mm_add_epi32(vacc1, _mm_unpackhi_epi16(v1, zero));
+      data += 32;
+      len -= 32;
+    }
+    _mm_storeu_si128((__m128i *)lanes, vacc0);
+    _mm_storeu_si128((__m128i *)&lanes[4], vacc1);
+  }
+#else /* __ARM_NEON */
+  {
+    uint32x4_t vacc0 = vdupq_n_u32(0);
+    uint32x4_t vacc1 = vdupq_n_u32(0);
+
+    while(len >= 32) {
+      vacc0 = vpadalq_u16(vacc0, vreinterpretq_u16_u8(vld1q_u8(data)));
+      vacc1 = vpadalq_u16(vacc1, vreinterpretq_u16_u8(vld1q_u8(data + 16)));
+      data += 32;
+      len -= 32;
+    }
+    vst1q_u32(lanes, vacc0);
+    vst1q_u32(&lanes[4], vacc1);
+  }
+#endif
+
+  acc = 0;
+  for(i = 0; i < 8; i++) {
+    acc += lanes[i];
+  }
+  while(acc >> 16) {
+    acc = (acc & 0xffff) + (acc >> 16);
+  }
+  /* Add the sum so far, in host order, with the end-around carry */
+  acc = UIP_HTONS((uint16_t)acc) + (uint32_t)sum;
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  return uip_chksum_add_word((uint16_t)acc, data, len);
+}
+#endif /* defined(__SSE2__) || defined(__ARM_NEON) */
+/*---------------------------------------------------------------------------*/
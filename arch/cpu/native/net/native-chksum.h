@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Internet checksum for the native platform, with the vector
+ *         instructions of the host: SSE2 or AVX2 on x86, NEON on Arm.
+ *         Hosts with neither use the word-at-a-time routine.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef NATIVE_CHKSUM_H_
+#define NATIVE_CHKSUM_H_
+/*---------------------------------------------------------------------------*/
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+#if defined(__SSE2__) || defined(__ARM_NEON)
+uint16_t native_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len);
+
+#define uip_chksum_add(sum, data, len) native_chksum_add(sum, data, len)
+#else /* defined(__SSE2__) || defined(__ARM_NEON) */
+#define uip_chksum_add(sum, data, len) uip_chksum_add_word(sum, data, len)
+#endif /* defined(__SSE2__) || defined(__ARM_NEON) */
+/*---------------------------------------------------------------------------*/
+#endif /* NATIVE_CHKSUM_H_ */
+/*---------------------------------------------------------------------------*/
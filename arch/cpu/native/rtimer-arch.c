@@ -43,8 +43,19 @@
 #endif /* !_WIN32 */
 #include <stddef.h>
 
+#include "contiki.h"
 #include "sys/rtimer.h"
 #include "sys/clock.h"
+#include "sys/int-master.h"
+
+#if RTIMER_ARCH_TIMERFD
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#endif /* RTIMER_ARCH_TIMERFD */
 
 #define DEBUG 0
 #if DEBUG
@@ -54,12 +65,123 @@
 #define PRINTF(...)
 #endif
 
+#if RTIMER_ARCH_TIMERFD
+static int timer_fd = -1;
+/*---------------------------------------------------------------------------*/
+rtimer_clock_t
+rtimer_arch_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (rtimer_clock_t)ts.tv_sec * RTIMER_ARCH_SECOND + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static int
+set_fd(fd_set *rset, fd_set *wset)
+{
+  FD_SET(timer_fd, rset);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_fd(fd_set *rset, fd_set *wset)
+{
+  uint64_t expirations;
+
+  if(FD_ISSET(timer_fd, rset)) {
+    if(read(timer_fd, &expirations, sizeof(expirations)) < 0 &&
+       errno != EAGAIN) {
+      perror("rtimer read");
+    }
+    rtimer_run_next();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static const struct select_callback timer_callback = {
+  set_fd,
+  handle_fd
+};
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_init(void)
+{
+  timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if(timer_fd < 0) {
+    perror("timerfd_create");
+    exit(1);
+  }
+  select_set_callback(timer_fd, &timer_callback);
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_schedule(rtimer_clock_t t)
+{
+  struct itimerspec val;
+  struct timespec now;
+  rtimer_clock_t now_ticks;
+  rtimer_clock_t diff;
+
+  /*
+   * The rtimer clock may be narrower than CLOCK_MONOTONIC, so the
+   * expiration time is found from the distance to the current time.
+   */
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  now_ticks = (rtimer_clock_t)now.tv_sec * RTIMER_ARCH_SECOND + now.tv_nsec;
+  diff = RTIMER_CLOCK_LT(t, now_ticks) ? 0 : t - now_ticks;
+
+  val.it_value.tv_sec = now.tv_sec + diff / RTIMER_ARCH_SECOND;
+  val.it_value.tv_nsec = now.tv_nsec + diff % RTIMER_ARCH_SECOND;
+  if(val.it_value.tv_nsec >= RTIMER_ARCH_SECOND) {
+    val.it_value.tv_sec++;
+    val.it_value.tv_nsec -= RTIMER_ARCH_SECOND;
+  }
+  /* A zero timer value would disarm the timer instead. */
+  if(val.it_value.tv_sec == 0 && val.it_value.tv_nsec == 0) {
+    val.it_value.tv_nsec = 1;
+  }
+  val.it_interval.tv_sec = val.it_interval.tv_nsec = 0;
+
+  PRINTF("rtimer_arch_schedule time %llu in %llu ns\n",
+         (unsigned long long)t, (unsigned long long)diff);
+
+  timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &val, NULL);
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_run_pending(void)
+{
+}
+#else /* RTIMER_ARCH_TIMERFD */
+/*
+ * Like a hardware interrupt, the timer signal is held back while
+ * interrupts are disabled, and while a real-time task is running.
+ */
+static volatile sig_atomic_t pending;
+static volatile sig_atomic_t running;
 /*---------------------------------------------------------------------------*/
 static void
 interrupt(int sig)
 {
   signal(sig, interrupt);
-  rtimer_run_next();
+  pending = 1;
+  if(int_master_is_enabled()) {
+    rtimer_arch_run_pending();
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_run_pending(void)
+{
+  if(running) {
+    return;
+  }
+  running = 1;
+  while(pending) {
+    pending = 0;
+    rtimer_run_next();
+  }
+  running = 0;
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -78,9 +200,15 @@ rtimer_arch_schedule(rtimer_clock_t t)
   rtimer_clock_t c;
 
   c = t - clock_time();
-  
-  val.it_value.tv_sec = c / CLOCK_SECOND;
-  val.it_value.tv_usec = (c % CLOCK_SECOND) * CLOCK_SECOND;
+
+  if(RTIMER_CLOCK_DIFF(t, clock_time()) <= 0) {
+    /* A zero timer value would disarm the timer instead. */
+    val.it_value.tv_sec = 0;
+    val.it_value.tv_usec = 1;
+  } else {
+    val.it_value.tv_sec = c / CLOCK_SECOND;
+    val.it_value.tv_usec = (c % CLOCK_SECOND) * CLOCK_SECOND;
+  }
 
   PRINTF("rtimer_arch_schedule time %"PRIu32 " %"PRIu32 " in %ld.%ld seconds\n",
          t, c, (long)val.it_value.tv_sec, (long)val.it_value.tv_usec);
@@ -89,4 +217,5 @@ rtimer_arch_schedule(rtimer_clock_t t)
   setitimer(ITIMER_REAL, &val, NULL);
 #endif /* !_WIN32 */
 }
+#endif /* RTIMER_ARCH_TIMERFD */
 /*---------------------------------------------------------------------------*/
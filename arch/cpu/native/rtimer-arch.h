@@ -42,8 +42,29 @@
 
 #include "contiki.h"
 
+#if RTIMER_ARCH_TIMERFD
+#define RTIMER_ARCH_SECOND 1000000000
+
+#define US_TO_RTIMERTICKS(US)  ((int64_t)(US) * 1000)
+#define RTIMERTICKS_TO_US(T)   ((T) / 1000)
+#define RTIMERTICKS_TO_US_64(T) RTIMERTICKS_TO_US(T)
+
+rtimer_clock_t rtimer_arch_now(void);
+#else /* RTIMER_ARCH_TIMERFD */
 #define RTIMER_ARCH_SECOND CLOCK_CONF_SECOND
 
+#define US_TO_RTIMERTICKS(US)  ((int64_t)(US) * RTIMER_ARCH_SECOND / 1000000)
+#define RTIMERTICKS_TO_US(T)   ((T) * 1000000 / RTIMER_ARCH_SECOND)
+#define RTIMERTICKS_TO_US_64(T) RTIMERTICKS_TO_US((uint64_t)(T))
+
 #define rtimer_arch_now() clock_time()
+#endif /* RTIMER_ARCH_TIMERFD */
+
+/**
+ * Run the real-time tasks whose timer signal was held back while
+ * interrupts were disabled. Called when interrupts are enabled again.
+ * Tasks are never held back when they are run from the main loop.
+ */
+void rtimer_arch_run_pending(void);
 
 #endif /* RTIMER_ARCH_H_ */
@@ -56,8 +56,43 @@
 #define COFFEE_LOG_TABLE_LIMIT		256
 #define COFFEE_MICRO_LOGS		0
 
+#ifdef COFFEE_CONF_NAME_INDEX_SIZE
+#define COFFEE_NAME_INDEX_SIZE		COFFEE_CONF_NAME_INDEX_SIZE
+#else
+#define COFFEE_NAME_INDEX_SIZE		32
+#endif
+
+#ifdef COFFEE_CONF_PAGE_CACHE_SIZE
+#define COFFEE_PAGE_CACHE_SIZE		COFFEE_CONF_PAGE_CACHE_SIZE
+#else
+#define COFFEE_PAGE_CACHE_SIZE		4
+#endif
+
+#ifdef COFFEE_CONF_END_HINTS
+#define COFFEE_END_HINTS		COFFEE_CONF_END_HINTS
+#else
+#define COFFEE_END_HINTS		1
+#endif
+
+#ifdef COFFEE_CONF_BACKGROUND_GC
+#define COFFEE_BACKGROUND_GC		COFFEE_CONF_BACKGROUND_GC
+#else
+#define COFFEE_BACKGROUND_GC		1
+#endif
+
+#ifdef COFFEE_CONF_GC_LOW_WATERMARK
+#define COFFEE_GC_LOW_WATERMARK		COFFEE_CONF_GC_LOW_WATERMARK
+#endif
+
+/* Writes can be routed through a function of the project, e.g. one
+   that drops them to simulate a power loss. */
+#ifdef COFFEE_CONF_WRITE
+#define COFFEE_WRITE(buf, size, offset)				\
+		COFFEE_CONF_WRITE((char *)(buf), (size), COFFEE_START + (offset))
+#else
 #define COFFEE_WRITE(buf, size, offset)				\
 		xmem_pwrite((char *)(buf), (size), COFFEE_START + (offset))
+#endif
 
 #define COFFEE_READ(buf, size, offset)				\
   		xmem_pread((char *)(buf), (size), COFFEE_START + (offset))
@@ -85,6 +85,27 @@ typedef unsigned int uip_stats_t;
 #ifndef NBR_TABLE_CONF_MAX_NEIGHBORS
 #define NBR_TABLE_CONF_MAX_NEIGHBORS 300
 #endif /* NBR_TABLE_CONF_MAX_NEIGHBORS */
+#ifndef NBR_TABLE_CONF_WITH_HASH
+#define NBR_TABLE_CONF_WITH_HASH 1
+#endif /* NBR_TABLE_CONF_WITH_HASH */
+#ifndef UIP_DS6_ROUTE_CONF_WITH_TRIE
+#define UIP_DS6_ROUTE_CONF_WITH_TRIE 1
+#endif /* UIP_DS6_ROUTE_CONF_WITH_TRIE */
+#ifndef UIP_SR_CONF_WITH_CACHE
+#define UIP_SR_CONF_WITH_CACHE 1
+#endif /* UIP_SR_CONF_WITH_CACHE */
+#ifndef UIP_SR_CONF_WITH_HASH
+#define UIP_SR_CONF_WITH_HASH 1
+#endif /* UIP_SR_CONF_WITH_HASH */
+#ifndef UIP_CONF_UDP_WITH_HASH
+#define UIP_CONF_UDP_WITH_HASH 1
+#endif /* UIP_CONF_UDP_WITH_HASH */
+#ifndef UIP_CONF_TCP_SEND_WINDOW
+#define UIP_CONF_TCP_SEND_WINDOW 4
+#endif /* UIP_CONF_TCP_SEND_WINDOW */
+#ifndef UIP_CONF_REASS_CONTEXTS
+#define UIP_CONF_REASS_CONTEXTS 4
+#endif /* UIP_CONF_REASS_CONTEXTS */
 
 /* configure queues */
 #ifndef QUEUEBUF_CONF_NUM
@@ -102,6 +123,27 @@ typedef unsigned long clock_time_t;
 
 #define CLOCK_CONF_SECOND 1000
 
+/* Limits the time the main loop waits for the monitored file descriptors,
+ * e.g. for a timer that is not an etimer. To be called from a set_fd
+ * callback; it applies to the current iteration only. */
+void select_set_timeout(clock_time_t timeout);
+
+#ifndef MEMB_CONF_WITH_FREELIST
+#define MEMB_CONF_WITH_FREELIST 1
+#endif /* MEMB_CONF_WITH_FREELIST */
+
+#ifndef ETIMER_CONF_WITH_HEAP
+#define ETIMER_CONF_WITH_HEAP 1
+#endif /* ETIMER_CONF_WITH_HEAP */
+
+#ifndef CTIMER_CONF_DIRECT_DISPATCH
+#define CTIMER_CONF_DIRECT_DISPATCH 1
+#endif /* CTIMER_CONF_DIRECT_DISPATCH */
+
+#ifndef RTIMER_CONF_MULTIPLEX
+#define RTIMER_CONF_MULTIPLEX 1
+#endif /* RTIMER_CONF_MULTIPLEX */
+
 #define LOG_CONF_ENABLED 1
 
 #define PLATFORM_SUPPORTS_BUTTON_HAL 1
@@ -43,10 +43,14 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/select.h>
 #include <errno.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif /* __linux__ */
 
 #ifdef __CYGWIN__
 #include "net/wpcap-drv.h"
@@ -108,12 +112,50 @@
 #else
 #define SELECT_STDIN 1
 #endif
+
+/*
+ * Waits for the monitored file descriptors with epoll rather than select.
+ * The main loop then sleeps until the next etimer expires, or for at most
+ * SELECT_IDLE_TIMEOUT msec, instead of waking up every SELECT_TIMEOUT.
+ */
+#ifdef SELECT_CONF_EPOLL
+#define SELECT_EPOLL SELECT_CONF_EPOLL
+#elif defined(__linux__)
+#define SELECT_EPOLL 1
+#else
+#define SELECT_EPOLL 0
+#endif
+
+/*
+ * Defines the longest time (in msec) the epoll main loop sleeps when no
+ * etimer is pending.
+ */
+#ifdef SELECT_CONF_IDLE_TIMEOUT
+#define SELECT_IDLE_TIMEOUT SELECT_CONF_IDLE_TIMEOUT
+#else
+#define SELECT_IDLE_TIMEOUT 1000
+#endif
 /** @} */
 /*---------------------------------------------------------------------------*/
 
 static const struct select_callback *select_callback[SELECT_MAX];
 static int select_max = 0;
 
+/* Upper bound on the time to wait, set by the callbacks */
+static clock_time_t select_timeout;
+static int select_timeout_set;
+
+#if SELECT_EPOLL
+/* Flags of epoll_state[] besides the EPOLLIN and EPOLLOUT events */
+#define EPOLL_STATE_ADDED     0x80000000 /* Added to the epoll set */
+#define EPOLL_STATE_NO_EPOLL  0x40000000 /* Not supported by epoll, e.g.
+                                            a regular file: always ready */
+
+static int epoll_fd = -1;
+/* The events each descriptor is currently monitored for */
+static uint32_t epoll_state[SELECT_MAX];
+#endif /* SELECT_EPOLL */
+
 #ifdef PLATFORM_CONF_MAC_ADDR
 static uint8_t mac_addr[] = PLATFORM_CONF_MAC_ADDR;
 #else /* PLATFORM_CONF_MAC_ADDR */
@@ -134,6 +176,13 @@ select_set_callback(int fd, const struct select_callback *callback)
 
     select_callback[fd] = callback;
 
+#if SELECT_EPOLL
+    if(callback == NULL && (epoll_state[fd] & EPOLL_STATE_ADDED)) {
+      epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    }
+    epoll_state[fd] = 0;
+#endif /* SELECT_EPOLL */
+
     /* Update fd max */
     if(callback != NULL) {
       if(fd > select_max) {
@@ -153,6 +202,15 @@ select_set_callback(int fd, const struct select_callback *callback)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+void
+select_set_timeout(clock_time_t timeout)
+{
+  if(!select_timeout_set || timeout < select_timeout) {
+    select_timeout = timeout;
+    select_timeout_set = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
 #if SELECT_STDIN
 static int
 stdin_set_fd(fd_set *rset, fd_set *wset)
@@ -172,9 +230,15 @@ static void
 stdin_handle_fd(fd_set *rset, fd_set *wset)
 {
   char c;
+  ssize_t len;
   if(FD_ISSET(STDIN_FILENO, rset)) {
-    if(read(STDIN_FILENO, &c, 1) > 0) {
+    len = read(STDIN_FILENO, &c, 1);
+    if(len > 0) {
       input_handler(c);
+    } else if(len == 0 && !isatty(STDIN_FILENO)) {
+      /* End of file: stop monitoring stdin, which would otherwise be
+         reported as ready at every iteration */
+      select_set_callback(STDIN_FILENO, NULL);
     }
   }
 }
@@ -286,12 +350,170 @@ platform_init_stage_three()
   setvbuf(stdout, (char *)NULL, _IONBF, 0);
 }
 /*---------------------------------------------------------------------------*/
+#if SELECT_EPOLL
+/* Updates the events a descriptor is monitored for. Returns 1 if the
+ * descriptor cannot be monitored with epoll and is always ready. */
+static int
+epoll_update(int fd, uint32_t events)
+{
+  struct epoll_event ev;
+  uint32_t state = epoll_state[fd];
+
+  if(state & EPOLL_STATE_NO_EPOLL) {
+    return events != 0;
+  }
+  if((state & (EPOLLIN | EPOLLOUT)) == events &&
+     (events == 0 || (state & EPOLL_STATE_ADDED))) {
+    return 0;
+  }
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.fd = fd;
+  if(state & EPOLL_STATE_ADDED) {
+    if(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev) == 0) {
+      epoll_state[fd] = EPOLL_STATE_ADDED | events;
+      return 0;
+    }
+    /* The descriptor was closed and reopened under the same number */
+  }
+  if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0) {
+    epoll_state[fd] = EPOLL_STATE_ADDED | events;
+    return 0;
+  }
+  if(errno == EPERM) {
+    epoll_state[fd] = EPOLL_STATE_NO_EPOLL;
+    return events != 0;
+  }
+  perror("epoll_ctl");
+  epoll_state[fd] = 0;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the time to wait (in msec) until the next etimer expires */
+static int
+epoll_timeout(void)
+{
+  clock_time_t now;
+  clock_time_t next;
+  clock_time_t timeout = (clock_time_t)SELECT_IDLE_TIMEOUT * CLOCK_SECOND / 1000;
+
+  if(etimer_pending()) {
+    now = clock_time();
+    next = etimer_next_expiration_time();
+    if((long)(next - now) <= 0) {
+      return 0;
+    }
+    timeout = MIN(timeout, next - now);
+  }
+  if(select_timeout_set) {
+    timeout = MIN(timeout, select_timeout);
+  }
+  /* Round up, so as not to wake up just before the timer expires */
+  return (timeout * 1000 + CLOCK_SECOND - 1) / CLOCK_SECOND;
+}
+/*---------------------------------------------------------------------------*/
+static void
+epoll_main_loop(void)
+{
+  struct epoll_event events[SELECT_MAX];
+
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if(epoll_fd < 0) {
+    perror("epoll_create1");
+    exit(1);
+  }
+
+  while(1) {
+    fd_set fdr;
+    fd_set fdw;
+    int maxfd;
+    int always_ready;
+    int i;
+    int retval;
+
+    retval = process_run();
+
+    /* Collect the events each descriptor is interested in */
+    select_timeout_set = 0;
+    FD_ZERO(&fdr);
+    FD_ZERO(&fdw);
+    maxfd = -1;
+    for(i = 0; i <= select_max; i++) {
+      if(select_callback[i] != NULL && select_callback[i]->set_fd(&fdr, &fdw)) {
+        maxfd = i;
+      }
+    }
+    always_ready = 0;
+    for(i = 0; i <= select_max; i++) {
+      uint32_t ev = 0;
+      if(select_callback[i] != NULL && i <= maxfd) {
+        ev = (FD_ISSET(i, &fdr) ? EPOLLIN : 0) | (FD_ISSET(i, &fdw) ? EPOLLOUT : 0);
+      }
+      always_ready |= epoll_update(i, ev);
+    }
+
+    retval = epoll_wait(epoll_fd, events, SELECT_MAX,
+                        (retval || always_ready) ? 0 : epoll_timeout());
+    if(retval < 0) {
+      if(errno != EINTR) {
+        perror("epoll_wait");
+      }
+      retval = 0;
+    }
+
+    /* Report the ready descriptors to their callback in fd_sets, as
+     * select would */
+    if(retval > 0 || always_ready) {
+      fd_set readyr;
+      fd_set readyw;
+      FD_ZERO(&readyr);
+      FD_ZERO(&readyw);
+      for(i = 0; i < retval; i++) {
+        int fd = events[i].data.fd;
+        uint32_t ev = events[i].events;
+        if(ev & (EPOLLERR | EPOLLHUP)) {
+          ev |= epoll_state[fd] & (EPOLLIN | EPOLLOUT);
+        }
+        if((ev & EPOLLIN) && FD_ISSET(fd, &fdr)) {
+          FD_SET(fd, &readyr);
+        }
+        if((ev & EPOLLOUT) && FD_ISSET(fd, &fdw)) {
+          FD_SET(fd, &readyw);
+        }
+      }
+      for(i = 0; i <= maxfd; i++) {
+        if(epoll_state[i] & EPOLL_STATE_NO_EPOLL) {
+          if(FD_ISSET(i, &fdr)) {
+            FD_SET(i, &readyr);
+          }
+          if(FD_ISSET(i, &fdw)) {
+            FD_SET(i, &readyw);
+          }
+        }
+      }
+      for(i = 0; i <= maxfd; i++) {
+        if(select_callback[i] != NULL &&
+           (FD_ISSET(i, &readyr) || FD_ISSET(i, &readyw))) {
+          select_callback[i]->handle_fd(&readyr, &readyw);
+        }
+      }
+    }
+
+    etimer_request_poll();
+  }
+}
+#endif /* SELECT_EPOLL */
+/*---------------------------------------------------------------------------*/
 void
 platform_main_loop()
 {
 #if SELECT_STDIN
   select_set_callback(STDIN_FILENO, &stdin_fd);
 #endif /* SELECT_STDIN */
+#if SELECT_EPOLL
+  epoll_main_loop();
+#endif /* SELECT_EPOLL */
   while(1) {
     fd_set fdr;
     fd_set fdw;
@@ -302,9 +524,7 @@ platform_main_loop()
 
     retval = process_run();
 
-    tv.tv_sec = 0;
-    tv.tv_usec = retval ? 1 : SELECT_TIMEOUT;
-
+    select_timeout_set = 0;
     FD_ZERO(&fdr);
     FD_ZERO(&fdw);
     maxfd = 0;
@@ -314,6 +534,13 @@ platform_main_loop()
       }
     }
 
+    tv.tv_sec = 0;
+    tv.tv_usec = retval ? 1 : SELECT_TIMEOUT;
+    if(select_timeout_set &&
+       select_timeout * (1000000 / CLOCK_SECOND) < tv.tv_usec) {
+      tv.tv_usec = select_timeout * (1000000 / CLOCK_SECOND);
+    }
+
     retval = select(maxfd + 1, &fdr, &fdw, NULL, &tv);
     if(retval < 0) {
       if(errno != EINTR) {
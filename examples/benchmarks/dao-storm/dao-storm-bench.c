@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark of the source routing node table of a non-storing
+ *         root. Feeds uip_sr_update_node() with the DAOs of a large
+ *         DODAG, as after a global repair, times them and the expiry of
+ *         all links with uip_sr_periodic(), and checks the resulting
+ *         graph. Build with HASH=0 and HASH=1 to compare the node list
+ *         with the hash index.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/routing/routing.h"
+#include "net/ipv6/uip-sr.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define NUM_NODES    (UIP_SR_LINK_NUM - 1)
+#define FANOUT       4
+#define ROUNDS       20
+#define LIFETIME     1800
+/*---------------------------------------------------------------------------*/
+/* Node 0 is the root */
+static uip_ipaddr_t addrs[NUM_NODES + 1];
+static uint16_t parents[NUM_NODES + 1];
+static int errors;
+/*---------------------------------------------------------------------------*/
+PROCESS(dao_storm_bench_process, "DAO storm benchmark");
+AUTOSTART_PROCESSES(&dao_storm_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+send_dao(int i, uint32_t lifetime)
+{
+  if(uip_sr_update_node(NULL, &addrs[i], &addrs[parents[i]], lifetime) == NULL) {
+    errors++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_result(const char *name, unsigned long ops, clock_time_t elapsed)
+{
+  printf("%-8s %lu ops in %lu ms: %lu ns/op\n", name, ops,
+         (unsigned long)elapsed,
+         (unsigned long)((elapsed * 1000000UL) / (ops ? ops : 1)));
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_graph(void)
+{
+  uip_sr_node_t *node;
+  int i;
+
+  if(uip_sr_num_nodes() != NUM_NODES + 1) {
+    printf("Wrong number of nodes: %d\n", uip_sr_num_nodes());
+    errors++;
+  }
+  for(i = 1; i <= NUM_NODES; i++) {
+    node = uip_sr_get_node(NULL, &addrs[i]);
+    if(node == NULL ||
+       node->parent != uip_sr_get_node(NULL, &addrs[parents[i]]) ||
+       !uip_sr_is_addr_reachable(NULL, &addrs[i])) {
+      errors++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(dao_storm_bench_process, ev, data)
+{
+  clock_time_t start;
+  unsigned long ops;
+  int i, j;
+
+  PROCESS_BEGIN();
+
+  printf("DAO storm benchmark: %u nodes, hash %s\n",
+         NUM_NODES, UIP_SR_WITH_HASH ? "on" : "off");
+
+  NETSTACK_ROUTING.root_set_prefix(NULL, NULL);
+  NETSTACK_ROUTING.root_start();
+  if(!NETSTACK_ROUTING.get_root_ipaddr(&addrs[0])) {
+    printf("Failed to start the root\n");
+    exit(1);
+  }
+
+  /* A tree of the given fanout. Every parent has a lower index than its
+     children, so that reparenting to a lower index never makes a loop. */
+  for(i = 1; i <= NUM_NODES; i++) {
+    memcpy(&addrs[i], &addrs[0], 8);
+    addrs[i].u8[8] = 0x02;
+    addrs[i].u8[11] = 0xff;
+    addrs[i].u8[12] = 0xfe;
+    addrs[i].u8[14] = i >> 8;
+    addrs[i].u8[15] = i;
+    parents[i] = (i - 1) / FANOUT;
+  }
+
+  /* The network joins, parents first */
+  start = clock_time();
+  for(i = 1; i <= NUM_NODES; i++) {
+    send_dao(i, LIFETIME);
+  }
+  print_result("join", NUM_NODES, clock_time() - start);
+  check_graph();
+
+  /* DAO refreshes in random order, one in eight with a new parent */
+  ops = 0;
+  start = clock_time();
+  for(j = 0; j < ROUNDS * NUM_NODES; j++) {
+    i = 1 + random_rand() % NUM_NODES;
+    if(random_rand() % 8 == 0) {
+      parents[i] = random_rand() % i;
+    }
+    send_dao(i, LIFETIME);
+    ops++;
+  }
+  print_result("storm", ops, clock_time() - start);
+  check_graph();
+
+  /* All links expire: the nodes leave, leaves first */
+  for(i = 1; i <= NUM_NODES; i++) {
+    send_dao(i, 1);
+  }
+  ops = 0;
+  start = clock_time();
+  while(uip_sr_num_nodes() > 1 && ops <= NUM_NODES + 1) {
+    uip_sr_periodic(1);
+    ops++;
+  }
+  print_result("expiry", ops, clock_time() - start);
+  if(uip_sr_num_nodes() != 1 || uip_sr_get_node(NULL, &addrs[0]) == NULL) {
+    printf("Wrong number of nodes after expiry: %d\n", uip_sr_num_nodes());
+    errors++;
+  }
+
+  printf("Errors: %d\n", errors);
+  exit(errors != 0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
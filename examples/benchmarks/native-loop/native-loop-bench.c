@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark of the native platform main loop. Measures the CPU
+ *         time used and the lateness of a periodic etimer while idle,
+ *         then the latency with which data written to a monitored file
+ *         descriptor reaches its select callback, under a steady stream
+ *         of writes from a child process. Build with EPOLL=0 and EPOLL=1
+ *         to compare the select and epoll main loops.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+/*---------------------------------------------------------------------------*/
+#define IDLE_SECONDS    3
+#define TIMER_PERIOD    (CLOCK_SECOND / 10)
+#define TRAFFIC_SECONDS 3
+#define TRAFFIC_PERIOD  1000 /* usec between writes */
+/*---------------------------------------------------------------------------*/
+struct latency {
+  unsigned long count;
+  uint64_t sum;
+  uint64_t max;
+};
+static struct latency traffic_latency;
+static int pipefd[2] = { -1, -1 };
+static int traffic_done;
+/*---------------------------------------------------------------------------*/
+PROCESS(native_loop_bench_process, "Native main loop benchmark");
+AUTOSTART_PROCESSES(&native_loop_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_us(void)
+{
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return (uint64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 +
+    ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+latency_add(struct latency *l, uint64_t value)
+{
+  l->count++;
+  l->sum += value;
+  if(value > l->max) {
+    l->max = value;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_result(const char *name, uint64_t cpu, uint64_t wall,
+             const struct latency *l)
+{
+  printf("%-8s cpu %lu us in %lu ms (%lu.%02lu%%), "
+         "latency mean %lu us max %lu us over %lu samples\n",
+         name, (unsigned long)cpu, (unsigned long)(wall / 1000),
+         (unsigned long)(cpu * 100 / wall),
+         (unsigned long)(cpu * 10000 / wall % 100),
+         (unsigned long)(l->count ? l->sum / l->count : 0),
+         (unsigned long)l->max, l->count);
+}
+/*---------------------------------------------------------------------------*/
+static int
+set_fd(fd_set *rset, fd_set *wset)
+{
+  FD_SET(pipefd[0], rset);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_fd(fd_set *rset, fd_set *wset)
+{
+  uint64_t stamps[64];
+  ssize_t len;
+  uint64_t now;
+  int i;
+
+  if(!FD_ISSET(pipefd[0], rset)) {
+    return;
+  }
+
+  /* Read one batch, as a network driver reads one packet */
+  len = read(pipefd[0], stamps, sizeof(stamps));
+  now = now_us();
+  if(len > 0) {
+    for(i = 0; i < len / sizeof(stamps[0]); i++) {
+      latency_add(&traffic_latency, now - stamps[i]);
+    }
+  } else if(len == 0) {
+    /* The writer is done */
+    select_set_callback(pipefd[0], NULL);
+    close(pipefd[0]);
+    traffic_done = 1;
+    process_poll(&native_loop_bench_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static const struct select_callback pipe_callback = { set_fd, handle_fd };
+/*---------------------------------------------------------------------------*/
+static void
+write_traffic(int fd)
+{
+  uint64_t stamp;
+  uint64_t end = now_us() + TRAFFIC_SECONDS * 1000000;
+  struct timespec period = { 0, TRAFFIC_PERIOD * 1000 };
+
+  while(now_us() < end) {
+    stamp = now_us();
+    if(write(fd, &stamp, sizeof(stamp)) != sizeof(stamp)) {
+      break;
+    }
+    nanosleep(&period, NULL);
+  }
+  close(fd);
+  _exit(0);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(native_loop_bench_process, ev, data)
+{
+  static struct etimer et;
+  static struct latency timer_latency;
+  static uint64_t start_cpu, start_wall, expected;
+  static int i;
+  pid_t pid;
+
+  PROCESS_BEGIN();
+
+  printf("Native main loop benchmark: %s\n",
+         SELECT_CONF_EPOLL ? "epoll" : "select");
+
+  /* Idle: a periodic etimer, nothing else to do */
+  start_cpu = cpu_us();
+  start_wall = now_us();
+  expected = start_wall;
+  etimer_set(&et, TIMER_PERIOD);
+  for(i = 0; i < IDLE_SECONDS * CLOCK_SECOND / TIMER_PERIOD; i++) {
+    expected += TIMER_PERIOD * 1000000 / CLOCK_SECOND;
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+    /* The clock has millisecond resolution: count early as on time */
+    latency_add(&timer_latency,
+                now_us() > expected ? now_us() - expected : 0);
+    etimer_reset(&et);
+  }
+  print_result("idle", cpu_us() - start_cpu, now_us() - start_wall,
+               &timer_latency);
+
+  /* Traffic: a child process writes a time stamp every TRAFFIC_PERIOD */
+  if(pipe(pipefd) < 0) {
+    perror("pipe");
+    exit(1);
+  }
+  fcntl(pipefd[0], F_SETFL, O_NONBLOCK);
+  pid = fork();
+  if(pid == 0) {
+    close(pipefd[0]);
+    write_traffic(pipefd[1]);
+  }
+  close(pipefd[1]);
+  select_set_callback(pipefd[0], &pipe_callback);
+
+  start_cpu = cpu_us();
+  start_wall = now_us();
+  PROCESS_WAIT_UNTIL(traffic_done);
+  print_result("traffic", cpu_us() - start_cpu, now_us() - start_wall,
+               &traffic_latency);
+  waitpid(pid, NULL, 0);
+
+  exit(traffic_latency.count == 0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
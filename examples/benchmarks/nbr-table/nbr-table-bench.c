@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark of neighbor table lookups. Fills the neighbor table,
+ *         then times lookups of present and absent link-layer addresses,
+ *         and checks the lookups against a walk over the table while
+ *         neighbors are being evicted. Build with HASH=0 and HASH=1 to
+ *         compare the linear key list with the hash index.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define ROUNDS 20000
+/*---------------------------------------------------------------------------*/
+typedef struct {
+  uint32_t id;
+} bench_nbr_t;
+
+NBR_TABLE(bench_nbr_t, bench_nbrs);
+
+static linkaddr_t addrs[NBR_TABLE_MAX_NEIGHBORS];
+static int errors;
+/*---------------------------------------------------------------------------*/
+PROCESS(nbr_table_bench_process, "Neighbor table benchmark");
+AUTOSTART_PROCESSES(&nbr_table_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+random_lladdr(linkaddr_t *addr)
+{
+  int i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    addr->u8[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static bench_nbr_t *
+find_by_walk(const linkaddr_t *addr)
+{
+  bench_nbr_t *n;
+
+  for(n = nbr_table_head(bench_nbrs); n != NULL;
+      n = nbr_table_next(bench_nbrs, n)) {
+    if(linkaddr_cmp(nbr_table_get_lladdr(bench_nbrs, n), addr)) {
+      return n;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_lookups(const char *name, int present)
+{
+  clock_time_t start, elapsed;
+  linkaddr_t absent;
+  unsigned long ops = 0;
+  int i, j;
+
+  random_lladdr(&absent);
+  start = clock_time();
+  for(i = 0; i < ROUNDS; i++) {
+    for(j = 0; j < NBR_TABLE_MAX_NEIGHBORS; j++) {
+      if(present) {
+        if(nbr_table_get_from_lladdr(bench_nbrs, &addrs[j]) == NULL) {
+          errors++;
+        }
+      } else {
+        absent.u8[0] = j;
+        if(nbr_table_get_from_lladdr(bench_nbrs, &absent) != NULL) {
+          errors++;
+        }
+      }
+      ops++;
+    }
+  }
+  elapsed = clock_time() - start;
+
+  printf("%-8s %lu lookups in %lu ms: %lu ns/lookup\n", name, ops,
+         (unsigned long)elapsed,
+         (unsigned long)((elapsed * 1000000UL) / (ops ? ops : 1)));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(nbr_table_bench_process, ev, data)
+{
+  bench_nbr_t *n;
+  linkaddr_t addr;
+  int i;
+
+  PROCESS_BEGIN();
+
+  nbr_table_register(bench_nbrs, NULL);
+
+  printf("Neighbor table benchmark: %u neighbors, hash index %s\n",
+         NBR_TABLE_MAX_NEIGHBORS, NBR_TABLE_WITH_HASH ? "on" : "off");
+
+  /* Fill the table */
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    random_lladdr(&addrs[i]);
+    n = nbr_table_add_lladdr(bench_nbrs, &addrs[i],
+                             NBR_TABLE_REASON_UNDEFINED, NULL);
+    if(n == NULL) {
+      errors++;
+    } else {
+      n->id = i;
+    }
+  }
+
+  bench_lookups("present", 1);
+  bench_lookups("absent", 0);
+
+  /* Keep adding new neighbors, which evicts the oldest ones, and check
+     that the lookups agree with a walk over the table */
+  for(i = 0; i < 4 * NBR_TABLE_MAX_NEIGHBORS; i++) {
+    random_lladdr(&addr);
+    if(nbr_table_add_lladdr(bench_nbrs, &addr,
+                            NBR_TABLE_REASON_UNDEFINED, NULL) == NULL) {
+      errors++;
+    }
+    if(nbr_table_get_from_lladdr(bench_nbrs, &addr) != find_by_walk(&addr)) {
+      errors++;
+    }
+    addr = addrs[i % NBR_TABLE_MAX_NEIGHBORS];
+    if(nbr_table_get_from_lladdr(bench_nbrs, &addr) != find_by_walk(&addr)) {
+      errors++;
+    }
+  }
+
+  printf("Errors: %d\n", errors);
+  exit(errors != 0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
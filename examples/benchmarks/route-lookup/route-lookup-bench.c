@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark of routing table lookups. Fills the routing table
+ *         with host routes and prefixes, times uip_ds6_route_lookup(),
+ *         and checks every lookup against a linear longest-prefix match
+ *         while routes are removed and added. Build with TRIE=0 and
+ *         TRIE=1 to compare the route list with the prefix trie.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define NUM_NEXTHOPS 8
+#define NUM_PREFIXES 16
+#define NUM_HOSTS    (UIP_DS6_ROUTE_NB - NUM_PREFIXES)
+#define ROUNDS       200
+/*---------------------------------------------------------------------------*/
+static uip_ipaddr_t nexthops[NUM_NEXTHOPS];
+static uip_ipaddr_t hosts[NUM_HOSTS];
+static int errors;
+/*---------------------------------------------------------------------------*/
+PROCESS(route_lookup_bench_process, "Route lookup benchmark");
+AUTOSTART_PROCESSES(&route_lookup_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+random_addr(uip_ipaddr_t *addr, uint16_t net)
+{
+  int i;
+
+  uip_ip6addr(addr, net, 0, 0, random_rand() % 8, 0, 0, 0, 0);
+  for(i = 8; i < 16; i++) {
+    addr->u8[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The longest-prefix match, computed with a walk over all routes */
+static uip_ds6_route_t *
+lookup_by_walk(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r, *found = NULL;
+
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    if((found == NULL || r->length > found->length) &&
+       uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
+      found = r;
+    }
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_lookup(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r = uip_ds6_route_lookup(addr);
+  uip_ds6_route_t *expected = lookup_by_walk(addr);
+
+  /* Routes of equal length may match equally well */
+  if(r != expected &&
+     (r == NULL || expected == NULL || r->length != expected->length)) {
+    errors++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_route(const uip_ipaddr_t *addr, uint8_t length)
+{
+  if(uip_ds6_route_add(addr, length,
+                       &nexthops[random_rand() % NUM_NEXTHOPS]) == NULL) {
+    errors++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_lookups(const char *name, int hit)
+{
+  clock_time_t start, elapsed;
+  uip_ipaddr_t addr;
+  unsigned long ops = 0;
+  int i, j;
+
+  start = clock_time();
+  for(i = 0; i < ROUNDS; i++) {
+    for(j = 0; j < NUM_HOSTS; j++) {
+      if(hit) {
+        uip_ipaddr_copy(&addr, &hosts[j]);
+      } else {
+        uip_ip6addr(&addr, 0x2001, 0xdb8, 0, 0, 0, 0, 0, j);
+      }
+      if((uip_ds6_route_lookup(&addr) != NULL) != hit) {
+        errors++;
+      }
+      ops++;
+    }
+  }
+  elapsed = clock_time() - start;
+
+  printf("%-8s %lu lookups in %lu ms: %lu ns/lookup\n", name, ops,
+         (unsigned long)elapsed,
+         (unsigned long)((elapsed * 1000000UL) / (ops ? ops : 1)));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(route_lookup_bench_process, ev, data)
+{
+  static const uint8_t prefix_lengths[] = { 16, 32, 48, 56, 64, 64, 70, 96 };
+  uip_lladdr_t lladdr;
+  uip_ipaddr_t addr;
+  uip_ds6_route_t *r;
+  int i, n;
+
+  PROCESS_BEGIN();
+
+  printf("Route lookup benchmark: %u routes, trie %s\n",
+         UIP_DS6_ROUTE_NB, UIP_DS6_ROUTE_WITH_TRIE ? "on" : "off");
+
+  for(i = 0; i < NUM_NEXTHOPS; i++) {
+    memset(&lladdr, 0, sizeof(lladdr));
+    lladdr.addr[0] = 0x02;
+    lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+    uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0, i + 1);
+    uip_ds6_nbr_add(&nexthops[i], &lladdr, 1, NBR_REACHABLE,
+                    NBR_TABLE_REASON_UNDEFINED, NULL);
+  }
+
+  /* Prefixes of various lengths, then host routes. The two are kept
+     apart: adding a host route below a prefix with another next hop
+     replaces the prefix. */
+  for(i = 0; i < NUM_PREFIXES; i++) {
+    random_addr(&addr, 0xfd01);
+    add_route(&addr, prefix_lengths[i % sizeof(prefix_lengths)]);
+  }
+  for(i = 0; i < NUM_HOSTS; i++) {
+    random_addr(&hosts[i], 0xfd00);
+    add_route(&hosts[i], 128);
+  }
+  printf("Routes: %d\n", uip_ds6_route_num_routes());
+
+  bench_lookups("hit", 1);
+  bench_lookups("miss", 0);
+
+  /* Remove and add routes, including prefixes that collide on the
+     bytes they compare, and check every lookup */
+  for(i = 0; i < 4 * UIP_DS6_ROUTE_NB; i++) {
+    n = random_rand() % uip_ds6_route_num_routes();
+    for(r = uip_ds6_route_head(); n > 0; r = uip_ds6_route_next(r), n--);
+    uip_ds6_route_rm(r);
+
+    random_addr(&addr, 0xfd00 + (random_rand() & 1));
+    add_route(&addr, (random_rand() & 1) ? 128 :
+              prefix_lengths[random_rand() % sizeof(prefix_lengths)]);
+
+    check_lookup(&addr);
+    check_lookup(&hosts[i % NUM_HOSTS]);
+    random_addr(&addr, 0xfd00 + (random_rand() & 1));
+    check_lookup(&addr);
+  }
+
+  printf("Errors: %d\n", errors);
+  exit(errors != 0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
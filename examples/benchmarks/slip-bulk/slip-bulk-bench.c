@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark of the SLIP framing of the native border router.
+ *         Measures encoding into an output buffer, then decoding of a
+ *         stream of frames that a child process writes into a pty, as a
+ *         SLIP radio would write into a USB serial port. Build with
+ *         BULK=0 and BULK=1 to compare byte at a time framing with the
+ *         chunked framing.
+ */
+/*---------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include "contiki.h"
+#include "slip-codec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+/*---------------------------------------------------------------------------*/
+#define FRAME_LEN     127
+#define FRAMES        20000
+#define ENCODE_ROUNDS 20
+#define TIMEOUT       (20 * CLOCK_SECOND)
+/*---------------------------------------------------------------------------*/
+static uint8_t stream[FRAMES * (2 * FRAME_LEN + 1)];
+static int stream_len;
+static uint8_t frame_buf[2048];
+static struct slip_decoder decoder;
+static int slave = -1;
+#if !SLIP_BENCH_BULK
+static FILE *slave_file;
+#endif /* !SLIP_BENCH_BULK */
+static unsigned long frames, errors, bytes;
+/*---------------------------------------------------------------------------*/
+PROCESS(slip_bulk_bench_process, "SLIP framing benchmark");
+AUTOSTART_PROCESSES(&slip_bulk_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cpu_us(void)
+{
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return (uint64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 +
+    ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+/*---------------------------------------------------------------------------*/
+/* Frame contents, with a SLIP_END or SLIP_ESC every hundred bytes or so */
+static void
+make_frame(uint8_t *frame, unsigned long n)
+{
+  int i;
+
+  for(i = 0; i < FRAME_LEN; i++) {
+    frame[i] = (uint8_t)(n * 7 + i * 13);
+  }
+}
+/*---------------------------------------------------------------------------*/
+#if !SLIP_BENCH_BULK
+/* Escape one byte at a time, as the border router used to */
+static int
+encode_bytewise(uint8_t *dst, const uint8_t *data, int len)
+{
+  int i, n = 0;
+
+  for(i = 0; i < len; i++) {
+    switch(data[i]) {
+    case SLIP_END:
+      dst[n++] = SLIP_ESC;
+      dst[n++] = SLIP_ESC_END;
+      break;
+    case SLIP_ESC:
+      dst[n++] = SLIP_ESC;
+      dst[n++] = SLIP_ESC_ESC;
+      break;
+    default:
+      dst[n++] = data[i];
+      break;
+    }
+  }
+  dst[n++] = SLIP_END;
+  return n;
+}
+#endif /* !SLIP_BENCH_BULK */
+/*---------------------------------------------------------------------------*/
+static void
+encode_stream(void)
+{
+  uint8_t frame[FRAME_LEN];
+  unsigned long n;
+
+  stream_len = 0;
+  for(n = 0; n < FRAMES; n++) {
+    make_frame(frame, n);
+#if SLIP_BENCH_BULK
+    stream_len += slip_encode(stream + stream_len, sizeof(stream) - stream_len,
+                              frame, FRAME_LEN);
+#else /* SLIP_BENCH_BULK */
+    stream_len += encode_bytewise(stream + stream_len, frame, FRAME_LEN);
+#endif /* SLIP_BENCH_BULK */
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+frame_input(const uint8_t *data, int len)
+{
+  uint8_t frame[FRAME_LEN];
+
+  make_frame(frame, frames);
+  if(len != FRAME_LEN || memcmp(data, frame, FRAME_LEN) != 0) {
+    errors++;
+  }
+  frames++;
+  if(frames == FRAMES) {
+    process_poll(&slip_bulk_bench_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+set_fd(fd_set *rset, fd_set *wset)
+{
+  FD_SET(slave, rset);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_fd(fd_set *rset, fd_set *wset)
+{
+#if SLIP_BENCH_BULK
+  static uint8_t rxbuf[2048];
+  int len;
+#else /* SLIP_BENCH_BULK */
+  uint8_t c;
+#endif /* SLIP_BENCH_BULK */
+
+  if(!FD_ISSET(slave, rset)) {
+    return;
+  }
+
+#if SLIP_BENCH_BULK
+  /* Read in chunks until the pty is drained */
+  while((len = read(slave, rxbuf, sizeof(rxbuf))) > 0) {
+    bytes += len;
+    slip_decode(&decoder, rxbuf, len, frame_input);
+  }
+#else /* SLIP_BENCH_BULK */
+  /* One byte at a time through stdio */
+  while(fread(&c, 1, 1, slave_file) == 1) {
+    bytes++;
+    slip_decode(&decoder, &c, 1, frame_input);
+  }
+  clearerr(slave_file);
+#endif /* SLIP_BENCH_BULK */
+}
+/*---------------------------------------------------------------------------*/
+static const struct select_callback pty_callback = { set_fd, handle_fd };
+/*---------------------------------------------------------------------------*/
+static void
+write_stream(int fd)
+{
+  int off, n;
+
+  for(off = 0; off < stream_len; off += n) {
+    n = write(fd, stream + off, stream_len - off);
+    if(n < 0) {
+      break;
+    }
+  }
+  /* Keep the pty open until the reader is done */
+  pause();
+  _exit(0);
+}
+/*---------------------------------------------------------------------------*/
+static int
+open_pty(void)
+{
+  struct termios tty;
+  int master;
+
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if(master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) {
+    perror("posix_openpt");
+    exit(1);
+  }
+  slave = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if(slave < 0) {
+    perror("open pty");
+    exit(1);
+  }
+  /* Raw, as the border router sets up its serial port */
+  tcgetattr(slave, &tty);
+  cfmakeraw(&tty);
+  tty.c_cc[VTIME] = 0;
+  tty.c_cc[VMIN] = 0;
+  tcsetattr(slave, TCSANOW, &tty);
+  return master;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(slip_bulk_bench_process, ev, data)
+{
+  static struct etimer timeout;
+  static uint64_t start_cpu, start_wall;
+  static int master;
+  static pid_t pid;
+  uint64_t cpu, wall;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("SLIP framing benchmark: %s, %d frames of %d bytes\n",
+         SLIP_BENCH_BULK ? "bulk" : "byte at a time", FRAMES, FRAME_LEN);
+
+  /* Encoding into memory */
+  start_cpu = cpu_us();
+  for(i = 0; i < ENCODE_ROUNDS; i++) {
+    encode_stream();
+  }
+  cpu = cpu_us() - start_cpu;
+  printf("encode   %lu bytes in %lu us cpu, %lu MB/s\n",
+         (unsigned long)stream_len * ENCODE_ROUNDS, (unsigned long)cpu,
+         (unsigned long)(cpu ? (uint64_t)stream_len * ENCODE_ROUNDS / cpu : 0));
+
+  /* Decoding from a pty, written by a child process */
+  master = open_pty();
+  slip_decoder_init(&decoder, frame_buf, sizeof(frame_buf));
+#if !SLIP_BENCH_BULK
+  slave_file = fdopen(slave, "r");
+#endif /* !SLIP_BENCH_BULK */
+  pid = fork();
+  if(pid == 0) {
+    close(slave);
+    write_stream(master);
+  }
+  select_set_callback(slave, &pty_callback);
+
+  start_cpu = cpu_us();
+  start_wall = now_us();
+  etimer_set(&timeout, TIMEOUT);
+  PROCESS_WAIT_UNTIL(frames == FRAMES || etimer_expired(&timeout));
+  cpu = cpu_us() - start_cpu;
+  wall = now_us() - start_wall;
+  select_set_callback(slave, NULL);
+  kill(pid, SIGTERM);
+  waitpid(pid, NULL, 0);
+
+  printf("decode   %lu bytes, %lu frames, %lu errors in %lu ms, "
+         "%lu us cpu, %lu KB/s\n",
+         bytes, frames, errors, (unsigned long)(wall / 1000),
+         (unsigned long)cpu,
+         (unsigned long)(wall ? (uint64_t)bytes * 1000 / wall : 0));
+
+  exit(frames != FRAMES || errors != 0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -80,6 +80,9 @@ main(void)
   rtimer_init();
   process_init();
   process_start(&etimer_process, NULL);
+#if LOG_BINARY
+  log_binary_init();
+#endif /* LOG_BINARY */
   ctimer_init();
   watchdog_init();
 
@@ -72,10 +72,10 @@
 /* HEAPMEM_CONF_ARENA_SIZE */
 
 /*
- * The HEAPMEM_CONF_SEARCH_MAX parameter limits the time spent on
- * chunk allocation and defragmentation. The lower this number is, the
- * faster the operations become. The cost of this speedup, however, is
- * that the space overhead might increase.
+ * The HEAPMEM_CONF_SEARCH_MAX parameter limits the number of chunks
+ * examined on the free list of a single size class. The lower this
+ * number is, the faster the allocations become. The cost of this
+ * speedup, however, is that the space overhead might increase.
  */
 #ifdef HEAPMEM_CONF_SEARCH_MAX
 #define CHUNK_SEARCH_MAX HEAPMEM_CONF_SEARCH_MAX
@@ -83,6 +83,30 @@
 #define CHUNK_SEARCH_MAX 16
 #endif /* HEAPMEM_CONF_SEARCH_MAX */
 
+/*
+ * The HEAPMEM_CONF_SMALL_CLASSES parameter sets the number of free
+ * lists that hold chunks of one exact size each: HEAPMEM_ALIGNMENT
+ * bytes, twice that, and so on. Allocations and deallocations of
+ * these sizes take constant time.
+ */
+#ifdef HEAPMEM_CONF_SMALL_CLASSES
+#define SMALL_CLASSES HEAPMEM_CONF_SMALL_CLASSES
+#else
+#define SMALL_CLASSES 8
+#endif /* HEAPMEM_CONF_SMALL_CLASSES */
+
+/*
+ * The HEAPMEM_CONF_LARGE_CLASSES parameter sets the number of free
+ * lists for larger chunks. Each of them covers twice the range of
+ * sizes of the previous one, and the last one holds all chunks that
+ * are larger than that.
+ */
+#ifdef HEAPMEM_CONF_LARGE_CLASSES
+#define LARGE_CLASSES HEAPMEM_CONF_LARGE_CLASSES
+#else
+#define LARGE_CLASSES 6
+#endif /* HEAPMEM_CONF_LARGE_CLASSES */
+
 /*
  * The HEAPMEM_CONF_REALLOC parameter determines whether heapmem_realloc() is
  * enabled (non-zero value) or not (zero value).
@@ -106,11 +130,16 @@
 #define ALIGN(size)						\
   (((size) + (HEAPMEM_ALIGNMENT - 1)) & ~(HEAPMEM_ALIGNMENT - 1))
 
+#define FREE_LISTS      (SMALL_CLASSES + LARGE_CLASSES)
+#define SMALL_SIZE_MAX  (SMALL_CLASSES * HEAPMEM_ALIGNMENT)
+
 /* Macros for chunk iteration. */
 #define NEXT_CHUNK(chunk)						\
   ((chunk_t *)((char *)(chunk) + sizeof(chunk_t) + (chunk)->size))
-#define IS_LAST_CHUNK(chunk)			\
-  ((char *)NEXT_CHUNK(chunk) == &heap_base[heap_usage])
+#define PREV_CHUNK(chunk)						\
+  ((chunk_t *)((char *)(chunk) - sizeof(chunk_t) - (chunk)->prev_size))
+#define IS_FIRST_CHUNK(chunk)			\
+  ((chunk) == first_chunk)
 
 /* Macros for retrieving the data pointer from a chunk,
    and the other way around. */
@@ -128,14 +157,17 @@
   (~(chunk)->flags & CHUNK_FLAG_ALLOCATED)
 
 /*
- * We use a double-linked list of chunks, with a slight space overhead compared
- * to a single-linked list, but with the advantage of having much faster
- * list removals.
+ * Free chunks are kept in double-linked lists, with a slight space
+ * overhead compared to single-linked lists, but with the advantage of
+ * having much faster list removals. Each chunk also records the size
+ * of the chunk that precedes it in memory, so that a chunk being freed
+ * can be merged with both of its neighbors without any search.
  */
 typedef struct chunk {
   struct chunk *prev;
   struct chunk *next;
   size_t size;
+  size_t prev_size;
   uint8_t flags;
 #if HEAPMEM_DEBUG
   const char *file;
@@ -149,7 +181,33 @@ static char heap_base[HEAPMEM_ARENA_SIZE] CC_ALIGN(HEAPMEM_ALIGNMENT);
 static size_t heap_usage;
 
 static chunk_t *first_chunk = (chunk_t *)heap_base;
-static chunk_t *free_list;
+static chunk_t *last_chunk;
+static chunk_t *free_lists[FREE_LISTS];
+
+static size_t max_search;
+static size_t failures;
+
+/* size_class: Map a chunk size to the free list that holds chunks of
+   that size. Every chunk in a higher class is larger than any size
+   that maps to a lower class. */
+static unsigned
+size_class(size_t size)
+{
+  unsigned class;
+  size_t limit;
+
+  if(size <= SMALL_SIZE_MAX) {
+    return (size - 1) / HEAPMEM_ALIGNMENT;
+  }
+
+  class = SMALL_CLASSES;
+  for(limit = SMALL_SIZE_MAX * 2;
+      size > limit && class < FREE_LISTS - 1;
+      limit *= 2) {
+    class++;
+  }
+  return class;
+}
 
 /* extend_space: Increases the current footprint used in the heap, and
    returns a pointer to the old end. */
@@ -168,38 +226,39 @@ extend_space(size_t size)
   return old_usage;
 }
 
-/* free_chunk: Mark a chunk as being free, and put it on the free list. */
+/* resize_chunk: Change the size of a chunk and let the chunk after it
+   know where it starts. */
 static void
-free_chunk(chunk_t * const chunk)
+resize_chunk(chunk_t * const chunk, size_t size)
 {
-  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
-
-  if(IS_LAST_CHUNK(chunk)) {
-    /* Release the chunk back into the wilderness. */
-    heap_usage -= sizeof(chunk_t) + chunk->size;
-  } else {
-    /* Put the chunk on the free list. */
-    chunk->prev = NULL;
-    chunk->next = free_list;
-    if(free_list != NULL) {
-      free_list->prev = chunk;
-    }
-    free_list = chunk;
+  chunk->size = size;
+  if(chunk == last_chunk) {
+    return;
   }
+  NEXT_CHUNK(chunk)->prev_size = size;
 }
 
-/* allocate_chunk: Mark a chunk as being allocated, and remove it
-   from the free list. */
+/* list_add: Put a free chunk on the list of its size class. */
 static void
-allocate_chunk(chunk_t * const chunk)
+list_add(chunk_t * const chunk)
 {
-  chunk->flags |= CHUNK_FLAG_ALLOCATED;
+  chunk_t **list;
 
-  if(chunk == free_list) {
-    free_list = chunk->next;
-    if(free_list != NULL) {
-      free_list->prev = NULL;
-    }
+  list = &free_lists[size_class(chunk->size)];
+  chunk->prev = NULL;
+  chunk->next = *list;
+  if(*list != NULL) {
+    (*list)->prev = chunk;
+  }
+  *list = chunk;
+}
+
+/* list_remove: Take a free chunk off the list of its size class. */
+static void
+list_remove(chunk_t * const chunk)
+{
+  if(chunk->prev == NULL) {
+    free_lists[size_class(chunk->size)] = chunk->next;
   } else {
     chunk->prev->next = chunk->next;
   }
@@ -207,82 +266,106 @@ allocate_chunk(chunk_t * const chunk)
   if(chunk->next != NULL) {
     chunk->next->prev = chunk->prev;
   }
+  chunk->next = chunk->prev = NULL;
 }
 
 /*
- * split_chunk: When allocating a chunk, we may have found one that is
- * larger than needed, so this function is called to keep the rest of
- * the original chunk free.
+ * free_chunk: Mark a chunk as being free, merge it with the free
+ * chunks next to it, and put the result on a free list. Since every
+ * chunk is merged when it is freed, no two free chunks are ever
+ * adjacent, and the last chunk in the heap is never free.
  */
 static void
-split_chunk(chunk_t * const chunk, size_t offset)
+free_chunk(chunk_t *chunk)
 {
-  chunk_t *new_chunk;
-
-  offset = ALIGN(offset);
+  chunk_t *next;
+  chunk_t *prev;
 
-  if(offset + sizeof(chunk_t) < chunk->size) {
-    new_chunk = (chunk_t *)(GET_PTR(chunk) + offset);
-    new_chunk->size = chunk->size - sizeof(chunk_t) - offset;
-    new_chunk->flags = 0;
-    free_chunk(new_chunk);
+  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
 
-    chunk->size = offset;
-    chunk->next = chunk->prev = NULL;
+  if(chunk != last_chunk) {
+    next = NEXT_CHUNK(chunk);
+    if(CHUNK_FREE(next)) {
+      list_remove(next);
+      if(next == last_chunk) {
+        last_chunk = chunk;
+      }
+      resize_chunk(chunk, chunk->size + sizeof(chunk_t) + next->size);
+    }
   }
-}
 
-/* coalesce_chunks: Coalesce a specific free chunk with as many adjacent
-   free chunks as possible. */
-static void
-coalesce_chunks(chunk_t *chunk)
-{
-  chunk_t *next;
+  if(!IS_FIRST_CHUNK(chunk)) {
+    prev = PREV_CHUNK(chunk);
+    if(CHUNK_FREE(prev)) {
+      list_remove(prev);
+      if(chunk == last_chunk) {
+        last_chunk = prev;
+      }
+      resize_chunk(prev, prev->size + sizeof(chunk_t) + chunk->size);
+      chunk = prev;
+    }
+  }
 
-  for(next = NEXT_CHUNK(chunk);
-      (char *)next < &heap_base[heap_usage] && CHUNK_FREE(next);
-      next = NEXT_CHUNK(next)) {
-    chunk->size += sizeof(chunk_t) + next->size;
-    allocate_chunk(next);
+  if(chunk == last_chunk) {
+    /* Release the chunk back into the wilderness. */
+    heap_usage -= sizeof(chunk_t) + chunk->size;
+    last_chunk = IS_FIRST_CHUNK(chunk) ? NULL : PREV_CHUNK(chunk);
+  } else {
+    list_add(chunk);
   }
 }
 
-/* defrag_chunks: Scan the free list for chunks that can be coalesced,
-   and stop within a bounded time. */
+/*
+ * split_chunk: When allocating a chunk, we may have found one that is
+ * larger than needed, so this function is called to keep the rest of
+ * the original chunk free.
+ */
 static void
-defrag_chunks(void)
+split_chunk(chunk_t * const chunk, size_t offset)
 {
-  int i;
-  chunk_t *chunk;
+  chunk_t *new_chunk;
 
-  /* Limit the time we spend on searching the free list. */
-  i = CHUNK_SEARCH_MAX;
-  for(chunk = free_list; chunk != NULL; chunk = chunk->next) {
-    if(i-- == 0) {
-      break;
+  offset = ALIGN(offset);
+
+  if(offset + sizeof(chunk_t) < chunk->size) {
+    new_chunk = (chunk_t *)(GET_PTR(chunk) + offset);
+    new_chunk->flags = 0;
+    new_chunk->prev_size = offset;
+    if(chunk == last_chunk) {
+      last_chunk = new_chunk;
     }
-    coalesce_chunks(chunk);
+    resize_chunk(new_chunk, chunk->size - sizeof(chunk_t) - offset);
+    chunk->size = offset;
+    free_chunk(new_chunk);
   }
 }
 
-/* get_free_chunk: Search the free list for the most suitable chunk, as
-   determined by its size, to satisfy an allocation request. */
+/*
+ * get_free_chunk: Find a free chunk that can hold an allocation
+ * request of the given size.
+ *
+ * The free list of the size class of the request is searched first,
+ * for the smallest chunk that is large enough. For the exact-size
+ * classes, the first chunk on the list is always a perfect fit. If the
+ * search fails, the first chunk of the next non-empty size class is
+ * taken, since every chunk in a larger class is large enough.
+ */
 static chunk_t *
 get_free_chunk(const size_t size)
 {
-  int i;
+  unsigned class;
+  size_t searched;
   chunk_t *chunk, *best;
 
-  /* Defragment chunks only right before they are needed for allocation. */
-  defrag_chunks();
-
+  class = size_class(size);
   best = NULL;
+  searched = 0;
+
   /* Limit the time we spend on searching the free list. */
-  i = CHUNK_SEARCH_MAX;
-  for(chunk = free_list; chunk != NULL; chunk = chunk->next) {
-    if(i-- == 0) {
-      break;
-    }
+  for(chunk = free_lists[class];
+      chunk != NULL && searched < CHUNK_SEARCH_MAX;
+      chunk = chunk->next) {
+    searched++;
 
     /*
      * To avoid fragmenting large chunks, we select the chunk with the
@@ -299,9 +382,19 @@ get_free_chunk(const size_t size)
     }
   }
 
+  while(best == NULL && ++class < FREE_LISTS) {
+    best = free_lists[class];
+    searched++;
+  }
+
+  if(searched > max_search) {
+    max_search = searched;
+  }
+
   if(best != NULL) {
     /* We found a chunk for the allocation. Split it if necessary. */
-    allocate_chunk(best);
+    list_remove(best);
+    best->flags = CHUNK_FLAG_ALLOCATED;
     split_chunk(best, size);
   }
 
@@ -313,11 +406,11 @@ get_free_chunk(const size_t size)
  * a pointer to it in case of success, and NULL in case of failure.
  *
  * When allocating memory, heapmem_alloc() will first try to find a
- * free chunk of the same size and the requested one. If none can be
- * find, we pick a larger chunk that is as close in size as possible,
- * and possibly split it so that the remaining part becomes a chunk
- * available for allocation.  At most CHUNK_SEARCH_MAX chunks on the
- * free list will be examined.
+ * free chunk in the size class of the request. If none can be found,
+ * we pick a chunk from the closest larger size class, and possibly
+ * split it so that the remaining part becomes a chunk available for
+ * allocation.  At most CHUNK_SEARCH_MAX chunks on one free list will
+ * be examined.
  *
  * As a last resort, heapmem_alloc() will try to extend the heap
  * space, and thereby create a new chunk available for use.
@@ -332,14 +425,21 @@ heapmem_alloc(size_t size)
   chunk_t *chunk;
 
   size = ALIGN(size);
+  if(size == 0) {
+    size = HEAPMEM_ALIGNMENT;
+  }
 
   chunk = get_free_chunk(size);
   if(chunk == NULL) {
     chunk = extend_space(sizeof(chunk_t) + size);
     if(chunk == NULL) {
+      failures++;
       return NULL;
     }
     chunk->size = size;
+    chunk->prev_size = last_chunk != NULL ? last_chunk->size : 0;
+    chunk->prev = chunk->next = NULL;
+    last_chunk = chunk;
   }
 
   chunk->flags = CHUNK_FLAG_ALLOCATED;
@@ -361,10 +461,10 @@ heapmem_alloc(size_t size)
  * from heapmem_alloc or heapmem_realloc, without any call to
  * heapmem_free in between.
  *
- * When performing a deallocation of a chunk, the chunk will be put on
- * a list of free chunks internally. All free chunks that are adjacent
- * in memory will be merged into a single chunk in order to mitigate
- * fragmentation.
+ * When performing a deallocation of a chunk, the chunk is merged with
+ * the free chunks that are adjacent to it in memory, in order to
+ * mitigate fragmentation, and then put on the free list of its size
+ * class.
  */
 void
 #if HEAPMEM_DEBUG
@@ -412,6 +512,7 @@ heapmem_realloc(void *ptr, size_t size)
 {
   void *newptr;
   chunk_t *chunk;
+  chunk_t *next;
   int size_adj;
 
   PRINTF("%s ptr %p size %u at %s:%u\n",
@@ -442,7 +543,7 @@ heapmem_realloc(void *ptr, size_t size)
   }
 
   /* Request to make the object larger. (size_adj > 0) */
-  if(IS_LAST_CHUNK(chunk)) {
+  if(chunk == last_chunk) {
     /*
      * If the object is within the last allocated chunk (i.e., the
      * one before the end of the heap footprint, we just attempt to
@@ -455,13 +556,19 @@ heapmem_realloc(void *ptr, size_t size)
   } else {
     /*
      * Here we attempt to enlarge an allocated object, whose
-     * adjacent space may already be allocated. We attempt to
-     * coalesce chunks in order to make as much room as possible.
+     * adjacent space may already be allocated. Free chunks are always
+     * merged, so there is at most one free chunk to take over.
      */
-    coalesce_chunks(chunk);
-    if(chunk->size >= size) {
+    next = NEXT_CHUNK(chunk);
+    if(CHUNK_FREE(next) &&
+       chunk->size + sizeof(chunk_t) + next->size >= size) {
       /* There was enough free adjacent space to extend the chunk in
 	 its current place. */
+      list_remove(next);
+      if(next == last_chunk) {
+        last_chunk = chunk;
+      }
+      resize_chunk(chunk, chunk->size + sizeof(chunk_t) + next->size);
       split_chunk(chunk, size);
       return ptr;
     }
@@ -499,12 +606,20 @@ heapmem_stats(heapmem_stats_t *stats)
     if(CHUNK_ALLOCATED(chunk)) {
       stats->allocated += chunk->size;
     } else {
-      coalesce_chunks(chunk);
       stats->available += chunk->size;
+      stats->free_chunks++;
+      if(chunk->size > stats->largest_free) {
+        stats->largest_free = chunk->size;
+      }
     }
     stats->overhead += sizeof(chunk_t);
   }
   stats->available += HEAPMEM_ARENA_SIZE - heap_usage;
+  if(HEAPMEM_ARENA_SIZE - heap_usage > stats->largest_free) {
+    stats->largest_free = HEAPMEM_ARENA_SIZE - heap_usage;
+  }
   stats->footprint = heap_usage;
   stats->chunks = stats->overhead / sizeof(chunk_t);
+  stats->max_search = max_search;
+  stats->failures = failures;
 }
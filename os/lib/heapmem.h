@@ -43,9 +43,12 @@
  * explicitly in order to be possible to use this module.
  *
  * Each allocated memory object is referred to as a "chunk". The
- * allocator manages free chunks in a double-linked list. While this
- * adds some memory overhead compared to a single-linked list, it
- * improves the performance of list management.
+ * allocator manages free chunks in double-linked lists, one for each
+ * size class. While this adds some memory overhead compared to a
+ * single-linked list, it improves the performance of list management.
+ * Small sizes have one class each, so that allocating and freeing
+ * them takes constant time. A chunk is merged with its free neighbors
+ * as soon as it is freed.
  *
  * Internally, allocated chunks can be retrieved using the pointer to
  * the allocated memory returned by heapmem_alloc() and
@@ -82,6 +85,15 @@ typedef struct heapmem_stats {
   size_t available;
   size_t footprint;
   size_t chunks;
+  /* The number of free chunks below the footprint. */
+  size_t free_chunks;
+  /* The largest allocation that can currently succeed. Compared with
+     the available space, this tells how fragmented the heap is. */
+  size_t largest_free;
+  /* The most free list entries examined by a single allocation. */
+  size_t max_search;
+  /* The number of allocations that have failed. */
+  size_t failures;
 } heapmem_stats_t;
 
 #if HEAPMEM_DEBUG
@@ -154,7 +166,8 @@ void heapmem_free(void *ptr);
  * This function makes it possible to gain visibility into the internal
  * structure of the heap. One can thus obtain information regarding
  * the amount of memory allocated, overhead used for memory management,
- * and the number of chunks allocated. By using this information, developers
+ * the number of chunks allocated, how fragmented the free memory is,
+ * and how long allocations have searched. By using this information, developers
  * can tune their software to use the heapmem allocator more efficiently.
  *
  */
@@ -47,19 +47,79 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+#if MEMB_WITH_FREELIST
+/* Free blocks large enough to hold the free list index are chained */
+#define USE_FREELIST(m) ((m)->size >= sizeof(unsigned short))
+/* The index is kept at the end of the block, away from the list
+   pointers that are typically the first member of a structure. */
+#define FREELIST_LINK(m, i) \
+  ((char *)(m)->mem + ((i) + 1) * (m)->size - sizeof(unsigned short))
+#endif /* MEMB_WITH_FREELIST */
+
+#if MEMB_WITH_STATS
+static struct memb *memb_list;
+#endif /* MEMB_WITH_STATS */
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
+#if MEMB_WITH_STATS
+  struct memb *l;
+#endif /* MEMB_WITH_STATS */
+
   memset(m->used, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+#if MEMB_WITH_FREELIST
+  m->free = 0;
+  m->unused = 0;
+#endif /* MEMB_WITH_FREELIST */
+#if MEMB_WITH_STATS
+  m->count = m->max = m->failures = 0;
+  for(l = memb_list; l != NULL && l != m; l = l->next);
+  if(l == NULL) {
+    m->next = memb_list;
+    memb_list = m;
+  }
+#endif /* MEMB_WITH_STATS */
 }
 /*---------------------------------------------------------------------------*/
-void *
-memb_alloc(struct memb *m)
+static int
+block_index(struct memb *m, void *ptr)
+{
+  unsigned long offset;
+
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+  offset = (char *)ptr - (char *)m->mem;
+  if(offset % m->size != 0) {
+    return -1;
+  }
+  return offset / m->size;
+}
+/*---------------------------------------------------------------------------*/
+static void *
+alloc_block(struct memb *m)
 {
   int i;
 
+#if MEMB_WITH_FREELIST
+  if(USE_FREELIST(m)) {
+    if(m->free != 0) {
+      /* Take the first block of the free list. */
+      i = m->free - 1;
+      memcpy(&m->free, FREELIST_LINK(m, i), sizeof(m->free));
+    } else if(m->unused < m->num) {
+      /* Take a block that has never been allocated. */
+      i = m->unused++;
+    } else {
+      return NULL;
+    }
+    m->used[i] = true;
+    return (void *)((char *)m->mem + (i * m->size));
+  }
+#endif /* MEMB_WITH_FREELIST */
+
   for(i = 0; i < m->num; ++i) {
     if(m->used[i] == false) {
       /* If this block was unused, we set the used flag on
@@ -74,27 +134,46 @@ memb_alloc(struct memb *m)
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+void *
+memb_alloc(struct memb *m)
+{
+  void *ptr = alloc_block(m);
+
+#if MEMB_WITH_STATS
+  if(ptr == NULL) {
+    m->failures++;
+  } else if(++m->count > m->max) {
+    m->max = m->count;
+  }
+#endif /* MEMB_WITH_STATS */
+
+  return ptr;
+}
+/*---------------------------------------------------------------------------*/
 int
 memb_free(struct memb *m, void *ptr)
 {
   int i;
-  char *ptr2;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    if(ptr2 == (char *)ptr) {
-      /* We've found the block to which "ptr" points, so we check the allocation
-         status to detect the double-free error and free the block. */
-      if (m->used[i] == false)
-        return -1;
-      m->used[i] = false;
-      return 0;
-    }
-    ptr2 += m->size;
+  /* Compute the index of the block to which "ptr" points, and check
+     the allocation status to detect the double-free error. */
+  i = block_index(m, ptr);
+  if(i < 0 || m->used[i] == false) {
+    return -1;
+  }
+  m->used[i] = false;
+
+#if MEMB_WITH_FREELIST
+  if(USE_FREELIST(m)) {
+    memcpy(FREELIST_LINK(m, i), &m->free, sizeof(m->free));
+    m->free = i + 1;
   }
-  return -1;
+#endif /* MEMB_WITH_FREELIST */
+#if MEMB_WITH_STATS
+  m->count--;
+#endif /* MEMB_WITH_STATS */
+
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -107,6 +186,9 @@ memb_inmemb(struct memb *m, void *ptr)
 int
 memb_numfree(struct memb *m)
 {
+#if MEMB_WITH_STATS
+  return m->num - m->count;
+#else /* MEMB_WITH_STATS */
   int i;
   int num_free = 0;
 
@@ -117,5 +199,14 @@ memb_numfree(struct memb *m)
   }
 
   return num_free;
+#endif /* MEMB_WITH_STATS */
+}
+/*---------------------------------------------------------------------------*/
+#if MEMB_WITH_STATS
+struct memb *
+memb_stats_list(void)
+{
+  return memb_list;
 }
+#endif /* MEMB_WITH_STATS */
 /** @} */
@@ -66,6 +66,42 @@
 #include <stdbool.h>
 #include "sys/cc.h"
 
+/**
+ * \brief Keep a free list in the unused memory blocks
+ *
+ * When enabled, free memory blocks are chained through an index that
+ * is stored in the last bytes of each free block, so that
+ * memb_alloc() takes constant time. The index is only written while
+ * the block is free. Memory blocks smaller than the index are always
+ * allocated with a linear search.
+ */
+#ifdef MEMB_CONF_WITH_FREELIST
+#define MEMB_WITH_FREELIST MEMB_CONF_WITH_FREELIST
+#else /* MEMB_CONF_WITH_FREELIST */
+#define MEMB_WITH_FREELIST 0
+#endif /* MEMB_CONF_WITH_FREELIST */
+
+/**
+ * \brief Keep usage statistics for each set of memory blocks
+ *
+ * When enabled, each set of memory blocks keeps track of the number
+ * of blocks in use, the maximum number of blocks that have been in
+ * use at the same time, and the number of failed allocations. All
+ * sets that have been initialized with memb_init() can be retrieved
+ * with memb_stats_list().
+ */
+#ifdef MEMB_CONF_WITH_STATS
+#define MEMB_WITH_STATS MEMB_CONF_WITH_STATS
+#else /* MEMB_CONF_WITH_STATS */
+#define MEMB_WITH_STATS 0
+#endif /* MEMB_CONF_WITH_STATS */
+
+#if MEMB_WITH_STATS
+#define MEMB_STATS_INIT(name) , #name
+#else /* MEMB_WITH_STATS */
+#define MEMB_STATS_INIT(name)
+#endif /* MEMB_WITH_STATS */
+
 /**
  * Declare a memory block.
  *
@@ -92,13 +128,27 @@ MEMB(connections, struct connection, 16);
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_used), \
-                                          (void *)CC_CONCAT(name,_memb_mem)}
+                                          (void *)CC_CONCAT(name,_memb_mem) \
+                                          MEMB_STATS_INIT(name)}
 
 struct memb {
   unsigned short size;
   unsigned short num;
   bool *used;
   void *mem;
+#if MEMB_WITH_STATS
+  const char *name;
+  struct memb *next;
+  unsigned short count;
+  unsigned short max;
+  unsigned short failures;
+#endif /* MEMB_WITH_STATS */
+#if MEMB_WITH_FREELIST
+  /* One plus the index of the first block in the free list, or 0 */
+  unsigned short free;
+  /* Blocks from this index onwards have never been allocated */
+  unsigned short unused;
+#endif /* MEMB_WITH_FREELIST */
 };
 
 /**
@@ -149,6 +199,16 @@ int memb_inmemb(struct memb *m, void *ptr);
  */
 int  memb_numfree(struct memb *m);
 
+#if MEMB_WITH_STATS
+/**
+ * Get the sets of memory blocks that keep statistics
+ *
+ * \return The first set of memory blocks that has been initialized
+ * with memb_init(). The other sets are linked through the next field.
+ */
+struct memb *memb_stats_list(void);
+#endif /* MEMB_WITH_STATS */
+
 /** @} */
 /** @} */
 
@@ -46,15 +46,12 @@
 void
 coap_log_string(const char *text, size_t len)
 {
-  int i;
   if(text == NULL) {
     LOG_OUTPUT("(NULL STR)");
     return;
   }
 
-  for(i = 0; i < len && *text != '\0'; i++, text++) {
-    LOG_OUTPUT("%c", *text);
-  }
+  LOG_OUTPUT("%.*s", (int)len, text);
 }
 /*---------------------------------------------------------------------------*/
 /** @} */
@@ -56,6 +56,38 @@ call_event(struct tcp_socket *s, tcp_socket_event_t event)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_TCP_SEND_WINDOW > 1
+/* With a send window, output_data_send_nxt is the amount of data in
+   flight, which starts at the beginning of the output buffer. */
+static void
+senddata(struct tcp_socket *s)
+{
+  int len;
+
+  if(uip_rexmit()) {
+    len = MIN(s->output_data_send_nxt - uip_rexmit_offset,
+              s->output_data_max_seg);
+    if(len > 0) {
+      uip_send(&s->output_data_ptr[uip_rexmit_offset], len);
+    }
+    /* There may be more segments to resend, or new data to send. */
+    tcpip_poll_tcp(uip_conn);
+    return;
+  }
+
+  len = MIN(s->output_data_len - s->output_data_send_nxt,
+            s->output_data_max_seg);
+  len = MIN(len, uip_send_room(uip_conn));
+  if(len > 0) {
+    uip_send(&s->output_data_ptr[s->output_data_send_nxt], len);
+    s->output_data_send_nxt += len;
+    if(s->output_data_send_nxt < s->output_data_len) {
+      /* Come back for the next segment once this one is out. */
+      tcpip_poll_tcp(uip_conn);
+    }
+  }
+}
+#else /* UIP_TCP_SEND_WINDOW > 1 */
 static void
 senddata(struct tcp_socket *s)
 {
@@ -67,32 +99,40 @@ senddata(struct tcp_socket *s)
     uip_send(s->output_data_ptr, len);
   }
 }
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
 /*---------------------------------------------------------------------------*/
 static void
 acked(struct tcp_socket *s)
 {
+#if UIP_TCP_SEND_WINDOW > 1
+  /* The ACK may cover only part of the data in flight. */
+  uint16_t acklen = MIN(uip_acklen, s->output_data_send_nxt);
+#else /* UIP_TCP_SEND_WINDOW > 1 */
+  uint16_t acklen = s->output_data_send_nxt;
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
+
   if(s->output_senddata_len > 0) {
     /* Copy the data in the outputbuf down and update outputbufptr and
        outputbuf_lastsent */
 
-    if(s->output_data_send_nxt > 0) {
+    if(acklen > 0) {
       memmove(&s->output_data_ptr[0],
-              &s->output_data_ptr[s->output_data_send_nxt],
-              s->output_data_maxlen - s->output_data_send_nxt);
+              &s->output_data_ptr[acklen],
+              s->output_data_maxlen - acklen);
     }
-    if(s->output_data_len < s->output_data_send_nxt) {
-      PRINTF("tcp: acked assertion failed s->output_data_len (%d) < s->output_data_send_nxt (%d)\n",
+    if(s->output_data_len < acklen) {
+      PRINTF("tcp: acked assertion failed s->output_data_len (%d) < acklen (%d)\n",
              s->output_data_len,
-             s->output_data_send_nxt);
+             acklen);
       tcp_markconn(uip_conn, NULL);
       uip_abort();
       call_event(s, TCP_SOCKET_ABORTED);
       relisten(s);
       return;
     }
-    s->output_data_len -= s->output_data_send_nxt;
+    s->output_data_len -= acklen;
     s->output_senddata_len = s->output_data_len;
-    s->output_data_send_nxt = 0;
+    s->output_data_send_nxt -= acklen;
 
     call_event(s, TCP_SOCKET_DATA_SENT);
   }
@@ -163,6 +203,10 @@ appcall(void *state)
 	   s->listen_port == uip_htons(uip_conn->lport)) {
 	  s->flags &= ~TCP_SOCKET_FLAGS_LISTENING;
           s->output_data_max_seg = uip_mss();
+#if UIP_TCP_SEND_WINDOW > 1
+          uip_set_send_window(uip_conn, UIP_TCP_SEND_WINDOW);
+          s->output_data_send_nxt = 0;
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
 	  tcp_markconn(uip_conn, s);
 	  call_event(s, TCP_SOCKET_CONNECTED);
 	  break;
@@ -170,6 +214,10 @@ appcall(void *state)
       }
     } else {
       s->output_data_max_seg = uip_mss();
+#if UIP_TCP_SEND_WINDOW > 1
+      uip_set_send_window(uip_conn, UIP_TCP_SEND_WINDOW);
+      s->output_data_send_nxt = 0;
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
       call_event(s, TCP_SOCKET_CONNECTED);
     }
 
@@ -130,7 +130,7 @@ tcpip_output(const uip_lladdr_t *a)
   }
 }
 
-PROCESS(tcpip_process, "TCP/IP stack");
+PROCESS_PRIO(tcpip_process, "TCP/IP stack", PROCESS_PRIO_HIGH);
 
 /*---------------------------------------------------------------------------*/
 #if UIP_TCP
@@ -355,7 +355,7 @@ eventhandler(process_event_t ev, process_data_t data)
       for(cptr = &uip_udp_conns[0];
           cptr < &uip_udp_conns[UIP_UDP_CONNS]; ++cptr) {
         if(cptr->appstate.p == p) {
-          cptr->lport = 0;
+          uip_udp_remove(cptr);
         }
       }
     }
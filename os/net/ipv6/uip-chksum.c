@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup uip
+ * @{
+ *
+ * \file
+ *         Internet checksum routines
+ */
+
+#include "net/ipv6/uip-chksum.h"
+#include "net/ipv6/uip.h"
+
+#include <string.h>
+
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_add_ref(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  const uint8_t *dataptr;
+  const uint8_t *last_byte;
+
+  dataptr = data;
+  last_byte = data + len - 1;
+
+  while(dataptr < last_byte) {   /* At least two more bytes */
+    t = (dataptr[0] << 8) + dataptr[1];
+    sum += t;
+    if(sum < t) {
+      sum++;      /* carry */
+    }
+    dataptr += 2;
+  }
+
+  if(dataptr == last_byte) {
+    t = (dataptr[0] << 8) + 0;
+    sum += t;
+    if(sum < t) {
+      sum++;      /* carry */
+    }
+  }
+
+  /* Return sum in host byte order. */
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_add_word(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  /* The sum of the data read as native 16-bit words is the byte-swapped
+   * sum of the big-endian words (RFC 1071), so the data is summed in
+   * native byte order and the result converted back at the end. With at
+   * most 64 KiB of data, 32-bit words cannot overflow the accumulator. */
+  uint64_t acc = UIP_HTONS(sum);
+  uint32_t w32[4];
+  uint16_t w16;
+  uint8_t last[2];
+
+  while(len >= 16) {
+    memcpy(w32, data, 16);
+    acc += (uint64_t)w32[0] + w32[1] + w32[2] + w32[3];
+    data += 16;
+    len -= 16;
+  }
+  while(len >= 4) {
+    memcpy(w32, data, 4);
+    acc += w32[0];
+    data += 4;
+    len -= 4;
+  }
+  if(len >= 2) {
+    memcpy(&w16, data, 2);
+    acc += w16;
+    data += 2;
+    len -= 2;
+  }
+  if(len > 0) {
+    /* The last byte is the first byte of a zero-padded word */
+    last[0] = *data;
+    last[1] = 0;
+    memcpy(&w16, last, 2);
+    acc += w16;
+  }
+
+  /* Fold the carries back in */
+  while(acc >> 16) {
+    acc = (acc & 0xffff) + (acc >> 16);
+  }
+  return UIP_HTONS((uint16_t)acc);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup uip
+ * @{
+ *
+ * \file
+ *         Internet checksum routines
+ *
+ * All routines add data to a running 16-bit one's complement sum. The sum
+ * is kept in host byte order, as if the data was read as big-endian 16-bit
+ * words, and is neither complemented nor folded to zero.
+ *
+ * uip_chksum_add() expands to the routine used by uIP. By default, it is
+ * the byte-pair reference routine. CPUs with 32-bit registers can select
+ * the word-at-a-time routine with UIP_CHKSUM_CONF_WORD. A CPU can also
+ * provide its own routine: create a CPU-specific header file that defines
+ * uip_chksum_add() to expand to the routine's name, and define
+ * UIP_CHKSUM_CONF_ARCH_HEADER_PATH as this header's filename.
+ */
+
+#ifndef UIP_CHKSUM_H_
+#define UIP_CHKSUM_H_
+
+#include "contiki.h"
+
+#include <stdint.h>
+
+/* Add data to the checksum 32 bits at a time, into a 64-bit accumulator */
+#ifdef UIP_CHKSUM_CONF_WORD
+#define UIP_CHKSUM_WORD UIP_CHKSUM_CONF_WORD
+#else /* UIP_CHKSUM_CONF_WORD */
+#define UIP_CHKSUM_WORD 0
+#endif /* UIP_CHKSUM_CONF_WORD */
+
+#ifdef UIP_CHKSUM_CONF_ARCH_HEADER_PATH
+#include UIP_CHKSUM_CONF_ARCH_HEADER_PATH
+#endif /* UIP_CHKSUM_CONF_ARCH_HEADER_PATH */
+
+#ifndef uip_chksum_add
+#if UIP_CHKSUM_WORD
+#define uip_chksum_add(sum, data, len) uip_chksum_add_word(sum, data, len)
+#else /* UIP_CHKSUM_WORD */
+#define uip_chksum_add(sum, data, len) uip_chksum_add_ref(sum, data, len)
+#endif /* UIP_CHKSUM_WORD */
+#endif /* uip_chksum_add */
+
+/**
+ * Adds data to a checksum, two bytes at a time. This is the reference
+ * that all other routines must agree with.
+ *
+ * \param sum The checksum so far, in host byte order
+ * \param data The data, of any alignment
+ * \param len The length of the data, odd lengths are padded with zero
+ * \return The new checksum, in host byte order
+ */
+uint16_t uip_chksum_add_ref(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * Adds data to a checksum, 32 bits at a time. Returns the same result
+ * as uip_chksum_add_ref().
+ *
+ * \param sum The checksum so far, in host byte order
+ * \param data The data, of any alignment
+ * \param len The length of the data, odd lengths are padded with zero
+ * \return The new checksum, in host byte order
+ */
+uint16_t uip_chksum_add_word(uint16_t sum, const uint8_t *data, uint16_t len);
+
+#endif /* UIP_CHKSUM_H_ */
+
+/** @} */
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup uip
+ * @{
+ *
+ * \file
+ *    A path-compressed binary (Patricia) trie over the prefixes of the
+ *    routing table, used for longest-prefix-match route lookups
+ */
+
+#include "net/ipv6/uip-ds6-route-trie.h"
+#include "lib/memb.h"
+
+#include <string.h>
+
+#if UIP_DS6_ROUTE_WITH_TRIE && (UIP_MAX_ROUTES != 0)
+
+/* A node of the trie. The key of a node is the first len bits of
+   prefix. A node either holds a route whose key is that of the node,
+   or is a branch node with two children. */
+struct trie_node {
+  struct trie_node *child[2];
+  uip_ds6_route_t *route;
+  uip_ipaddr_t prefix;
+  uint8_t len;
+};
+
+/* Each route adds at most one route node and one branch node */
+MEMB(trie_nodes, struct trie_node, UIP_DS6_ROUTE_TRIE_NODES);
+
+static struct trie_node *root;
+
+/* Number of routes that are not indexed, because another route with
+   the same key and a longer length is */
+static int shadowed;
+
+/* Routes are compared on whole bytes, see uip_ipaddr_prefixcmp() */
+#define KEY_LEN(route) ((route)->length & ~7)
+/*---------------------------------------------------------------------------*/
+static int
+get_bit(const uip_ipaddr_t *addr, int i)
+{
+  return (addr->u8[i >> 3] >> (7 - (i & 7))) & 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Get the number of leading bits that are equal in a and b, up to max */
+static int
+common_len(const uip_ipaddr_t *a, const uip_ipaddr_t *b, int max)
+{
+  int i;
+  uint8_t diff;
+
+  for(i = 0; i < max; i += 8) {
+    diff = a->u8[i >> 3] ^ b->u8[i >> 3];
+    if(diff != 0) {
+      while((diff & 0x80) == 0) {
+        diff <<= 1;
+        i++;
+      }
+      return MIN(i, max);
+    }
+  }
+  return max;
+}
+/*---------------------------------------------------------------------------*/
+static struct trie_node *
+node_new(const uip_ipaddr_t *prefix, int len, uip_ds6_route_t *route)
+{
+  struct trie_node *n = memb_alloc(&trie_nodes);
+
+  if(n != NULL) {
+    n->child[0] = n->child[1] = NULL;
+    n->route = route;
+    uip_ipaddr_copy(&n->prefix, prefix);
+    n->len = len;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_ds6_route_trie_init(void)
+{
+  memb_init(&trie_nodes);
+  root = NULL;
+  shadowed = 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_ds6_route_trie_add(uip_ds6_route_t *route)
+{
+  struct trie_node **link;
+  struct trie_node *n, *m, *leaf;
+  int len = KEY_LEN(route);
+  int c;
+
+  for(link = &root; (n = *link) != NULL;
+      link = &n->child[get_bit(&route->ipaddr, n->len)]) {
+    c = common_len(&route->ipaddr, &n->prefix, MIN(len, n->len));
+    if(c < n->len) {
+      if(c == len) {
+        /* The new key is a prefix of the key of n */
+        m = node_new(&route->ipaddr, len, route);
+        if(m == NULL) {
+          return 0;
+        }
+        m->child[get_bit(&n->prefix, len)] = n;
+      } else {
+        /* The keys diverge at bit c: insert a branch node */
+        m = node_new(&n->prefix, c, NULL);
+        leaf = node_new(&route->ipaddr, len, route);
+        if(m == NULL || leaf == NULL) {
+          memb_free(&trie_nodes, m);
+          memb_free(&trie_nodes, leaf);
+          return 0;
+        }
+        m->child[get_bit(&route->ipaddr, c)] = leaf;
+        m->child[get_bit(&n->prefix, c)] = n;
+      }
+      *link = m;
+      return 1;
+    }
+    if(n->len == len) {
+      /* Same key as n */
+      if(n->route == NULL) {
+        n->route = route;
+      } else {
+        shadowed++;
+        if(route->length >= n->route->length) {
+          n->route = route;
+        }
+      }
+      return 1;
+    }
+  }
+
+  *link = node_new(&route->ipaddr, len, route);
+  return *link != NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a node that no longer holds a route, if it has less than two
+   children. A branch node left with a single child is removed too. */
+static void
+prune(struct trie_node **link, struct trie_node **parent_link)
+{
+  struct trie_node *n = *link;
+  struct trie_node *p;
+
+  if(n->child[0] != NULL && n->child[1] != NULL) {
+    return;
+  }
+  *link = n->child[0] != NULL ? n->child[0] : n->child[1];
+  memb_free(&trie_nodes, n);
+
+  if(*link == NULL && parent_link != NULL) {
+    p = *parent_link;
+    if(p->route == NULL) {
+      *parent_link = p->child[0] != NULL ? p->child[0] : p->child[1];
+      memb_free(&trie_nodes, p);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_ds6_route_trie_rm(uip_ds6_route_t *route)
+{
+  struct trie_node **link, **parent_link;
+  struct trie_node *n;
+  uip_ds6_route_t *r, *best;
+  int len = KEY_LEN(route);
+
+  parent_link = NULL;
+  for(link = &root; (n = *link) != NULL && n->len < len;
+      link = &n->child[get_bit(&route->ipaddr, n->len)]) {
+    if(common_len(&route->ipaddr, &n->prefix, n->len) < n->len) {
+      return;
+    }
+    parent_link = link;
+  }
+
+  if(n == NULL || n->len != len || n->route == NULL ||
+     common_len(&route->ipaddr, &n->prefix, len) < len) {
+    /* The route is not in the trie */
+    return;
+  }
+
+  if(n->route != route) {
+    /* The route was shadowed by the route of n */
+    shadowed--;
+    return;
+  }
+
+  n->route = NULL;
+  prune(link, parent_link);
+
+  if(shadowed > 0) {
+    /* Index the longest other route with the same key, if any */
+    best = NULL;
+    for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+      if(r != route && KEY_LEN(r) == len &&
+         common_len(&r->ipaddr, &route->ipaddr, len) == len &&
+         (best == NULL || r->length >= best->length)) {
+        best = r;
+      }
+    }
+    if(best != NULL) {
+      shadowed--;
+      uip_ds6_route_trie_add(best);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+uip_ds6_route_t *
+uip_ds6_route_trie_lookup(const uip_ipaddr_t *addr)
+{
+  struct trie_node *n;
+  uip_ds6_route_t *found = NULL;
+
+  for(n = root; n != NULL; n = n->child[get_bit(addr, n->len)]) {
+    if(common_len(addr, &n->prefix, n->len) < n->len) {
+      break;
+    }
+    if(n->route != NULL) {
+      found = n->route;
+    }
+    if(n->len == 128) {
+      break;
+    }
+  }
+  return found;
+}
+#endif /* UIP_DS6_ROUTE_WITH_TRIE && (UIP_MAX_ROUTES != 0) */
+/** @} */
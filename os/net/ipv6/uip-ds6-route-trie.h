@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup uip
+ * @{
+ *
+ * \file
+ *    Header file for the prefix trie that indexes the routing table
+ */
+
+#ifndef UIP_DS6_ROUTE_TRIE_H_
+#define UIP_DS6_ROUTE_TRIE_H_
+
+#include "net/ipv6/uip-ds6-route.h"
+
+/**
+ * \brief Initialize the route trie
+ */
+void uip_ds6_route_trie_init(void);
+
+/**
+ * \brief Add a route to the trie
+ * \param route The route, with its address and length set
+ * \return 1 on success, 0 if no trie node could be allocated, in
+ *         which case the trie is left unchanged
+ *
+ * If another route with the same prefix is already in the trie, the
+ * route with the longest length is indexed and the other one is kept
+ * aside until the indexed route is removed.
+ */
+int uip_ds6_route_trie_add(uip_ds6_route_t *route);
+
+/**
+ * \brief Remove a route from the trie
+ * \param route The route, which must still be on the route list
+ */
+void uip_ds6_route_trie_rm(uip_ds6_route_t *route);
+
+/**
+ * \brief Look up the longest-prefix match for an address
+ * \param addr The destination address
+ * \return The matching route, or NULL if there is none
+ *
+ * A route matches when the first (length / 8) bytes of its address
+ * are equal to those of addr, as with uip_ipaddr_prefixcmp(). Among
+ * the matching routes, the one with the longest length is returned.
+ */
+uip_ds6_route_t *uip_ds6_route_trie_lookup(const uip_ipaddr_t *addr);
+
+#endif /* UIP_DS6_ROUTE_TRIE_H_ */
+/** @} */
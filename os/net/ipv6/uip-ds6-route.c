@@ -40,6 +40,7 @@
  */
 #include "net/ipv6/uip-ds6.h"
 #include "net/ipv6/uip-ds6-route.h"
+#include "net/ipv6/uip-ds6-route-trie.h"
 #include "net/ipv6/uip.h"
 
 #include "lib/list.h"
@@ -91,6 +92,11 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_WITH_TRIE
+/* Incremented on every route lookup and addition */
+static uint32_t lookup_counter;
+#endif /* UIP_DS6_ROUTE_WITH_TRIE */
+
 #endif /* (UIP_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -174,6 +180,9 @@ uip_ds6_route_init(void)
 #if (UIP_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_WITH_TRIE
+  uip_ds6_route_trie_init();
+#endif /* UIP_DS6_ROUTE_WITH_TRIE */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_MAX_ROUTES != 0) */
@@ -266,9 +275,11 @@ uip_ds6_route_t *
 uip_ds6_route_lookup(const uip_ipaddr_t *addr)
 {
 #if (UIP_MAX_ROUTES != 0)
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#if !UIP_DS6_ROUTE_WITH_TRIE
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_WITH_TRIE */
 
   LOG_INFO("Looking up route for ");
   LOG_INFO_6ADDR(addr);
@@ -278,6 +289,9 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     return NULL;
   }
 
+#if UIP_DS6_ROUTE_WITH_TRIE
+  found_route = uip_ds6_route_trie_lookup(addr);
+#else /* UIP_DS6_ROUTE_WITH_TRIE */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -293,6 +307,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_WITH_TRIE */
 
   if(found_route != NULL) {
     LOG_INFO("Found route: ");
@@ -304,6 +319,11 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     LOG_WARN("No route found\n");
   }
 
+#if UIP_DS6_ROUTE_WITH_TRIE
+  if(found_route != NULL) {
+    found_route->last_used = ++lookup_counter;
+  }
+#else /* UIP_DS6_ROUTE_WITH_TRIE */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -313,6 +333,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* UIP_DS6_ROUTE_WITH_TRIE */
 
   return found_route;
 #else /* (UIP_MAX_ROUTES != 0) */
@@ -372,9 +393,20 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
       uip_ds6_route_t *oldest;
       oldest = NULL;
 #if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+#if UIP_DS6_ROUTE_WITH_TRIE
+      /* Removing the route entry that has gone the longest without
+         being used, according to the lookup counter. */
+      for(r = list_head(routelist); r != NULL; r = list_item_next(r)) {
+        if(oldest == NULL ||
+           lookup_counter - r->last_used > lookup_counter - oldest->last_used) {
+          oldest = r;
+        }
+      }
+#else /* UIP_DS6_ROUTE_WITH_TRIE */
       /* Removing the oldest route entry from the route table. The
          least recently used route is the first route on the list. */
       oldest = list_tail(routelist);
+#endif /* UIP_DS6_ROUTE_WITH_TRIE */
 #endif
       if(oldest == NULL) {
         return NULL;
@@ -428,6 +460,18 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
       return NULL;
     }
 
+#if UIP_DS6_ROUTE_WITH_TRIE
+    /* Index the route before it is added anywhere else, so that a
+       route that cannot be indexed only has to be freed. */
+    uip_ipaddr_copy(&(r->ipaddr), ipaddr);
+    r->length = length;
+    if(!uip_ds6_route_trie_add(r)) {
+      LOG_ERR("Add: could not index route\n");
+      memb_free(&routememb, r);
+      return NULL;
+    }
+#endif /* UIP_DS6_ROUTE_WITH_TRIE */
+
     /* add new routes first - assuming that there is a reason to add this
        and that there is a packet coming soon. */
     list_push(routelist, r);
@@ -437,6 +481,9 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
       /* This should not happen, as we explicitly deallocated one
          route table entry above. */
       LOG_ERR("Add: could not allocate neighbor route list entry\n");
+#if UIP_DS6_ROUTE_WITH_TRIE
+      uip_ds6_route_trie_rm(r);
+#endif /* UIP_DS6_ROUTE_WITH_TRIE */
       memb_free(&routememb, r);
       return NULL;
     }
@@ -460,6 +507,10 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
 #endif
 
+#if UIP_DS6_ROUTE_WITH_TRIE
+  r->last_used = ++lookup_counter;
+#endif /* UIP_DS6_ROUTE_WITH_TRIE */
+
   LOG_INFO("Add: adding route: ");
   LOG_INFO_6ADDR(ipaddr);
   LOG_INFO_(" via ");
@@ -498,6 +549,10 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
     LOG_INFO_6ADDR(&route->ipaddr);
     LOG_INFO_("\n");
 
+#if UIP_DS6_ROUTE_WITH_TRIE
+    uip_ds6_route_trie_rm(route);
+#endif /* UIP_DS6_ROUTE_WITH_TRIE */
+
     /* Remove the route from the route list */
     list_remove(routelist, route);
 
@@ -111,6 +111,25 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_MAX_ROUTES */
 
+/* Index the routing table with a prefix trie, so that a route lookup
+   takes time proportional to the prefix length rather than to the
+   number of routes. Routes are then no longer reordered on lookup;
+   the least recently used route is tracked with a lookup stamp. */
+#ifdef UIP_DS6_ROUTE_CONF_WITH_TRIE
+#define UIP_DS6_ROUTE_WITH_TRIE UIP_DS6_ROUTE_CONF_WITH_TRIE
+#else /* UIP_DS6_ROUTE_CONF_WITH_TRIE */
+#define UIP_DS6_ROUTE_WITH_TRIE 0
+#endif /* UIP_DS6_ROUTE_CONF_WITH_TRIE */
+
+/* Number of nodes in the route trie. A route takes at most two nodes,
+   so the default never runs out. With fewer nodes, a route that cannot
+   be indexed is not added. */
+#ifdef UIP_DS6_ROUTE_CONF_TRIE_NODES
+#define UIP_DS6_ROUTE_TRIE_NODES UIP_DS6_ROUTE_CONF_TRIE_NODES
+#else /* UIP_DS6_ROUTE_CONF_TRIE_NODES */
+#define UIP_DS6_ROUTE_TRIE_NODES (2 * UIP_DS6_ROUTE_NB)
+#endif /* UIP_DS6_ROUTE_CONF_TRIE_NODES */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -180,6 +199,10 @@ typedef struct uip_ds6_route {
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   UIP_DS6_ROUTE_STATE_TYPE state;
 #endif
+#if UIP_DS6_ROUTE_WITH_TRIE
+  /* Value of the lookup counter when the route was last used */
+  uint32_t last_used;
+#endif /* UIP_DS6_ROUTE_WITH_TRIE */
   uint8_t length;
 } uip_ds6_route_t;
 
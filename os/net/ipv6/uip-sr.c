@@ -46,6 +46,8 @@
 #include "lib/list.h"
 #include "lib/memb.h"
 
+#include <string.h>
+
 /* Log configuration */
 #include "sys/log.h"
 #define LOG_MODULE "IPv6 SR"
@@ -58,6 +60,19 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, uip_sr_node_t, UIP_SR_LINK_NUM);
 
+#if UIP_SR_WITH_HASH
+/* The nodes, chained by hash of their link identifier */
+static uip_sr_node_t *hash_table[UIP_SR_HASH_SIZE];
+#endif /* UIP_SR_WITH_HASH */
+
+#if UIP_SR_WITH_CACHE
+/* Cached source routing headers, most recently used first */
+LIST(cachelist);
+MEMB(cachememb, uip_sr_cache_entry_t, UIP_SR_CACHE_SIZE);
+
+struct uip_sr_cache_stats uip_sr_cache_stats;
+#endif /* UIP_SR_WITH_CACHE */
+
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_num_nodes(void)
@@ -77,16 +92,94 @@ node_matches_address(void *graph, const uip_sr_node_t *node, const uip_ipaddr_t
   }
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_SR_WITH_HASH
+/* Get the hash bucket of a link identifier */
+static unsigned
+hash_bucket(const unsigned char *link_identifier)
+{
+  unsigned h = 0;
+  int i;
+
+  for(i = 0; i < 8; i++) {
+    h = h * 31 + link_identifier[i];
+  }
+  return h % UIP_SR_HASH_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_add(uip_sr_node_t *node)
+{
+  unsigned bucket = hash_bucket(node->link_identifier);
+
+  node->hash_next = hash_table[bucket];
+  hash_table[bucket] = node;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(uip_sr_node_t *node)
+{
+  uip_sr_node_t **l;
+
+  for(l = &hash_table[hash_bucket(node->link_identifier)];
+      *l != NULL; l = &(*l)->hash_next) {
+    if(*l == node) {
+      *l = node->hash_next;
+      return;
+    }
+  }
+}
+#endif /* UIP_SR_WITH_HASH */
+/*---------------------------------------------------------------------------*/
+/* Set the parent of a node, keeping track of the number of children */
+static void
+set_parent(uip_sr_node_t *node, uip_sr_node_t *parent)
+{
+#if UIP_SR_WITH_HASH
+  if(node->parent != NULL) {
+    node->parent->num_children--;
+  }
+  if(parent != NULL) {
+    parent->num_children++;
+  }
+#endif /* UIP_SR_WITH_HASH */
+  node->parent = parent;
+}
+/*---------------------------------------------------------------------------*/
+static void
+free_node(uip_sr_node_t *node)
+{
+  set_parent(node, NULL);
+#if UIP_SR_WITH_HASH
+  hash_remove(node);
+#endif /* UIP_SR_WITH_HASH */
+  list_remove(nodelist, node);
+  memb_free(&nodememb, node);
+  num_nodes--;
+}
+/*---------------------------------------------------------------------------*/
 uip_sr_node_t *
 uip_sr_get_node(void *graph, const uip_ipaddr_t *addr)
 {
   uip_sr_node_t *l;
+#if UIP_SR_WITH_HASH
+  if(addr == NULL) {
+    return NULL;
+  }
+  for(l = hash_table[hash_bucket(&addr->u8[8])]; l != NULL; l = l->hash_next) {
+    /* Compare node identifier first, then the full address */
+    if(memcmp(l->link_identifier, &addr->u8[8], 8) == 0
+       && node_matches_address(graph, l, addr)) {
+      return l;
+    }
+  }
+#else /* UIP_SR_WITH_HASH */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
     /* Compare prefix and node identifier */
     if(node_matches_address(graph, l, addr)) {
       return l;
     }
   }
+#endif /* UIP_SR_WITH_HASH */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -125,6 +218,10 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
   uip_sr_node_t *child_node = uip_sr_get_node(graph, child);
   uip_sr_node_t *parent_node = uip_sr_get_node(graph, parent);
   uip_sr_node_t *old_parent_node;
+#if UIP_SR_WITH_CACHE
+  uip_sr_node_t *prev_parent_node;
+  void *prev_graph;
+#endif /* UIP_SR_WITH_CACHE */
 
   if(parent != NULL) {
     /* No node for the parent, add one with infinite lifetime */
@@ -148,31 +245,47 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
       return NULL;
     }
     child_node->parent = NULL;
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+#if UIP_SR_WITH_HASH
+    child_node->num_children = 0;
+    hash_add(child_node);
+#endif /* UIP_SR_WITH_HASH */
     list_add(nodelist, child_node);
     num_nodes++;
   }
 
+#if UIP_SR_WITH_CACHE
+  prev_parent_node = child_node->parent;
+  prev_graph = child_node->graph;
+#endif /* UIP_SR_WITH_CACHE */
+
   /* Initialize node */
   child_node->graph = graph;
   child_node->lifetime = lifetime;
-  memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
 
   /* Is the node reachable before the update? */
   if(uip_sr_is_addr_reachable(graph, child)) {
     old_parent_node = child_node->parent;
     /* Update node */
-    child_node->parent = parent_node;
+    set_parent(child_node, parent_node);
     /* Has the node become unreachable? May happen if we create a loop. */
     if(!uip_sr_is_addr_reachable(graph, child)) {
       /* The new parent makes the node unreachable, restore old parent.
        * We will take the update next time, with chances we know more of
        * the topology and the loop is gone. */
-      child_node->parent = old_parent_node;
+      set_parent(child_node, old_parent_node);
     }
   } else {
-    child_node->parent = parent_node;
+    set_parent(child_node, parent_node);
   }
 
+#if UIP_SR_WITH_CACHE
+  /* A new parent changes the path to the node and to all its descendants */
+  if(child_node->parent != prev_parent_node || child_node->graph != prev_graph) {
+    uip_sr_cache_flush();
+  }
+#endif /* UIP_SR_WITH_CACHE */
+
   LOG_INFO("NS: updating link, child ");
   LOG_INFO_6ADDR(child);
   LOG_INFO_(", parent ");
@@ -188,6 +301,13 @@ uip_sr_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if UIP_SR_WITH_HASH
+  memset(hash_table, 0, sizeof(hash_table));
+#endif /* UIP_SR_WITH_HASH */
+#if UIP_SR_WITH_CACHE
+  memb_init(&cachememb);
+  list_init(cachelist);
+#endif /* UIP_SR_WITH_CACHE */
 }
 /*---------------------------------------------------------------------------*/
 uip_sr_node_t *
@@ -212,12 +332,21 @@ uip_sr_periodic(unsigned seconds)
   for(l = list_head(nodelist); l != NULL; l = next) {
     next = list_item_next(l);
     if(l->lifetime == 0) {
+#if UIP_SR_WITH_HASH
+      if(l->num_children > 0) {
+        continue;
+      }
+#else /* UIP_SR_WITH_HASH */
       uip_sr_node_t *l2;
       for(l2 = list_head(nodelist); l2 != NULL; l2 = list_item_next(l2)) {
         if(l2->parent == l) {
           break;
         }
       }
+      if(l2 != NULL) {
+        continue;
+      }
+#endif /* UIP_SR_WITH_HASH */
       if(LOG_INFO_ENABLED) {
         uip_ipaddr_t node_addr;
         NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, l);
@@ -226,9 +355,10 @@ uip_sr_periodic(unsigned seconds)
         LOG_INFO_("\n");
       }
       /* No child found, deallocate node */
-      list_remove(nodelist, l);
-      memb_free(&nodememb, l);
-      num_nodes--;
+      free_node(l);
+#if UIP_SR_WITH_CACHE
+      uip_sr_cache_flush();
+#endif /* UIP_SR_WITH_CACHE */
     } else if(l->lifetime != UIP_SR_INFINITE_LIFETIME) {
       l->lifetime = l->lifetime > seconds ? l->lifetime - seconds : 0;
     }
@@ -246,7 +376,124 @@ uip_sr_free_all(void)
     memb_free(&nodememb, l);
     num_nodes--;
   }
+#if UIP_SR_WITH_HASH
+  memset(hash_table, 0, sizeof(hash_table));
+#endif /* UIP_SR_WITH_HASH */
+#if UIP_SR_WITH_CACHE
+  uip_sr_cache_flush();
+#endif /* UIP_SR_WITH_CACHE */
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_SR_WITH_CACHE
+const uip_sr_cache_entry_t *
+uip_sr_cache_lookup(void *graph, const uip_ipaddr_t *dest)
+{
+  uip_sr_cache_entry_t *e;
+
+  for(e = list_head(cachelist); e != NULL; e = list_item_next(e)) {
+    if(e->graph == graph && uip_ipaddr_cmp(&e->dest, dest)) {
+      if(e != list_head(cachelist)) {
+        list_remove(cachelist, e);
+        list_push(cachelist, e);
+      }
+      uip_sr_cache_stats.hits++;
+      return e;
+    }
+  }
+  uip_sr_cache_stats.misses++;
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_sr_cache_add(void *graph, const uip_ipaddr_t *dest,
+                 const uip_ipaddr_t *next_hop,
+                 const uint8_t *hdr, uint8_t hdr_len)
+{
+  uip_sr_cache_entry_t *e;
+
+  if(hdr_len > UIP_SR_CACHE_HDR_LEN) {
+    return;
+  }
+
+  for(e = list_head(cachelist); e != NULL; e = list_item_next(e)) {
+    if(e->graph == graph && uip_ipaddr_cmp(&e->dest, dest)) {
+      list_remove(cachelist, e);
+      break;
+    }
+  }
+  if(e == NULL) {
+    e = memb_alloc(&cachememb);
+    if(e == NULL) {
+      /* Replace the least recently used entry */
+      e = list_chop(cachelist);
+      if(e == NULL) {
+        return;
+      }
+    }
+  }
+
+  e->graph = graph;
+  uip_ipaddr_copy(&e->dest, dest);
+  uip_ipaddr_copy(&e->next_hop, next_hop);
+  e->hdr_len = hdr_len;
+  if(hdr_len > 0) {
+    memcpy(e->hdr, hdr, hdr_len);
+  }
+  list_push(cachelist, e);
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_sr_cache_flush(void)
+{
+  uip_sr_cache_entry_t *e;
+
+  if(list_head(cachelist) == NULL) {
+    return;
+  }
+  while((e = list_pop(cachelist)) != NULL) {
+    memb_free(&cachememb, e);
+  }
+  uip_sr_cache_stats.flushes++;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_sr_cache_insert_hdr(const uip_sr_cache_entry_t *entry)
+{
+  struct uip_routing_hdr *rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
+  uint8_t ext_len = entry->hdr_len;
+
+  LOG_DBG("SRH found in cache, ext len %u\n", ext_len);
+
+  if(ext_len == 0) {
+    /* Direct child of the root, no SRH needed */
+    return 1;
+  }
+
+  /* Check if there is enough space to store the extension header */
+  if(uip_len + ext_len > UIP_LINK_MTU) {
+    LOG_ERR("Packet too long: impossible to add source routing header (%u bytes)\n", ext_len);
+    return 0;
+  }
+
+  /* Move existing ext headers and payload ext_len further */
+  memmove(uip_buf + UIP_IPH_LEN + uip_ext_len + ext_len,
+          uip_buf + UIP_IPH_LEN + uip_ext_len, uip_len - UIP_IPH_LEN);
+  memcpy(uip_buf + UIP_IPH_LEN + uip_ext_len, entry->hdr, ext_len);
+
+  /* Insert source routing header (as first ext header) */
+  rh_hdr->next = UIP_IP_BUF->proto;
+  UIP_IP_BUF->proto = UIP_PROTO_ROUTING;
+
+  /* The next hop is placed as the current IPv6 destination */
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &entry->next_hop);
+
+  /* Update the IPv6 length field */
+  uipbuf_add_ext_hdr(ext_len);
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+
+  return 1;
 }
+#endif /* UIP_SR_WITH_CACHE */
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_link_snprint(char *buf, int buflen, uip_sr_node_t *link)
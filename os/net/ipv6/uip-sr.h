@@ -85,6 +85,45 @@
 
 #define UIP_SR_INFINITE_LIFETIME           0xFFFFFFFF
 
+/* Keep a hash index of the nodes by link identifier, and count the
+   children of each node, so that DAO processing and link expiry do not
+   walk the whole node list */
+#ifdef UIP_SR_CONF_WITH_HASH
+#define UIP_SR_WITH_HASH              UIP_SR_CONF_WITH_HASH
+#else /* UIP_SR_CONF_WITH_HASH */
+#define UIP_SR_WITH_HASH              0
+#endif /* UIP_SR_CONF_WITH_HASH */
+
+/* The number of buckets of the node hash index */
+#ifdef UIP_SR_CONF_HASH_SIZE
+#define UIP_SR_HASH_SIZE              UIP_SR_CONF_HASH_SIZE
+#else /* UIP_SR_CONF_HASH_SIZE */
+#define UIP_SR_HASH_SIZE              (UIP_SR_LINK_NUM > 0 ? UIP_SR_LINK_NUM : 1)
+#endif /* UIP_SR_CONF_HASH_SIZE */
+
+/* Keep a cache of the source routing headers built by the root, so that
+   the path to a destination is not walked again for every packet */
+#ifdef UIP_SR_CONF_WITH_CACHE
+#define UIP_SR_WITH_CACHE             UIP_SR_CONF_WITH_CACHE
+#else /* UIP_SR_CONF_WITH_CACHE */
+#define UIP_SR_WITH_CACHE             0
+#endif /* UIP_SR_CONF_WITH_CACHE */
+
+/* The number of destinations in the source routing header cache */
+#ifdef UIP_SR_CONF_CACHE_SIZE
+#define UIP_SR_CACHE_SIZE             UIP_SR_CONF_CACHE_SIZE
+#else /* UIP_SR_CONF_CACHE_SIZE */
+#define UIP_SR_CACHE_SIZE             8
+#endif /* UIP_SR_CONF_CACHE_SIZE */
+
+/* The longest header that is cached. Longer headers are built for every
+   packet. */
+#ifdef UIP_SR_CONF_CACHE_HDR_LEN
+#define UIP_SR_CACHE_HDR_LEN          UIP_SR_CONF_CACHE_HDR_LEN
+#else /* UIP_SR_CONF_CACHE_HDR_LEN */
+#define UIP_SR_CACHE_HDR_LEN          64
+#endif /* UIP_SR_CONF_CACHE_HDR_LEN */
+
 /********** Data Structures  **********/
 
 /** \brief A node in a source routing graph, stored at the root and representing
@@ -98,8 +137,40 @@ typedef struct uip_sr_node {
   us with the prefix */
   unsigned char link_identifier[8];
   struct uip_sr_node *parent;
+#if UIP_SR_WITH_HASH
+  /* Next node in the same bucket of the hash index */
+  struct uip_sr_node *hash_next;
+  /* The number of nodes that have this node as parent */
+  uint16_t num_children;
+#endif /* UIP_SR_WITH_HASH */
 } uip_sr_node_t;
 
+/** \brief A source routing header built for a destination, as cached at the
+ * root. The header is stored as it is inserted in a packet, except for its
+ * next header field. */
+typedef struct uip_sr_cache_entry {
+  struct uip_sr_cache_entry *next;
+  /* The graph the destination belongs to */
+  void *graph;
+  uip_ipaddr_t dest;
+  /* The first hop, to be used as the IPv6 destination */
+  uip_ipaddr_t next_hop;
+  uint8_t hdr_len;
+  uint8_t hdr[UIP_SR_CACHE_HDR_LEN];
+} uip_sr_cache_entry_t;
+
+/** \brief Statistics of the source routing header cache */
+struct uip_sr_cache_stats {
+  uint32_t hits;
+  uint32_t misses;
+  /* The number of times the cache was emptied on a topology change */
+  uint32_t flushes;
+};
+
+#if UIP_SR_WITH_CACHE
+extern struct uip_sr_cache_stats uip_sr_cache_stats;
+#endif /* UIP_SR_WITH_CACHE */
+
 /********** Public functions **********/
 
 /**
@@ -180,6 +251,45 @@ void uip_sr_init(void);
 */
 void uip_sr_free_all(void);
 
+/**
+ * Looks up the cached source routing header for a destination
+ *
+ * \param graph The graph the destination belongs to
+ * \param dest The IPv6 address of the destination
+ * \return The cache entry, or NULL if the header has to be built
+*/
+const uip_sr_cache_entry_t *uip_sr_cache_lookup(void *graph, const uip_ipaddr_t *dest);
+
+/**
+ * Adds a source routing header to the cache. The entry stays valid until
+ * the graph changes, e.g. a node gets a new parent or is removed.
+ *
+ * \param graph The graph the destination belongs to
+ * \param dest The IPv6 address of the destination
+ * \param next_hop The IPv6 address of the first hop
+ * \param hdr The header, as inserted in the packet
+ * \param hdr_len The header length, 0 if no header is needed
+*/
+void uip_sr_cache_add(void *graph, const uip_ipaddr_t *dest,
+                      const uip_ipaddr_t *next_hop,
+                      const uint8_t *hdr, uint8_t hdr_len);
+
+/**
+ * Empties the source routing header cache
+*/
+void uip_sr_cache_flush(void);
+
+/**
+ * Inserts a cached source routing header in the packet in uip_buf, as its
+ * first extension header, and sets the IPv6 destination to the first hop.
+ * Nothing is inserted for an entry without header, i.e. a direct child of
+ * the root that is reached without SRH.
+ *
+ * \param entry The cache entry of the packet destination
+ * \return 1 on success, 0 if the packet is too long for the header
+*/
+int uip_sr_cache_insert_hdr(const uip_sr_cache_entry_t *entry);
+
 /**
 * Print a textual description of a source routing link
 *
@@ -487,7 +487,7 @@ void uip_setipid(uint16_t id);
     uip_process(UIP_UDP_TIMER); } while(0)
 #endif /* UIP_UDP */
 
-/** \brief Abandon the reassembly of the current packet */
+/** \brief Abandon the reassembly of a packet whose timer has expired */
 void uip_reass_over(void);
 
 /**
@@ -599,6 +599,53 @@ struct uip_conn *uip_connect(const uip_ipaddr_t *ripaddr, uint16_t port);
  */
 #define uip_outstanding(conn) ((conn)->len)
 
+#if UIP_TCP_SEND_WINDOW > 1
+/**
+ * Let a connection keep several segments in flight.
+ *
+ * Once enabled, every call to uip_send() outside of a uip_rexmit()
+ * event sends new data that follows the data already in flight, and
+ * the application must keep all unacknowledged data so that it can
+ * resend any segment on request. The number of bytes acknowledged is
+ * then reported in uip_acklen, and a uip_rexmit() event asks for the
+ * segment that starts uip_rexmit_offset bytes after the oldest
+ * unacknowledged byte; it may come together with uip_acked() and
+ * uip_newdata(). Connections start out with a window of one segment,
+ * which is the classic uIP behavior.
+ *
+ * \param conn A pointer to the uip_conn structure for the connection.
+ *
+ * \param segs The number of segments, up to UIP_TCP_SEND_WINDOW.
+ *
+ * \hideinitializer
+ */
+#define uip_set_send_window(conn, segs) \
+  ((conn)->max_segs = (segs) > UIP_TCP_SEND_WINDOW ? UIP_TCP_SEND_WINDOW : (segs))
+
+/**
+ * The number of new bytes a connection can send right now.
+ *
+ * This is limited by the MSS, by the window advertised by the remote
+ * host, and by the number of segments allowed in flight.
+ *
+ * \param conn A pointer to the uip_conn structure for the connection.
+ */
+uint16_t uip_send_room(struct uip_conn *conn);
+
+/**
+ * The number of bytes acknowledged by the current uip_acked() event,
+ * for connections with a send window.
+ */
+extern uint16_t uip_acklen;
+
+/**
+ * The offset of the segment to resend, counted from the oldest
+ * unacknowledged byte, during a uip_rexmit() event on a connection
+ * with a send window.
+ */
+extern uint16_t uip_rexmit_offset;
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
+
 /**
  * Send data on the current connection.
  *
@@ -861,7 +908,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_UDP_WITH_HASH
+#define uip_udp_remove(conn) uip_udp_bind(conn, 0)
+#else /* UIP_UDP_WITH_HASH */
 #define uip_udp_remove(conn) (conn)->lport = 0
+#endif /* UIP_UDP_WITH_HASH */
 
 /**
  * Bind a UDP connection to a local port.
@@ -873,7 +924,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_UDP_WITH_HASH
+void uip_udp_bind(struct uip_udp_conn *conn, uint16_t port);
+#else /* UIP_UDP_WITH_HASH */
 #define uip_udp_bind(conn, port) (conn)->lport = port
+#endif /* UIP_UDP_WITH_HASH */
 
 /**
  * Send a UDP datagram of length len on the current connection.
@@ -1341,6 +1396,20 @@ struct uip_conn {
   uint8_t timer;         /**< The retransmission timer. */
   uint8_t nrtx;          /**< The number of retransmissions for the last
                               segment sent. */
+#if UIP_TCP_SEND_WINDOW > 1
+  uint16_t snd_wnd;      /**< The window last advertised by the remote host. */
+  uint16_t seg_len[UIP_TCP_SEND_WINDOW]; /**< Lengths of the segments in
+                                              flight, oldest first. */
+  uint8_t seg_timer[UIP_TCP_SEND_WINDOW]; /**< Retransmission timers of the
+                                               segments in flight. */
+  uint8_t seg_rexmit;    /**< Bitmap of the segments in flight that have
+                              been retransmitted. */
+  uint8_t seg_lost;      /**< Bitmap of the segments in flight that are
+                              waiting to be resent. */
+  uint8_t nseg;          /**< The number of segments in flight. */
+  uint8_t max_segs;      /**< The number of segments allowed in flight. */
+  uint8_t dupacks;       /**< The number of duplicate ACKs received. */
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
   uip_tcp_appstate_t appstate; /** The application state. */
 };
 
@@ -1477,6 +1546,20 @@ struct uip_stats {
     uip_stats_t recv;     /**< Number of recived ND6 packets */
     uip_stats_t sent;     /**< Number of sent ND6 packets */
   } nd6;
+#if UIP_CONF_IPV6_REASSEMBLY
+  struct {
+    uip_stats_t recv;     /**< Number of received fragments. */
+    uip_stats_t reassembled; /**< Number of completely reassembled
+                                  packets. */
+    uip_stats_t drop;     /**< Number of fragments dropped because they
+                               did not fit the reassembly buffer or were
+                               malformed. */
+    uip_stats_t evicted;  /**< Number of partially reassembled packets
+                               dropped to make room for a new one. */
+    uip_stats_t timeout;  /**< Number of partially reassembled packets
+                               dropped when their timer expired. */
+  } reass;                /**< IPv6 reassembly statistics. */
+#endif /* UIP_CONF_IPV6_REASSEMBLY */
 };
 
 
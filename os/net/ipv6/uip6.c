@@ -74,6 +74,7 @@
 #include "sys/cc.h"
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uip-arch.h"
+#include "net/ipv6/uip-chksum.h"
 #include "net/ipv6/uipopt.h"
 #include "net/ipv6/uip-icmp6.h"
 #include "net/ipv6/uip-nd6.h"
@@ -128,13 +129,6 @@ uint8_t uip_last_proto = 0;
 /*---------------------------------------------------------------------------*/
 /* Buffers                                                                   */
 /*---------------------------------------------------------------------------*/
-/**
- * \name Reassembly buffer definition
- * @{
- */
-#define FBUF                                ((struct uip_ip_hdr *)&uip_reassbuf[0])
-
-/** @} */
 /**
  * \name Buffer variables
  * @{
@@ -157,6 +151,12 @@ uint16_t uip_urglen, uip_surglen;
 
 /* The uip_len is either 8 or 16 bits, depending on the maximum packet size.*/
 uint16_t uip_len, uip_slen;
+
+#if UIP_TCP && UIP_TCP_SEND_WINDOW > 1
+/* The amount of data acknowledged, and the offset of the segment to
+   resend, for connections with a send window. */
+uint16_t uip_acklen, uip_rexmit_offset;
+#endif /* UIP_TCP && UIP_TCP_SEND_WINDOW > 1 */
 /** @} */
 
 /*---------------------------------------------------------------------------*/
@@ -229,6 +229,13 @@ uint8_t uip_acc32[4];
 #if UIP_UDP
 struct uip_udp_conn *uip_udp_conn;
 struct uip_udp_conn uip_udp_conns[UIP_UDP_CONNS];
+
+#if UIP_UDP_WITH_HASH
+/* The bound connections, chained by hash of their local port. Both arrays
+ * hold the index of a connection plus one, or zero at the end of a chain. */
+static uint16_t udp_hash_head[UIP_UDP_HASH_SIZE];
+static uint16_t udp_hash_next[UIP_UDP_CONNS];
+#endif /* UIP_UDP_WITH_HASH */
 #endif /* UIP_UDP */
 /** @} */
 
@@ -275,44 +282,192 @@ uip_add32(uint8_t *op32, uint16_t op16)
   }
 }
 #endif /* UIP_TCP */
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP && UIP_TCP_SEND_WINDOW > 1
+/* The number of duplicate ACKs that trigger a fast retransmit. */
+#define TCP_DUPACK_THRESHOLD 3
 
-#if ! UIP_ARCH_CHKSUM
+#define TCP_WINDOWED(conn) ((conn)->max_segs > 1)
+/* Whether a connection with data in flight has segments to resend or
+   may send more. */
+#define TCP_WINDOW_OPEN(conn) (TCP_WINDOWED(conn) && \
+                               ((conn)->seg_lost || uip_send_room(conn) > 0))
+
+/* Bitmap of all the segments in flight. */
+#define TCP_SEGS_ALL(conn) ((1 << (conn)->nseg) - 1)
+
+static uint32_t
+seq32(const uint8_t *seq)
+{
+  return ((uint32_t)seq[0] << 24) | ((uint32_t)seq[1] << 16) |
+    ((uint32_t)seq[2] << 8) | seq[3];
+}
 /*---------------------------------------------------------------------------*/
-static uint16_t
-chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+static void
+window_init(struct uip_conn *conn)
+{
+  conn->snd_wnd = 0;
+  conn->seg_rexmit = 0;
+  conn->seg_lost = 0;
+  conn->nseg = 0;
+  conn->max_segs = 1;
+  conn->dupacks = 0;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_send_room(struct uip_conn *conn)
 {
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
+  uint16_t wnd;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  if(!TCP_WINDOWED(conn)) {
+    return conn->len == 0 ? conn->mss : 0;
+  }
+
+  /* A zero window is probed with a full segment, just like the
+     single-segment sender does. */
+  wnd = conn->snd_wnd == 0 ? conn->mss : conn->snd_wnd;
+  if(conn->nseg >= conn->max_segs || conn->len >= wnd) {
+    return 0;
+  }
+  return MIN(wnd - conn->len, conn->mss);
+}
+/*---------------------------------------------------------------------------*/
+/* Byte offset of segment i from the oldest unacknowledged byte. */
+static uint16_t
+window_offset(struct uip_conn *conn, uint8_t i)
+{
+  uint16_t offset;
+  uint8_t j;
 
-  while(dataptr < last_byte) {   /* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
+  offset = 0;
+  for(j = 0; j < i; j++) {
+    offset += conn->seg_len[j];
+  }
+  return offset;
+}
+/*---------------------------------------------------------------------------*/
+/* Record the segment of uip_slen bytes that is about to be sent as new
+   data and return its offset. */
+static uint16_t
+window_push(struct uip_conn *conn)
+{
+  uint16_t offset;
+
+  offset = conn->len;
+  conn->seg_len[conn->nseg] = uip_slen;
+  conn->seg_timer[conn->nseg] = conn->rto;
+  conn->seg_rexmit &= ~(1 << conn->nseg);
+  conn->nseg++;
+  conn->len += uip_slen;
+  return offset;
+}
+/*---------------------------------------------------------------------------*/
+/* Process the ACK in uip_buf for a connection with segments in
+   flight. Returns non-zero when a segment has been lost. */
+static int
+window_ack(struct uip_conn *conn)
+{
+  uint32_t acked;
+  uint16_t wnd;
+  signed char m;
+
+  acked = seq32(UIP_TCP_BUF->ackno) - seq32(conn->snd_nxt);
+  if(acked == 0) {
+    /* A pure ACK that neither acknowledges new data nor updates the
+       window is a duplicate, telling us that a segment is missing. */
+    wnd = ((uint16_t)UIP_TCP_BUF->wnd[0] << 8) + UIP_TCP_BUF->wnd[1];
+    if(uip_len == 0 && wnd == conn->snd_wnd) {
+      return ++conn->dupacks == TCP_DUPACK_THRESHOLD;
     }
-    dataptr += 2;
+    return 0;
+  }
+  if(acked > conn->len) {
+    /* Old or bogus ACK. */
+    return 0;
   }
 
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
+  /* Do RTT estimation on the oldest segment, unless it has been
+     retransmitted (Karn's algorithm). */
+  if(!(conn->seg_rexmit & 1) && conn->seg_timer[0] <= conn->rto) {
+    m = conn->rto - conn->seg_timer[0];
+    m = m - (conn->sa >> 3);
+    conn->sa += m;
+    if(m < 0) {
+      m = -m;
     }
+    m = m - (conn->sv >> 2);
+    conn->sv += m;
+    conn->rto = (conn->sa >> 3) + conn->sv;
+  }
+
+  uip_add32(conn->snd_nxt, (uint16_t)acked);
+  conn->snd_nxt[0] = uip_acc32[0];
+  conn->snd_nxt[1] = uip_acc32[1];
+  conn->snd_nxt[2] = uip_acc32[2];
+  conn->snd_nxt[3] = uip_acc32[3];
+  conn->len -= acked;
+  uip_acklen = acked;
+
+  /* Drop the segments that are completely acknowledged. A partially
+     acknowledged segment is shortened in place. */
+  while(conn->nseg > 0 && acked >= conn->seg_len[0]) {
+    acked -= conn->seg_len[0];
+    conn->nseg--;
+    memmove(&conn->seg_len[0], &conn->seg_len[1],
+            conn->nseg * sizeof(conn->seg_len[0]));
+    memmove(&conn->seg_timer[0], &conn->seg_timer[1], conn->nseg);
+    conn->seg_rexmit >>= 1;
+    conn->seg_lost >>= 1;
+  }
+  if(conn->nseg > 0) {
+    conn->seg_len[0] -= acked;
   }
 
-  /* Return sum in host byte order. */
-  return sum;
+  conn->nrtx = 0;
+  conn->dupacks = 0;
+  conn->timer = conn->rto;
+  uip_flags = UIP_ACKDATA;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Index of the oldest segment waiting to be resent, or nseg. */
+static uint8_t
+window_lost(struct uip_conn *conn)
+{
+  uint8_t i;
+
+  for(i = 0; i < conn->nseg && !(conn->seg_lost & (1 << i)); i++);
+  return i;
 }
 /*---------------------------------------------------------------------------*/
+/* Tick the retransmission timers of the segments in flight. Returns the
+   index of the first segment to retransmit, or nseg if there is none. */
+static uint8_t
+window_timer(struct uip_conn *conn)
+{
+  uint8_t i, expired;
+
+  expired = conn->nseg;
+  for(i = 0; i < conn->nseg; i++) {
+    if(conn->seg_timer[i] > 0) {
+      --conn->seg_timer[i];
+    } else if(expired == conn->nseg) {
+      expired = i;
+    }
+  }
+  return expired;
+}
+#else /* UIP_TCP && UIP_TCP_SEND_WINDOW > 1 */
+#define TCP_WINDOWED(conn) 0
+#define TCP_WINDOW_OPEN(conn) 0
+#endif /* UIP_TCP && UIP_TCP_SEND_WINDOW > 1 */
+
+#if ! UIP_ARCH_CHKSUM
+/*---------------------------------------------------------------------------*/
 uint16_t
 uip_chksum(uint16_t *data, uint16_t len)
 {
-  return uip_htons(chksum(0, (uint8_t *)data, len));
+  return uip_htons(uip_chksum_add(0, (uint8_t *)data, len));
 }
 /*---------------------------------------------------------------------------*/
 #ifndef UIP_ARCH_IPCHKSUM
@@ -321,7 +476,7 @@ uip_ipchksum(void)
 {
   uint16_t sum;
 
-  sum = chksum(0, uip_buf, UIP_IPH_LEN);
+  sum = uip_chksum_add(0, uip_buf, UIP_IPH_LEN);
   LOG_DBG("uip_ipchksum: sum 0x%04x\n", sum);
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -351,10 +506,10 @@ upper_layer_chksum(uint8_t proto)
   /* IP protocol and length fields. This addition cannot carry. */
   sum = upper_layer_len + proto;
   /* Sum IP source and destination addresses. */
-  sum = chksum(sum, (uint8_t *)&UIP_IP_BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t));
+  sum = uip_chksum_add(sum, (uint8_t *)&UIP_IP_BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t));
 
   /* Sum upper-layer header and data. */
-  sum = chksum(sum, UIP_IP_PAYLOAD(uip_ext_len), upper_layer_len);
+  sum = uip_chksum_add(sum, UIP_IP_PAYLOAD(uip_ext_len), upper_layer_len);
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -410,6 +565,9 @@ uip_init(void)
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
     uip_udp_conns[c].lport = 0;
   }
+#if UIP_UDP_WITH_HASH
+  memset(udp_hash_head, 0, sizeof(udp_hash_head));
+#endif /* UIP_UDP_WITH_HASH */
 #endif /* UIP_UDP */
 
 #if UIP_IPV6_MULTICAST
@@ -484,6 +642,9 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
   conn->lport = uip_htons(lastport);
   conn->rport = rport;
   uip_ipaddr_copy(&conn->ripaddr, ripaddr);
+#if UIP_TCP_SEND_WINDOW > 1
+  window_init(conn);
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
 
   return conn;
 }
@@ -518,6 +679,67 @@ uip_remove_ext_hdr(void)
 }
 /*---------------------------------------------------------------------------*/
 #if UIP_UDP
+#if UIP_UDP_WITH_HASH
+static unsigned
+udp_hash(uint16_t port)
+{
+  return UIP_HTONS(port) % UIP_UDP_HASH_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_udp_bind(struct uip_udp_conn *conn, uint16_t port)
+{
+  uint16_t index = conn - uip_udp_conns + 1;
+  uint16_t *i;
+
+  if(conn->lport == port) {
+    return;
+  }
+
+  /* Unlink from the chain of the old port */
+  if(conn->lport != 0) {
+    for(i = &udp_hash_head[udp_hash(conn->lport)]; *i != 0;
+        i = &udp_hash_next[*i - 1]) {
+      if(*i == index) {
+        *i = udp_hash_next[index - 1];
+        break;
+      }
+    }
+  }
+
+  conn->lport = port;
+
+  if(port != 0) {
+    udp_hash_next[index - 1] = udp_hash_head[udp_hash(port)];
+    udp_hash_head[udp_hash(port)] = index;
+  }
+}
+#endif /* UIP_UDP_WITH_HASH */
+/*---------------------------------------------------------------------------*/
+/* Tells whether a local port is used by a UDP connection */
+static int
+udp_port_in_use(uint16_t port)
+{
+#if UIP_UDP_WITH_HASH
+  uint16_t i;
+
+  for(i = udp_hash_head[udp_hash(port)]; i != 0; i = udp_hash_next[i - 1]) {
+    if(uip_udp_conns[i - 1].lport == port) {
+      return 1;
+    }
+  }
+#else /* UIP_UDP_WITH_HASH */
+  int c;
+
+  for(c = 0; c < UIP_UDP_CONNS; ++c) {
+    if(uip_udp_conns[c].lport == port) {
+      return 1;
+    }
+  }
+#endif /* UIP_UDP_WITH_HASH */
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
 struct uip_udp_conn *
 uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
 {
@@ -525,18 +747,13 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
   register struct uip_udp_conn *conn;
 
   /* Find an unused local port. */
-  again:
-  ++lastport;
-
-  if(lastport >= 32000) {
-    lastport = 4096;
-  }
+  do {
+    ++lastport;
 
-  for(c = 0; c < UIP_UDP_CONNS; ++c) {
-    if(uip_udp_conns[c].lport == uip_htons(lastport)) {
-      goto again;
+    if(lastport >= 32000) {
+      lastport = 4096;
     }
-  }
+  } while(udp_port_in_use(UIP_HTONS(lastport)));
 
   conn = 0;
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
@@ -550,7 +767,7 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     return 0;
   }
 
-  conn->lport = UIP_HTONS(lastport);
+  uip_udp_bind(conn, UIP_HTONS(lastport));
   conn->rport = rport;
   if(ripaddr == NULL) {
     memset(&conn->ripaddr, 0, sizeof(uip_ipaddr_t));
@@ -593,20 +810,10 @@ uip_listen(uint16_t port)
 #if UIP_CONF_IPV6_REASSEMBLY
 #define UIP_REASS_BUFSIZE (UIP_BUFSIZE)
 
-static uint8_t uip_reassbuf[UIP_REASS_BUFSIZE];
-
-static uint8_t uip_reassbitmap[UIP_REASS_BUFSIZE / (8 * 8)];
-/*the first byte of an IP fragment is aligned on an 8-byte boundary */
-
-static const uint8_t bitmap_bits[8] = {0xff, 0x7f, 0x3f, 0x1f,
-                                    0x0f, 0x07, 0x03, 0x01};
-static uint16_t uip_reasslen;
-static uint8_t uip_reassflags;
-
 #define UIP_REASS_FLAG_LASTFRAG 0x01
 #define UIP_REASS_FLAG_FIRSTFRAG 0x02
 #define UIP_REASS_FLAG_ERROR_MSG 0x04
-
+#define UIP_REASS_FLAG_ACTIVE 0x08
 
 /*
  * See RFC 2460 for a description of fragmentation in IPv6
@@ -617,156 +824,255 @@ static uint8_t uip_reassflags;
  *  +------------------+--------+--------------+
  */
 
+/* A packet under reassembly, identified by source, destination and the
+   Identification value that the source put in all its fragments */
+struct uip_reass_ctx {
+  uint8_t buf[UIP_REASS_BUFSIZE];
+  /* the first byte of an IP fragment is aligned on an 8-byte boundary */
+  uint8_t bitmap[UIP_REASS_BUFSIZE / (8 * 8) + 1];
+  struct timer timer;
+  uint32_t id;
+  uint16_t len;
+  uint16_t last_used;
+  uint8_t flags;
+};
 
-struct etimer uip_reass_timer; /**< Timer for reassembly */
-uint8_t uip_reass_on; /* equal to 1 if we are currently reassembling a packet */
+static struct uip_reass_ctx uip_reass_ctxs[UIP_REASS_CONTEXTS];
+/* The context that handled the last fragment passed to uip_reass() */
+static struct uip_reass_ctx *uip_reass_cur;
+/* Incremented on every fragment, for least recently used eviction */
+static uint16_t uip_reass_clock;
+
+static const uint8_t bitmap_bits[8] = {0xff, 0x7f, 0x3f, 0x1f,
+                                    0x0f, 0x07, 0x03, 0x01};
+
+struct etimer uip_reass_timer; /**< Fires when the oldest context expires */
 
-static uint32_t uip_id; /* For every packet that is to be fragmented, the source
-                        node generates an Identification value that is present
-                        in all the fragments */
 #define IP_MF   0x0001
 
+/*---------------------------------------------------------------------------*/
+/* Arm uip_reass_timer for the context that expires first, or stop it if
+   no packet is being reassembled. */
+static void
+uip_reass_schedule(void)
+{
+  struct uip_reass_ctx *ctx;
+  clock_time_t next = 0;
+  clock_time_t left;
+  uint8_t active = 0;
+
+  for(ctx = uip_reass_ctxs; ctx < uip_reass_ctxs + UIP_REASS_CONTEXTS; ctx++) {
+    if(ctx->flags & UIP_REASS_FLAG_ACTIVE) {
+      left = timer_expired(&ctx->timer) ? 0 : timer_remaining(&ctx->timer);
+      if(!active || left < next) {
+        next = left;
+      }
+      active = 1;
+    }
+  }
+
+  if(active) {
+    /* The timer event must reach tcpip_process, whichever process
+       handed us the fragment */
+    PROCESS_CONTEXT_BEGIN(&tcpip_process);
+    etimer_set(&uip_reass_timer, next);
+    PROCESS_CONTEXT_END(&tcpip_process);
+  } else {
+    etimer_stop(&uip_reass_timer);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+uip_reass_free(struct uip_reass_ctx *ctx)
+{
+  ctx->flags &= ~UIP_REASS_FLAG_ACTIVE;
+  uip_reass_schedule();
+}
+/*---------------------------------------------------------------------------*/
+/* Find the context that the fragment in uip_buf belongs to. If there is
+   none, take a free context or evict the least recently used one. */
+static struct uip_reass_ctx *
+uip_reass_lookup(const struct uip_frag_hdr *frag_buf, uint16_t unfrag_len)
+{
+  struct uip_reass_ctx *ctx;
+  struct uip_reass_ctx *victim = NULL;
+  struct uip_ip_hdr *fbuf;
+
+  for(ctx = uip_reass_ctxs; ctx < uip_reass_ctxs + UIP_REASS_CONTEXTS; ctx++) {
+    if(!(ctx->flags & UIP_REASS_FLAG_ACTIVE)) {
+      if(victim == NULL || (victim->flags & UIP_REASS_FLAG_ACTIVE)) {
+        victim = ctx;
+      }
+      continue;
+    }
+    fbuf = (struct uip_ip_hdr *)ctx->buf;
+    if(ctx->id == frag_buf->id &&
+       uip_ipaddr_cmp(&fbuf->srcipaddr, &UIP_IP_BUF->srcipaddr) &&
+       uip_ipaddr_cmp(&fbuf->destipaddr, &UIP_IP_BUF->destipaddr)) {
+      return ctx;
+    }
+    if(victim == NULL ||
+       ((victim->flags & UIP_REASS_FLAG_ACTIVE) &&
+        (uint16_t)(uip_reass_clock - ctx->last_used) >
+        (uint16_t)(uip_reass_clock - victim->last_used))) {
+      victim = ctx;
+    }
+  }
+
+  if(victim->flags & UIP_REASS_FLAG_ACTIVE) {
+    LOG_WARN("Evicting the oldest packet under reassembly\n");
+    UIP_STAT(++uip_stat.reass.evicted);
+  }
+
+  /* We first write the unfragmentable part of IP header into the
+     reassembly buffer. Then reset the other reassembly variables. */
+  LOG_INFO("Starting reassembly\n");
+  memcpy(victim->buf, UIP_IP_BUF, unfrag_len + UIP_IPH_LEN);
+  /* temporary in case we do not receive the fragment with offset 0 first */
+  timer_set(&victim->timer, UIP_REASS_MAXAGE * CLOCK_SECOND);
+  victim->flags = UIP_REASS_FLAG_ACTIVE;
+  victim->id = frag_buf->id;
+  /* Clear the bitmap. */
+  memset(victim->bitmap, 0, sizeof(victim->bitmap));
+  uip_reass_schedule();
+  return victim;
+}
+/*---------------------------------------------------------------------------*/
 static uint16_t
-uip_reass(uint8_t *prev_proto_ptr)
+uip_reass(struct uip_frag_hdr *frag_buf)
 {
   uint16_t offset=0;
   uint16_t len;
   uint16_t i;
-  struct uip_frag_hdr *frag_buf = (struct uip_frag_hdr *)UIP_IP_PAYLOAD(uip_ext_len);
-
-  /* If ip_reasstmr is zero, no packet is present in the buffer */
-  /* We first write the unfragmentable part of IP header into the reassembly
-     buffer. The reset the other reassembly variables. */
-  if(uip_reass_on == 0) {
-    LOG_INFO("Starting reassembly\n");
-    memcpy(FBUF, UIP_IP_BUF, uip_ext_len + UIP_IPH_LEN);
-    /* temporary in case we do not receive the fragment with offset 0 first */
-    etimer_set(&uip_reass_timer, UIP_REASS_MAXAGE*CLOCK_SECOND);
-    uip_reass_on = 1;
-    uip_reassflags = 0;
-    uip_id = frag_buf->id;
-    /* Clear the bitmap. */
-    memset(uip_reassbitmap, 0, sizeof(uip_reassbitmap));
+  uint16_t unfrag_len;
+  uint8_t *prev_proto_ptr;
+  uint8_t *hdr;
+  struct uip_reass_ctx *ctx;
+  struct uip_ip_hdr *fbuf;
+
+  UIP_STAT(++uip_stat.reass.recv);
+
+  /* The Unfragmentable Part is everything up to the Fragment header. Find
+     its last Next Header field, which the chain check in uip_process()
+     has already validated. */
+  prev_proto_ptr = &UIP_IP_BUF->proto;
+  for(hdr = UIP_IP_PAYLOAD(0); hdr < (uint8_t *)frag_buf;
+      hdr += (((struct uip_ext_hdr *)hdr)->len << 3) + 8) {
+    prev_proto_ptr = &((struct uip_ext_hdr *)hdr)->next;
+  }
+  unfrag_len = (uint8_t *)frag_buf - UIP_IP_PAYLOAD(0);
+
+  ctx = uip_reass_lookup(frag_buf, unfrag_len);
+  ctx->last_used = ++uip_reass_clock;
+  uip_reass_cur = ctx;
+  fbuf = (struct uip_ip_hdr *)ctx->buf;
+
+  len = uip_len - unfrag_len - UIP_IPH_LEN - UIP_FRAGH_LEN;
+  offset = (uip_ntohs(frag_buf->offsetresmore) & 0xfff8);
+  /* in byte, originaly in multiple of 8 bytes*/
+  LOG_INFO("len %d\n", len);
+  LOG_INFO("offset %d\n", offset);
+  if(offset == 0){
+    ctx->flags |= UIP_REASS_FLAG_FIRSTFRAG;
+    /*
+     * The Next Header field of the last header of the Unfragmentable
+     * Part is obtained from the Next Header field of the first
+     * fragment's Fragment header.
+     */
+    *prev_proto_ptr = frag_buf->next;
+    memcpy(fbuf, UIP_IP_BUF, unfrag_len + UIP_IPH_LEN);
+    LOG_INFO("src ");
+    LOG_INFO_6ADDR(&fbuf->srcipaddr);
+    LOG_INFO_("dest ");
+    LOG_INFO_6ADDR(&fbuf->destipaddr);
+    LOG_INFO_("next %d\n", UIP_IP_BUF->proto);
+  }
+
+  /* If the headers, offset and fragment length overflow the reassembly
+     buffer, we discard the entire packet. */
+  if(offset > UIP_REASS_BUFSIZE ||
+     UIP_IPH_LEN + unfrag_len + offset + len > UIP_REASS_BUFSIZE) {
+    UIP_STAT(++uip_stat.reass.drop);
+    uip_reass_free(ctx);
+    return 0;
   }
-  /*
-   * Check if the incoming fragment matches the one currently present
-   * in the reasembly buffer. If so, we proceed with copying the fragment
-   * into the buffer.
-   */
-  if(uip_ipaddr_cmp(&FBUF->srcipaddr, &UIP_IP_BUF->srcipaddr) &&
-     uip_ipaddr_cmp(&FBUF->destipaddr, &UIP_IP_BUF->destipaddr) &&
-     frag_buf->id == uip_id) {
-    len = uip_len - uip_ext_len - UIP_IPH_LEN - UIP_FRAGH_LEN;
-    offset = (uip_ntohs(frag_buf->offsetresmore) & 0xfff8);
-    /* in byte, originaly in multiple of 8 bytes*/
-    LOG_INFO("len %d\n", len);
-    LOG_INFO("offset %d\n", offset);
-    if(offset == 0){
-      uip_reassflags |= UIP_REASS_FLAG_FIRSTFRAG;
-      /*
-       * The Next Header field of the last header of the Unfragmentable
-       * Part is obtained from the Next Header field of the first
-       * fragment's Fragment header.
-       */
-      *prev_proto_ptr = frag_buf->next;
-      memcpy(FBUF, UIP_IP_BUF, uip_ext_len + UIP_IPH_LEN);
-      LOG_INFO("src ");
-      LOG_INFO_6ADDR(&FBUF->srcipaddr);
-      LOG_INFO_("dest ");
-      LOG_INFO_6ADDR(&FBUF->destipaddr);
-      LOG_INFO_("next %d\n", UIP_IP_BUF->proto);
-
-    }
-
-    /* If the offset or the offset + fragment length overflows the
-       reassembly buffer, we discard the entire packet. */
-    if(offset > UIP_REASS_BUFSIZE ||
-       offset + len > UIP_REASS_BUFSIZE) {
-      uip_reass_on = 0;
-      etimer_stop(&uip_reass_timer);
-      return 0;
-    }
 
-    /* If this fragment has the More Fragments flag set to zero, it is the
-       last fragment*/
-    if((uip_ntohs(frag_buf->offsetresmore) & IP_MF) == 0) {
-      uip_reassflags |= UIP_REASS_FLAG_LASTFRAG;
-      /*calculate the size of the entire packet*/
-      uip_reasslen = offset + len;
-      LOG_INFO("last fragment reasslen %d\n", uip_reasslen);
-    } else {
-      /* If len is not a multiple of 8 octets and the M flag of that fragment
-         is 1, then that fragment must be discarded and an ICMP Parameter
-         Problem, Code 0, message should be sent to the source of the fragment,
-         pointing to the Payload Length field of the fragment packet. */
-      if(len % 8 != 0){
-        uip_icmp6_error_output(ICMP6_PARAM_PROB, ICMP6_PARAMPROB_HEADER, 4);
-        uip_reassflags |= UIP_REASS_FLAG_ERROR_MSG;
-        /* not clear if we should interrupt reassembly, but it seems so from
-           the conformance tests */
-        uip_reass_on = 0;
-        etimer_stop(&uip_reass_timer);
-        return uip_len;
-      }
+  /* If this fragment has the More Fragments flag set to zero, it is the
+     last fragment*/
+  if((uip_ntohs(frag_buf->offsetresmore) & IP_MF) == 0) {
+    ctx->flags |= UIP_REASS_FLAG_LASTFRAG;
+    /*calculate the size of the entire packet*/
+    ctx->len = offset + len;
+    LOG_INFO("last fragment reasslen %d\n", ctx->len);
+  } else {
+    /* If len is not a multiple of 8 octets and the M flag of that fragment
+       is 1, then that fragment must be discarded and an ICMP Parameter
+       Problem, Code 0, message should be sent to the source of the fragment,
+       pointing to the Payload Length field of the fragment packet. */
+    if(len % 8 != 0){
+      uip_icmp6_error_output(ICMP6_PARAM_PROB, ICMP6_PARAMPROB_HEADER, 4);
+      ctx->flags |= UIP_REASS_FLAG_ERROR_MSG;
+      UIP_STAT(++uip_stat.reass.drop);
+      /* not clear if we should interrupt reassembly, but it seems so from
+         the conformance tests */
+      uip_reass_free(ctx);
+      return uip_len;
     }
+  }
 
-    /* Copy the fragment into the reassembly buffer, at the right
-       offset. */
-    memcpy((uint8_t *)FBUF + UIP_IPH_LEN + uip_ext_len + offset,
-           (uint8_t *)frag_buf + UIP_FRAGH_LEN, len);
+  /* Copy the fragment into the reassembly buffer, at the right
+     offset. */
+  memcpy((uint8_t *)fbuf + UIP_IPH_LEN + unfrag_len + offset,
+         (uint8_t *)frag_buf + UIP_FRAGH_LEN, len);
 
-    /* Update the bitmap. */
-    if(offset >> 6 == (offset + len) >> 6) {
-      uip_reassbitmap[offset >> 6] |=
-        bitmap_bits[(offset >> 3) & 7] &
-        ~bitmap_bits[((offset + len) >> 3)  & 7];
-    } else {
-      /* If the two endpoints are in different bytes, we update the
-         bytes in the endpoints and fill the stuff inbetween with
-         0xff. */
-      uip_reassbitmap[offset >> 6] |= bitmap_bits[(offset >> 3) & 7];
+  /* Update the bitmap. */
+  if(offset >> 6 == (offset + len) >> 6) {
+    ctx->bitmap[offset >> 6] |=
+      bitmap_bits[(offset >> 3) & 7] &
+      ~bitmap_bits[((offset + len) >> 3)  & 7];
+  } else {
+    /* If the two endpoints are in different bytes, we update the
+       bytes in the endpoints and fill the stuff inbetween with
+       0xff. */
+    ctx->bitmap[offset >> 6] |= bitmap_bits[(offset >> 3) & 7];
 
-      for(i = (1 + (offset >> 6)); i < ((offset + len) >> 6); ++i) {
-        uip_reassbitmap[i] = 0xff;
-      }
-      uip_reassbitmap[(offset + len) >> 6] |=
-        ~bitmap_bits[((offset + len) >> 3) & 7];
+    for(i = (1 + (offset >> 6)); i < ((offset + len) >> 6); ++i) {
+      ctx->bitmap[i] = 0xff;
     }
+    ctx->bitmap[(offset + len) >> 6] |=
+      ~bitmap_bits[((offset + len) >> 3) & 7];
+  }
 
-    /* Finally, we check if we have a full packet in the buffer. We do
-       this by checking if we have the last fragment and if all bits
-       in the bitmap are set. */
+  /* Finally, we check if we have a full packet in the buffer. We do
+     this by checking if we have the last fragment and if all bits
+     in the bitmap are set. */
 
-    if(uip_reassflags & UIP_REASS_FLAG_LASTFRAG) {
-      /* Check all bytes up to and including all but the last byte in
-         the bitmap. */
-      for(i = 0; i < (uip_reasslen >> 6); ++i) {
-        if(uip_reassbitmap[i] != 0xff) {
-          return 0;
-        }
-      }
-      /* Check the last byte in the bitmap. It should contain just the
-         right amount of bits. */
-      if(uip_reassbitmap[uip_reasslen >> 6] !=
-         (uint8_t)~bitmap_bits[(uip_reasslen >> 3) & 7]) {
+  if(ctx->flags & UIP_REASS_FLAG_LASTFRAG) {
+    /* Check all bytes up to and including all but the last byte in
+       the bitmap. */
+    for(i = 0; i < (ctx->len >> 6); ++i) {
+      if(ctx->bitmap[i] != 0xff) {
         return 0;
       }
+    }
+    /* Check the last byte in the bitmap. It should contain just the
+       right amount of bits. */
+    if(ctx->bitmap[ctx->len >> 6] !=
+       (uint8_t)~bitmap_bits[(ctx->len >> 3) & 7]) {
+      return 0;
+    }
 
-      /* If we have come this far, we have a full packet in the
-         buffer, so we copy it to uip_buf. We also reset the timer. */
-      uip_reass_on = 0;
-      etimer_stop(&uip_reass_timer);
-
-      uip_reasslen += UIP_IPH_LEN + uip_ext_len;
-      memcpy(UIP_IP_BUF, FBUF, uip_reasslen);
-      uipbuf_set_len_field(UIP_IP_BUF, uip_reasslen - UIP_IPH_LEN);
-      LOG_INFO("reassembled packet %d (%d)\n", uip_reasslen, uipbuf_get_len_field(UIP_IP_BUF));
+    /* If we have come this far, we have a full packet in the
+       buffer, so we copy it to uip_buf. We also free the context. */
+    uip_reass_free(ctx);
+    UIP_STAT(++uip_stat.reass.reassembled);
 
-      return uip_reasslen;
+    len = ctx->len + UIP_IPH_LEN + unfrag_len;
+    memcpy(UIP_IP_BUF, fbuf, len);
+    uipbuf_set_len_field(UIP_IP_BUF, len - UIP_IPH_LEN);
+    LOG_INFO("reassembled packet %d (%d)\n", len, uipbuf_get_len_field(UIP_IP_BUF));
 
-    }
-  } else {
-    LOG_WARN("Already reassembling another paquet\n");
+    return len;
   }
   return 0;
 }
@@ -774,12 +1080,24 @@ uip_reass(uint8_t *prev_proto_ptr)
 void
 uip_reass_over(void)
 {
-  /* to late, we abandon the reassembly of the packet */
+  struct uip_reass_ctx *ctx;
 
-  uip_reass_on = 0;
-  etimer_stop(&uip_reass_timer);
+  for(ctx = uip_reass_ctxs; ctx < uip_reass_ctxs + UIP_REASS_CONTEXTS; ctx++) {
+    if((ctx->flags & UIP_REASS_FLAG_ACTIVE) && timer_expired(&ctx->timer)) {
+      break;
+    }
+  }
+  if(ctx == uip_reass_ctxs + UIP_REASS_CONTEXTS) {
+    uip_reass_schedule();
+    return;
+  }
 
-  if(uip_reassflags & UIP_REASS_FLAG_FIRSTFRAG){
+  /* to late, we abandon the reassembly of the packet. Any other expired
+     context is handled when the rescheduled timer fires right away. */
+  UIP_STAT(++uip_stat.reass.timeout);
+  uip_reass_free(ctx);
+
+  if(ctx->flags & UIP_REASS_FLAG_FIRSTFRAG){
     LOG_ERR("fragmentation timeout\n");
     /* If the first fragment has been received, an ICMP Time Exceeded
        -- Fragment Reassembly Time Exceeded message should be sent to the
@@ -791,8 +1109,8 @@ uip_reass_over(void)
      * the packet.
      */
     uipbuf_clear();
-    memcpy(UIP_IP_BUF, FBUF, UIP_IPH_LEN); /* copy the header for src
-                                              and dest address*/
+    memcpy(UIP_IP_BUF, ctx->buf, UIP_IPH_LEN); /* copy the header for src
+                                                  and dest address*/
     uip_icmp6_error_output(ICMP6_TIME_EXCEEDED, ICMP6_TIME_EXCEED_REASSEMBLY, 0);
 
     UIP_STAT(++uip_stat.ip.sent);
@@ -944,6 +1262,27 @@ uip_update_ttl(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_UDP
+/* Tells whether a UDP connection accepts the datagram in uip_buf */
+static int
+udp_conn_matches(const struct uip_udp_conn *conn)
+{
+  /* If the local UDP port is non-zero, the connection is considered
+     to be used. If so, the local port number is checked against the
+     destination port number in the received packet. If the two port
+     numbers match, the remote port number is checked if the
+     connection is bound to a remote port. Finally, if the
+     connection is bound to a remote IP address, the source IP
+     address of the packet is checked. */
+  return conn->lport != 0 &&
+    UIP_UDP_BUF->destport == conn->lport &&
+    (conn->rport == 0 ||
+     UIP_UDP_BUF->srcport == conn->rport) &&
+    (uip_is_addr_unspecified(&conn->ripaddr) ||
+     uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &conn->ripaddr));
+}
+#endif /* UIP_UDP */
+/*---------------------------------------------------------------------------*/
 void
 uip_process(uint8_t flag)
 {
@@ -956,6 +1295,10 @@ uip_process(uint8_t flag)
   uint16_t tmp16;
   uint8_t opt;
   register struct uip_conn *uip_connr = uip_conn;
+#if UIP_TCP_SEND_WINDOW > 1
+  uint16_t send_offset = 0;
+  int fast_rexmit = 0;
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
 #endif /* UIP_TCP */
 #if UIP_UDP
   if(flag == UIP_UDP_SEND_CONN) {
@@ -969,7 +1312,13 @@ uip_process(uint8_t flag)
   if(flag == UIP_POLL_REQUEST) {
 #if UIP_TCP
     if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED &&
-       !uip_outstanding(uip_connr)) {
+       (!uip_outstanding(uip_connr) || TCP_WINDOW_OPEN(uip_connr))) {
+#if UIP_TCP_SEND_WINDOW > 1
+      if(uip_connr->seg_lost) {
+        uip_flags = 0;
+        goto window_resend;
+      }
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
       uip_flags = UIP_POLL;
       UIP_APPCALL();
       goto appsend;
@@ -1017,11 +1366,74 @@ uip_process(uint8_t flag)
        * in which case we retransmit.
        */
       if(uip_outstanding(uip_connr)) {
+#if UIP_TCP_SEND_WINDOW > 1
+        if(uip_connr->nseg > 0) {
+          /* Each segment in flight has its own retransmission timer.
+             While none of them has expired, we go on resending lost
+             segments, or poll the application for new data if the
+             window has room for it. */
+          c = window_timer(uip_connr);
+          if(c == uip_connr->nseg) {
+            if(uip_connr->seg_lost) {
+              uip_flags = 0;
+              goto window_resend;
+            }
+            if(uip_send_room(uip_connr) > 0) {
+              uip_flags = UIP_POLL;
+              UIP_APPCALL();
+              goto appsend;
+            }
+            goto drop;
+          }
+          if(uip_connr->nrtx == UIP_MAXRTX) {
+            goto tcp_timedout;
+          }
+
+          /* Segment c timed out. As ACKs are cumulative, the older
+             segments have not arrived either, and a receiver such as
+             uIP drops the newer ones if they arrive out of order, so we
+             resend the whole window starting with the oldest segment. */
+          uip_connr->seg_lost = TCP_SEGS_ALL(uip_connr);
+          c = 0;
+          uip_connr->seg_timer[c] = UIP_RTO << (uip_connr->nrtx > 4?
+                                                4:
+                                                uip_connr->nrtx);
+          ++(uip_connr->nrtx);
+          UIP_STAT(++uip_stat.tcp.rexmit);
+          uip_flags = 0;
+          goto window_rexmit;
+
+          /* Resend the oldest lost segment. An incoming segment that
+             led us here may also have acknowledged or carried data. */
+          window_resend:
+          c = window_lost(uip_connr);
+          uip_connr->seg_timer[c] = uip_connr->rto;
+          UIP_STAT(++uip_stat.tcp.rexmit);
+
+          /* Ask the application for segment c and send it from its
+             place in the sequence space. */
+          window_rexmit:
+          uip_connr->seg_lost &= ~(1 << c);
+          uip_connr->seg_rexmit |= 1 << c;
+          uip_rexmit_offset = window_offset(uip_connr, c);
+          uip_slen = 0;
+          uip_flags = (uip_flags & (UIP_ACKDATA | UIP_NEWDATA)) | UIP_REXMIT;
+          UIP_APPCALL();
+          if(uip_slen > uip_connr->seg_len[c]) {
+            uip_slen = uip_connr->seg_len[c];
+          }
+          send_offset = uip_rexmit_offset;
+          goto apprexmit;
+        }
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
         if(uip_connr->timer-- == 0) {
           if(uip_connr->nrtx == UIP_MAXRTX ||
              ((uip_connr->tcpstateflags == UIP_SYN_SENT ||
                uip_connr->tcpstateflags == UIP_SYN_RCVD) &&
               uip_connr->nrtx == UIP_MAXSYNRTX)) {
+#if UIP_TCP_SEND_WINDOW > 1
+            tcp_timedout:
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
             uip_connr->tcpstateflags = UIP_CLOSED;
 
             /*
@@ -1285,6 +1697,9 @@ uip_process(uint8_t flag)
   process:
 #endif /* UIP_IPV6_MULTICAST && UIP_CONF_ROUTER */
 
+#if UIP_CONF_IPV6_REASSEMBLY
+  ext_hdr_process:
+#endif /* UIP_CONF_IPV6_REASSEMBLY */
   /* IPv6 extension header processing: loop until reaching upper-layer protocol */
   uip_ext_bitmap = 0;
   for(next_header = uipbuf_get_next_header(uip_buf, uip_len, &protocol, true);
@@ -1384,19 +1799,23 @@ uip_process(uint8_t flag)
       /* Fragmentation header:call the reassembly function, then leave */
 #if UIP_CONF_IPV6_REASSEMBLY
       LOG_INFO("Processing fragmentation header\n");
-      uip_len = uip_reass(&ext_ptr->next);
+      uip_len = uip_reass((struct uip_frag_hdr *)ext_ptr);
       if(uip_len == 0) {
         goto drop;
       }
-      if(uip_reassflags & UIP_REASS_FLAG_ERROR_MSG) {
+      if(uip_reass_cur->flags & UIP_REASS_FLAG_ERROR_MSG) {
         /* we are not done with reassembly, this is an error message */
         goto send;
       }
       /* packet is reassembled. Restart the parsing of the reassembled pkt */
       LOG_INFO("Processing reassembled packet\n");
-      uip_ext_bitmap = 0;
-      next_header = uipbuf_get_next_header(uip_buf, uip_len, &protocol, true);
-      break;
+      last_header = uipbuf_get_last_header(uip_buf, uip_len, &uip_last_proto);
+      if(last_header == NULL) {
+        LOG_ERR("invalid extension header chain\n");
+        goto drop;
+      }
+      uip_ext_len = last_header - UIP_IP_PAYLOAD(0);
+      goto ext_hdr_process;
 #else /* UIP_CONF_IPV6_REASSEMBLY */
       UIP_STAT(++uip_stat.ip.drop);
       UIP_STAT(++uip_stat.ip.fragerr);
@@ -1523,25 +1942,35 @@ uip_process(uint8_t flag)
   }
 
   /* Demultiplex this UDP packet between the UDP "connections". */
+#if UIP_UDP_WITH_HASH
+  {
+    uint16_t i;
+    struct uip_udp_conn *found = NULL;
+
+    /* Of the matching connections, take the first one in uip_udp_conns,
+       as the walk over the array would */
+    for(i = udp_hash_head[udp_hash(UIP_UDP_BUF->destport)]; i != 0;
+        i = udp_hash_next[i - 1]) {
+      uip_udp_conn = &uip_udp_conns[i - 1];
+      if(udp_conn_matches(uip_udp_conn) &&
+         (found == NULL || uip_udp_conn < found)) {
+        found = uip_udp_conn;
+      }
+    }
+    if(found != NULL) {
+      uip_udp_conn = found;
+      goto udp_found;
+    }
+  }
+#else /* UIP_UDP_WITH_HASH */
   for(uip_udp_conn = &uip_udp_conns[0];
       uip_udp_conn < &uip_udp_conns[UIP_UDP_CONNS];
       ++uip_udp_conn) {
-    /* If the local UDP port is non-zero, the connection is considered
-       to be used. If so, the local port number is checked against the
-       destination port number in the received packet. If the two port
-       numbers match, the remote port number is checked if the
-       connection is bound to a remote port. Finally, if the
-       connection is bound to a remote IP address, the source IP
-       address of the packet is checked. */
-    if(uip_udp_conn->lport != 0 &&
-       UIP_UDP_BUF->destport == uip_udp_conn->lport &&
-       (uip_udp_conn->rport == 0 ||
-        UIP_UDP_BUF->srcport == uip_udp_conn->rport) &&
-       (uip_is_addr_unspecified(&uip_udp_conn->ripaddr) ||
-        uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &uip_udp_conn->ripaddr))) {
+    if(udp_conn_matches(uip_udp_conn)) {
       goto udp_found;
     }
   }
+#endif /* UIP_UDP_WITH_HASH */
   LOG_ERR("udp: no matching connection found\n");
   UIP_STAT(++uip_stat.udp.drop);
 
@@ -1758,6 +2187,9 @@ uip_process(uint8_t flag)
   uip_connr->snd_nxt[2] = iss[2];
   uip_connr->snd_nxt[3] = iss[3];
   uip_connr->len = 1;
+#if UIP_TCP_SEND_WINDOW > 1
+  window_init(uip_connr);
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
 
   /* rcv_nxt should be the seqno from the incoming packet + 1. */
   uip_connr->rcv_nxt[0] = UIP_TCP_BUF->seqno[0];
@@ -1876,7 +2308,15 @@ uip_process(uint8_t flag)
   /* Next, check if the incoming segment acknowledges any outstanding
      data. If so, we update the sequence number, reset the length of
      the outstanding data, calculate RTT estimations, and reset the
-     retransmission timer. */
+     retransmission timer. With several segments in flight, an ACK may
+     cover only some of them. */
+#if UIP_TCP_SEND_WINDOW > 1
+  if(uip_connr->nseg > 0) {
+    if(UIP_TCP_BUF->flags & TCP_ACK) {
+      fast_rexmit = window_ack(uip_connr);
+    }
+  } else
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
   if((UIP_TCP_BUF->flags & TCP_ACK) && uip_outstanding(uip_connr)) {
     uip_add32(uip_connr->snd_nxt, uip_connr->len);
 
@@ -1915,6 +2355,12 @@ uip_process(uint8_t flag)
     }
 
   }
+#if UIP_TCP_SEND_WINDOW > 1
+  if(UIP_TCP_BUF->flags & TCP_ACK) {
+    uip_connr->snd_wnd = ((uint16_t)UIP_TCP_BUF->wnd[0] << 8) +
+      UIP_TCP_BUF->wnd[1];
+  }
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
 
   /* Do different things depending on in what state the connection is. */
   switch(uip_connr->tcpstateflags & UIP_TS_MASK) {
@@ -2090,6 +2536,19 @@ uip_process(uint8_t flag)
     }
     uip_connr->mss = tmp16;
 
+#if UIP_TCP_SEND_WINDOW > 1
+    /* Three duplicate ACKs tell us that the oldest segment was lost,
+       and with it the segments after it if the receiver drops them
+       out of order. We resend them one per incoming ACK or poll,
+       without waiting for their retransmission timers. */
+    if(fast_rexmit) {
+      uip_connr->seg_lost = TCP_SEGS_ALL(uip_connr);
+    }
+    if(uip_connr->seg_lost) {
+      goto window_resend;
+    }
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
+
     /* If this packet constitutes an ACK for outstanding data (flagged
          by the UIP_ACKDATA flag, we should call the application since it
          might want to send more data. If the incoming packet had data
@@ -2122,12 +2581,29 @@ uip_process(uint8_t flag)
       if(uip_flags & UIP_CLOSE) {
         uip_slen = 0;
         uip_connr->len = 1;
+#if UIP_TCP_SEND_WINDOW > 1
+        uip_connr->nseg = 0;
+        uip_connr->seg_lost = 0;
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
         uip_connr->tcpstateflags = UIP_FIN_WAIT_1;
         uip_connr->nrtx = 0;
         UIP_TCP_BUF->flags = TCP_FIN | TCP_ACK;
         goto tcp_send_nodata;
       }
 
+#if UIP_TCP_SEND_WINDOW > 1
+      /* With a send window, the data follows what is already in
+         flight, as far as the window allows. */
+      if(uip_slen > 0 && TCP_WINDOWED(uip_connr)) {
+        tmp16 = uip_send_room(uip_connr);
+        if(uip_slen > tmp16) {
+          uip_slen = tmp16;
+        }
+        if(uip_slen > 0) {
+          send_offset = window_push(uip_connr);
+        }
+      } else
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
       /* If uip_slen > 0, the application has data to be sent. */
       if(uip_slen > 0) {
 
@@ -2160,7 +2636,11 @@ uip_process(uint8_t flag)
           uip_slen = uip_connr->len;
         }
       }
-      uip_connr->nrtx = 0;
+      /* With a send window, nrtx counts the retransmissions since
+           the last ACK that made progress. */
+      if(!TCP_WINDOWED(uip_connr)) {
+        uip_connr->nrtx = 0;
+      }
       apprexmit:
       uip_appdata = uip_sappdata;
 
@@ -2168,7 +2648,8 @@ uip_process(uint8_t flag)
            packet had new data in it, we must send out a packet. */
       if(uip_slen > 0 && uip_connr->len > 0) {
         /* Add the length of the IP and TCP headers. */
-        uip_len = uip_connr->len + UIP_IPTCPH_LEN;
+        uip_len = (TCP_WINDOWED(uip_connr) ? uip_slen : uip_connr->len) +
+          UIP_IPTCPH_LEN;
         /* We always set the ACK flag in response packets. */
         UIP_TCP_BUF->flags = TCP_ACK | TCP_PSH;
         /* Send the packet. */
@@ -2277,6 +2758,12 @@ uip_process(uint8_t flag)
   UIP_TCP_BUF->seqno[1] = uip_connr->snd_nxt[1];
   UIP_TCP_BUF->seqno[2] = uip_connr->snd_nxt[2];
   UIP_TCP_BUF->seqno[3] = uip_connr->snd_nxt[3];
+#if UIP_TCP_SEND_WINDOW > 1
+  if(send_offset > 0) {
+    uip_add32(uip_connr->snd_nxt, send_offset);
+    memcpy(UIP_TCP_BUF->seqno, uip_acc32, sizeof(uip_acc32));
+  }
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
 
   UIP_TCP_BUF->srcport  = uip_connr->lport;
   UIP_TCP_BUF->destport = uip_connr->rport;
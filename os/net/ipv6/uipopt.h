@@ -195,7 +195,11 @@ void uip_log(char *msg);
  * buffer before it is dropped.
  *
  */
+#ifdef UIP_CONF_REASS_MAXAGE
+#define UIP_REASS_MAXAGE (UIP_CONF_REASS_MAXAGE)
+#else /* UIP_CONF_REASS_MAXAGE */
 #define UIP_REASS_MAXAGE 60 /*60s*/
+#endif /* UIP_CONF_REASS_MAXAGE */
 
 /**
  * Turn on support for IP packet reassembly.
@@ -242,6 +246,24 @@ void uip_log(char *msg);
 #define UIP_CONF_IPV6_REASSEMBLY      0
 #endif
 
+/**
+ * The number of fragmented IPv6 packets that can be reassembled at
+ * the same time. Each context holds a reassembly buffer of
+ * UIP_BUFSIZE bytes. Fragments are matched to a context by source,
+ * destination and fragment identification; when all contexts are
+ * busy, a fragment that starts a new packet evicts the least recently
+ * updated one.
+ */
+#ifdef UIP_CONF_REASS_CONTEXTS
+#define UIP_REASS_CONTEXTS (UIP_CONF_REASS_CONTEXTS)
+#else /* UIP_CONF_REASS_CONTEXTS */
+#define UIP_REASS_CONTEXTS 1
+#endif /* UIP_CONF_REASS_CONTEXTS */
+
+#if UIP_REASS_CONTEXTS < 1
+#error "UIP_CONF_REASS_CONTEXTS must be at least 1"
+#endif
+
 #ifndef UIP_CONF_NETIF_MAX_ADDRESSES
 /** Default number of IPv6 addresses associated to the node's interface */
 #define UIP_CONF_NETIF_MAX_ADDRESSES  3
@@ -305,6 +327,29 @@ void uip_log(char *msg);
 #define UIP_UDP_CONNS    10
 #endif /* UIP_CONF_UDP_CONNS */
 
+/**
+ * Keep a hash table of the UDP connections by local port, so that
+ * incoming datagrams do not need a walk over all connections.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_UDP_WITH_HASH
+#define UIP_UDP_WITH_HASH (UIP_CONF_UDP_WITH_HASH)
+#else /* UIP_CONF_UDP_WITH_HASH */
+#define UIP_UDP_WITH_HASH 0
+#endif /* UIP_CONF_UDP_WITH_HASH */
+
+/**
+ * The number of buckets of the UDP connection hash table.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_UDP_HASH_SIZE
+#define UIP_UDP_HASH_SIZE (UIP_CONF_UDP_HASH_SIZE)
+#else /* UIP_CONF_UDP_HASH_SIZE */
+#define UIP_UDP_HASH_SIZE UIP_UDP_CONNS
+#endif /* UIP_CONF_UDP_HASH_SIZE */
+
 /**
  * The name of the function that should be called when UDP datagrams arrive.
  *
@@ -440,6 +485,29 @@ void uip_log(char *msg);
 #define UIP_RECEIVE_WINDOW (UIP_CONF_RECEIVE_WINDOW)
 #endif
 
+/**
+ * The maximum number of TCP segments a connection may have in flight.
+ *
+ * With the default of 1, uIP sends one segment and waits for it to be
+ * acknowledged before the application may send more. Larger values
+ * let connections that opt in with uip_set_send_window() keep up to
+ * this many segments outstanding, each with its own retransmission
+ * timer, and enable fast retransmit on duplicate ACKs. The
+ * application must then be able to resend any unacknowledged data,
+ * as tcp-socket does. At most 8 segments are supported.
+ *
+ * \hideinitializer
+ */
+#ifndef UIP_CONF_TCP_SEND_WINDOW
+#define UIP_TCP_SEND_WINDOW 1
+#else
+#define UIP_TCP_SEND_WINDOW (UIP_CONF_TCP_SEND_WINDOW)
+#endif
+
+#if UIP_TCP_SEND_WINDOW < 1 || UIP_TCP_SEND_WINDOW > 8
+#error UIP_CONF_TCP_SEND_WINDOW must be between 1 and 8
+#endif
+
 /**
  * How long a connection should stay in the TIME_WAIT state.
  *
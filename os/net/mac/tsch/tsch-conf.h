@@ -314,6 +314,15 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Keep a list of the unicast neighbors that may send in a shared slot
+ * (queue not empty, backoff expired, no dedicated Tx link), and serve them
+ * round-robin, instead of walking all neighbors at every shared slot */
+#ifdef TSCH_QUEUE_CONF_WITH_READY_LIST
+#define TSCH_QUEUE_WITH_READY_LIST TSCH_QUEUE_CONF_WITH_READY_LIST
+#else
+#define TSCH_QUEUE_WITH_READY_LIST 0
+#endif
+
 /******** Configuration: scheduling  *******/
 
 /* Initializes TSCH with a 6TiSCH minimal schedule */
@@ -353,6 +362,15 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep the links of each slotframe sorted by timeslot, so that the next
+ * active link is found with a binary search per slotframe rather than by
+ * walking all links at every slot */
+#ifdef TSCH_SCHEDULE_CONF_WITH_INDEX
+#define TSCH_SCHEDULE_WITH_INDEX TSCH_SCHEDULE_CONF_WITH_INDEX
+#else
+#define TSCH_SCHEDULE_WITH_INDEX 0
+#endif
+
 /* To include Sixtop Implementation */
 #ifdef TSCH_CONF_WITH_SIXTOP
 #define TSCH_WITH_SIXTOP TSCH_CONF_WITH_SIXTOP
@@ -53,6 +53,7 @@
 #include "lib/random.h"
 #include "net/queuebuf.h"
 #include "net/mac/tsch/tsch.h"
+#include "sys/critical.h"
 #include <string.h>
 
 /* Log configuration */
@@ -74,6 +75,80 @@ LIST(neighbor_list);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+#if TSCH_QUEUE_WITH_READY_LIST
+/* Unicast neighbors that may send in a shared slot, in the order they will
+ * be served. A neighbor is appended when it becomes ready, and moved to the
+ * end when it is served. Neighbors that are no longer ready, e.g. because
+ * they went into backoff, are unlinked lazily, when the list is walked.
+ * Dedicated slots to the broadcast address do not use the list, as neighbors
+ * in backoff may send in them. The list is updated from both the process
+ * context and the slot operation, with interrupts disabled. */
+static struct tsch_neighbor *ready_head;
+static struct tsch_neighbor *ready_tail;
+
+/*---------------------------------------------------------------------------*/
+static int
+is_ready(const struct tsch_neighbor *n)
+{
+  return !n->is_broadcast && n->tx_links_count == 0
+    && n->backoff_window == 0 && !ringbufindex_empty(&n->tx_ringbuf);
+}
+/*---------------------------------------------------------------------------*/
+/* Unlink a neighbor from the ready list, given the neighbor before it */
+static void
+ready_list_unlink(struct tsch_neighbor *prev, struct tsch_neighbor *n)
+{
+  int_master_status_t status = critical_enter();
+  if(prev == NULL) {
+    ready_head = n->ready_next;
+  } else {
+    prev->ready_next = n->ready_next;
+  }
+  if(ready_tail == n) {
+    ready_tail = prev;
+  }
+  n->ready_next = NULL;
+  n->is_ready_listed = 0;
+  critical_exit(status);
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a neighbor from the ready list, wherever it is */
+static void
+ready_list_remove(struct tsch_neighbor *n)
+{
+  struct tsch_neighbor *prev = NULL;
+  struct tsch_neighbor *curr;
+  for(curr = ready_head; curr != NULL; prev = curr, curr = curr->ready_next) {
+    if(curr == n) {
+      ready_list_unlink(prev, curr);
+      return;
+    }
+  }
+}
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
+/*---------------------------------------------------------------------------*/
+/* Append a neighbor to the ready list if it is ready */
+void
+tsch_queue_update_ready_list(struct tsch_neighbor *n)
+{
+#if TSCH_QUEUE_WITH_READY_LIST
+  if(n != NULL && is_ready(n)) {
+    int_master_status_t status = critical_enter();
+    if(!n->is_ready_listed) {
+      n->ready_next = NULL;
+      if(ready_tail != NULL) {
+        ready_tail->ready_next = n;
+      } else {
+        ready_head = n;
+      }
+      ready_tail = n;
+      n->is_ready_listed = 1;
+    }
+    critical_exit(status);
+  }
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
+}
+
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
@@ -213,6 +288,9 @@ tsch_queue_remove_nbr(struct tsch_neighbor *n)
 
       /* Remove neighbor from list */
       list_remove(neighbor_list, n);
+#if TSCH_QUEUE_WITH_READY_LIST
+      ready_list_remove(n);
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
 
       tsch_release_lock();
 
@@ -261,6 +339,7 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
             /* Add to ringbuf (actual add committed through atomic operation) */
             n->tx_array[put_index] = p;
             ringbufindex_put(&n->tx_ringbuf);
+            tsch_queue_update_ready_list(n);
             LOG_DBG("packet is added put_index %u, packet %p\n",
                    put_index, p);
             return p;
@@ -364,6 +443,9 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
     }
   }
 
+  /* The backoff may have been reset */
+  tsch_queue_update_ready_list(n);
+
   return in_queue;
 }
 /*---------------------------------------------------------------------------*/
@@ -456,8 +538,35 @@ struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
-    struct tsch_neighbor *curr_nbr = list_head(neighbor_list);
+    struct tsch_neighbor *curr_nbr;
     struct tsch_packet *p = NULL;
+#if TSCH_QUEUE_WITH_READY_LIST
+    if(link != NULL && (link->link_options & LINK_OPTION_SHARED)) {
+      struct tsch_neighbor *prev = NULL;
+      struct tsch_neighbor *next_nbr;
+      for(curr_nbr = ready_head; curr_nbr != NULL; curr_nbr = next_nbr) {
+        next_nbr = curr_nbr->ready_next;
+        if(!is_ready(curr_nbr)) {
+          ready_list_unlink(prev, curr_nbr);
+          continue;
+        }
+        p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
+        if(p != NULL) {
+          /* Serve the neighbor last next time */
+          ready_list_unlink(prev, curr_nbr);
+          tsch_queue_update_ready_list(curr_nbr);
+          if(n != NULL) {
+            *n = curr_nbr;
+          }
+          return p;
+        }
+        /* The packet is for another link */
+        prev = curr_nbr;
+      }
+      return NULL;
+    }
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
+    curr_nbr = list_head(neighbor_list);
     while(curr_nbr != NULL) {
       if(!curr_nbr->is_broadcast && curr_nbr->tx_links_count == 0) {
         /* Only look up for non-broadcast neighbors we do not have a tx link to */
@@ -517,6 +626,9 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
          && ((n->tx_links_count == 0 && is_broadcast)
              || (n->tx_links_count > 0 && linkaddr_cmp(dest_addr, &n->addr)))) {
         n->backoff_window--;
+        if(n->backoff_window == 0) {
+          tsch_queue_update_ready_list(n);
+        }
       }
       n = list_item_next(n);
     }
@@ -530,6 +642,9 @@ tsch_queue_init(void)
   list_init(neighbor_list);
   memb_init(&neighbor_memb);
   memb_init(&packet_memb);
+#if TSCH_QUEUE_WITH_READY_LIST
+  ready_head = ready_tail = NULL;
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
   /* Add virtual EB and the broadcast neighbors */
   n_eb = tsch_queue_add_nbr(&tsch_eb_address);
   n_broadcast = tsch_queue_add_nbr(&tsch_broadcast_address);
@@ -174,6 +174,12 @@ void tsch_queue_backoff_inc(struct tsch_neighbor *n);
  * \param dest_addr The target address, &tsch_broadcast_address for broadcast
  */
 void tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr);
+/**
+ * \brief Add a neighbor to the list of neighbors ready for shared slots,
+ * if it has become ready, e.g. after its last Tx link was removed
+ * \param n The neighbor queue
+ */
+void tsch_queue_update_ready_list(struct tsch_neighbor *n);
 /**
  * \brief Initialize TSCH queue module
  */
@@ -67,6 +67,77 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_INDEX
+/* The links of all slotframes, sorted by timeslot within each slotframe.
+ * Every slotframe owns a contiguous range of the index, in the order of
+ * slotframe_list. Links with the same timeslot are kept in the order they
+ * were added, which is the order in which the link lists are walked. */
+static struct tsch_link *link_index[TSCH_SCHEDULE_MAX_LINKS];
+static uint16_t num_indexed_links;
+/*---------------------------------------------------------------------------*/
+/* Returns the position, within the range of a slotframe, of its first link
+ * with a timeslot greater than (or equal to, if inclusive) a given one */
+static uint16_t
+index_search(const struct tsch_slotframe *sf, uint16_t timeslot, int inclusive)
+{
+  struct tsch_link **links = &link_index[sf->index_first];
+  uint16_t low = 0;
+  uint16_t high = sf->index_count;
+
+  while(low < high) {
+    uint16_t mid = (low + high) / 2;
+    if(links[mid]->timeslot < timeslot ||
+       (!inclusive && links[mid]->timeslot == timeslot)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+/*---------------------------------------------------------------------------*/
+/* Moves the range of all slotframes after sf by one position */
+static void
+index_shift(struct tsch_slotframe *sf, int delta)
+{
+  for(sf = list_item_next(sf); sf != NULL; sf = list_item_next(sf)) {
+    sf->index_first += delta;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_add(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t pos = sf->index_first + index_search(sf, l->timeslot, 0);
+
+  memmove(&link_index[pos + 1], &link_index[pos],
+          (num_indexed_links - pos) * sizeof(link_index[0]));
+  link_index[pos] = l;
+  num_indexed_links++;
+  sf->index_count++;
+  index_shift(sf, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_remove(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t pos = sf->index_first + index_search(sf, l->timeslot, 1);
+  uint16_t end = sf->index_first + sf->index_count;
+
+  while(pos < end && link_index[pos] != l) {
+    pos++;
+  }
+  if(pos == end) {
+    return;
+  }
+  num_indexed_links--;
+  memmove(&link_index[pos], &link_index[pos + 1],
+          (num_indexed_links - pos) * sizeof(link_index[0]));
+  sf->index_count--;
+  index_shift(sf, -1);
+}
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -87,6 +158,11 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       sf->handle = handle;
       TSCH_ASN_DIVISOR_INIT(sf->size, size);
       LIST_STRUCT_INIT(sf, links_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+      /* The slotframe goes last, and so does its range */
+      sf->index_first = num_indexed_links;
+      sf->index_count = 0;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
     }
@@ -253,6 +329,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+#if TSCH_SCHEDULE_WITH_INDEX
+        index_add(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 
         LOG_INFO("add_link sf=%u opt=%s type=%s ts=%u ch=%u addr=",
                  slotframe->handle,
@@ -305,6 +384,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
       LOG_INFO_LLADDR(&l->addr);
       LOG_INFO_("\n");
 
+#if TSCH_SCHEDULE_WITH_INDEX
+      index_remove(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       list_remove(slotframe->links_list, l);
       memb_free(&link_memb, l);
 
@@ -319,6 +401,8 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
           if(!(link_options & LINK_OPTION_SHARED)) {
             n->dedicated_tx_links_count--;
           }
+          /* Without Tx links, the neighbor is served in shared slots */
+          tsch_queue_update_ready_list(n);
         }
       }
 
@@ -346,6 +430,17 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe,
 {
   if(!tsch_is_locked()) {
     if(slotframe != NULL) {
+#if TSCH_SCHEDULE_WITH_INDEX
+      uint16_t i = index_search(slotframe, timeslot, 1);
+      struct tsch_link **links = &link_index[slotframe->index_first];
+      /* Loop over the links at this timeslot only */
+      for(; i < slotframe->index_count && links[i]->timeslot == timeslot; i++) {
+        if(links[i]->channel_offset == channel_offset) {
+          return links[i];
+        }
+      }
+      return NULL;
+#else /* TSCH_SCHEDULE_WITH_INDEX */
       struct tsch_link *l = list_head(slotframe->links_list);
       /* Loop over all items. Assume there is max one link per timeslot */
       while(l != NULL) {
@@ -355,6 +450,7 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe,
         l = list_item_next(l);
       }
       return l;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
     }
   }
   return NULL;
@@ -382,85 +478,120 @@ default_tsch_link_comparator(struct tsch_link *a, struct tsch_link *b)
   return a;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Candidate for the next active link, as the links are walked */
+struct link_selection {
+  uint16_t time_to_best;
+  struct tsch_link *best;
+  struct tsch_link *backup; /* Keep a back link in case the current link
+  turns out useless when the time comes. For instance, for a Tx-only link, if there is
+  no outgoing packet in queue. In that case, run the backup link instead. The backup link
+  must have Rx flag set. */
+};
+/*---------------------------------------------------------------------------*/
+/* Considers a link occurring in time_to_timeslot slots as next active link */
+static void
+select_link(struct link_selection *sel, struct tsch_link *l, uint16_t time_to_timeslot)
+{
+  struct tsch_link *curr_best = sel->best;
+
+  if(curr_best == NULL || time_to_timeslot < sel->time_to_best) {
+    sel->time_to_best = time_to_timeslot;
+    sel->best = l;
+    sel->backup = NULL;
+  } else if(time_to_timeslot == sel->time_to_best) {
+    struct tsch_link *new_best = NULL;
+    /* Two links are overlapping, we need to select one of them.
+     * By standard: prioritize Tx links first, second by lowest handle */
+    if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+      /* Both or neither links have Tx, select the one with lowest handle */
+      if(l->slotframe_handle != curr_best->slotframe_handle) {
+        if(l->slotframe_handle < curr_best->slotframe_handle) {
+          new_best = l;
+        }
+      } else {
+        /* compare the link against the current best link and return the newly selected one */
+        new_best = TSCH_LINK_COMPARATOR(curr_best, l);
+      }
+    } else {
+      /* Select the link that has the Tx option */
+      if(l->link_options & LINK_OPTION_TX) {
+        new_best = l;
+      }
+    }
+
+    /* Maintain backup_link */
+    if(sel->backup == NULL) {
+      /* Check if 'l' best can be used as backup */
+      if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+        sel->backup = l;
+      }
+      /* Check if curr_best can be used as backup */
+      if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+        sel->backup = curr_best;
+      }
+    }
+
+    /* Maintain curr_best */
+    if(new_best != NULL) {
+      sel->best = new_best;
+    }
+  }
+}
 /*---------------------------------------------------------------------------*/
 /* Returns the next active link after a given ASN, and a backup link (for the same ASN, with Rx flag) */
 struct tsch_link *
 tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset,
     struct tsch_link **backup_link)
 {
-  uint16_t time_to_curr_best = 0;
-  struct tsch_link *curr_best = NULL;
-  struct tsch_link *curr_backup = NULL; /* Keep a back link in case the current link
-  turns out useless when the time comes. For instance, for a Tx-only link, if there is
-  no outgoing packet in queue. In that case, run the backup link instead. The backup link
-  must have Rx flag set. */
+  struct link_selection sel = { 0, NULL, NULL };
+
   if(!tsch_is_locked()) {
     struct tsch_slotframe *sf = list_head(slotframe_list);
     /* For each slotframe, look for the earliest occurring link */
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_WITH_INDEX
+      /* Only the links at the first timeslot after the current one, or at
+       * the first timeslot of the slotframe when wrapping around, can be
+       * selected. They are considered in the order of the link list. */
+      if(sf->index_count > 0) {
+        struct tsch_link **links = &link_index[sf->index_first];
+        uint16_t i = index_search(sf, timeslot, 0);
+        uint16_t next_timeslot;
+        if(i == sf->index_count) {
+          i = 0;
+        }
+        next_timeslot = links[i]->timeslot;
+        for(; i < sf->index_count && links[i]->timeslot == next_timeslot; i++) {
+          select_link(&sel, links[i],
+                      next_timeslot > timeslot ?
+                      next_timeslot - timeslot :
+                      sf->size.val + next_timeslot - timeslot);
+        }
+      }
+#else /* TSCH_SCHEDULE_WITH_INDEX */
       struct tsch_link *l = list_head(sf->links_list);
       while(l != NULL) {
         uint16_t time_to_timeslot =
           l->timeslot > timeslot ?
           l->timeslot - timeslot :
           sf->size.val + l->timeslot - timeslot;
-        if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
-          time_to_curr_best = time_to_timeslot;
-          curr_best = l;
-          curr_backup = NULL;
-        } else if(time_to_timeslot == time_to_curr_best) {
-          struct tsch_link *new_best = NULL;
-          /* Two links are overlapping, we need to select one of them.
-           * By standard: prioritize Tx links first, second by lowest handle */
-          if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
-            /* Both or neither links have Tx, select the one with lowest handle */
-            if(l->slotframe_handle != curr_best->slotframe_handle) {
-              if(l->slotframe_handle < curr_best->slotframe_handle) {
-                new_best = l;
-              }
-            } else {
-              /* compare the link against the current best link and return the newly selected one */
-              new_best = TSCH_LINK_COMPARATOR(curr_best, l);
-            }
-          } else {
-            /* Select the link that has the Tx option */
-            if(l->link_options & LINK_OPTION_TX) {
-              new_best = l;
-            }
-          }
-
-          /* Maintain backup_link */
-          if(curr_backup == NULL) {
-            /* Check if 'l' best can be used as backup */
-            if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-              curr_backup = l;
-            }
-            /* Check if curr_best can be used as backup */
-            if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-              curr_backup = curr_best;
-            }
-          }
-
-          /* Maintain curr_best */
-          if(new_best != NULL) {
-            curr_best = new_best;
-          }
-        }
-
+        select_link(&sel, l, time_to_timeslot);
         l = list_item_next(l);
       }
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       sf = list_item_next(sf);
     }
     if(time_offset != NULL) {
-      *time_offset = time_to_curr_best;
+      *time_offset = sel.time_to_best;
     }
   }
   if(backup_link != NULL) {
-    *backup_link = curr_backup;
+    *backup_link = sel.backup;
   }
-  return curr_best;
+  return sel.best;
 }
 /*---------------------------------------------------------------------------*/
 /* Module initialization, call only once at startup. Returns 1 is success, 0 if failure. */
@@ -471,6 +602,9 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+    num_indexed_links = 0;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
     tsch_release_lock();
     return 1;
   } else {
@@ -45,6 +45,7 @@
 /********** Includes **********/
 
 #include "net/mac/tsch/tsch-asn.h"
+#include "net/mac/tsch/tsch-conf.h"
 #include "lib/list.h"
 #include "lib/ringbufindex.h"
 
@@ -91,6 +92,11 @@ struct tsch_slotframe {
   struct tsch_asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+  /* Range of the schedule index holding the links of this slotframe */
+  uint16_t index_first;
+  uint16_t index_count;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 };
 
 /** \brief TSCH packet information */
@@ -122,6 +128,11 @@ struct tsch_neighbor {
   struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PER_NEIGHBOR];
   /* Circular buffer of pointers to packet. */
   struct ringbufindex tx_ringbuf;
+#if TSCH_QUEUE_WITH_READY_LIST
+  /* Next neighbor in the list of neighbors ready for shared slots */
+  struct tsch_neighbor *ready_next;
+  uint8_t is_ready_listed; /* is this neighbor in the ready list? */
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
 };
 
 /** \brief TSCH timeslot timing elements. Used to index timeslot timing
@@ -156,7 +156,8 @@ int32_t max_drift_seen;
 PT_THREAD(tsch_scan(struct pt *pt));
 PROCESS(tsch_process, "main process");
 PROCESS(tsch_send_eb_process, "send EB process");
-PROCESS(tsch_pending_events_process, "pending events process");
+PROCESS_PRIO(tsch_pending_events_process, "pending events process",
+             PROCESS_PRIO_HIGH);
 
 /* Other function prototypes */
 static void packet_input(void);
@@ -83,6 +83,13 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_HASH
+/* Open-addressing hash index over the link-layer addresses in
+ * nbr_table_keys, with linear probing. Each slot holds the index of a
+ * neighbor plus one, or zero if the slot is empty. */
+static uint16_t hash_index[NBR_TABLE_HASH_SIZE];
+#endif /* NBR_TABLE_WITH_HASH */
+
 /*---------------------------------------------------------------------------*/
 /* Get a key from a neighbor index */
 static nbr_table_key_t *
@@ -125,17 +132,89 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
 {
   return key_from_index(index_from_item(table, item));
 }
+#if NBR_TABLE_WITH_HASH
+/*---------------------------------------------------------------------------*/
+/* Get the home slot of a link-layer address in the hash index */
+static unsigned
+hash_slot(const linkaddr_t *lladdr)
+{
+  unsigned h = 0;
+  int i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h = h * 31 + lladdr->u8[i];
+  }
+  return h % NBR_TABLE_HASH_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+/* Add the neighbor at a given index to the hash index */
+static void
+hash_add(int index)
+{
+  unsigned slot = hash_slot(&key_from_index(index)->lladdr);
+
+  while(hash_index[slot] != 0) {
+    slot = (slot + 1) % NBR_TABLE_HASH_SIZE;
+  }
+  hash_index[slot] = index + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove the neighbor at a given index from the hash index */
+static void
+hash_remove(int index)
+{
+  unsigned i, j, home;
+
+  i = hash_slot(&key_from_index(index)->lladdr);
+  while(hash_index[i] != index + 1) {
+    if(hash_index[i] == 0) {
+      return;
+    }
+    i = (i + 1) % NBR_TABLE_HASH_SIZE;
+  }
+
+  /* Shift back the entries that follow in the same probe sequence, so
+   * that lookups never need to skip over deleted slots */
+  j = i;
+  while(1) {
+    j = (j + 1) % NBR_TABLE_HASH_SIZE;
+    if(hash_index[j] == 0) {
+      break;
+    }
+    home = hash_slot(&key_from_index(hash_index[j] - 1)->lladdr);
+    /* The entry at j can move to i unless its home slot lies
+     * cyclically within (i, j] */
+    if((i < j) ? (home <= i || home > j) : (home <= i && home > j)) {
+      hash_index[i] = hash_index[j];
+      i = j;
+    }
+  }
+  hash_index[i] = 0;
+}
+#endif /* NBR_TABLE_WITH_HASH */
 /*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
   nbr_table_key_t *key;
+#if NBR_TABLE_WITH_HASH
+  unsigned slot;
+#endif /* NBR_TABLE_WITH_HASH */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_HASH
+  for(slot = hash_slot(lladdr); hash_index[slot] != 0;
+      slot = (slot + 1) % NBR_TABLE_HASH_SIZE) {
+    key = key_from_index(hash_index[slot] - 1);
+    if(linkaddr_cmp(lladdr, &key->lladdr)) {
+      return hash_index[slot] - 1;
+    }
+  }
+#else /* NBR_TABLE_WITH_HASH */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -143,6 +222,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     }
     key = list_item_next(key);
   }
+#endif /* NBR_TABLE_WITH_HASH */
   return -1;
 }
 /*---------------------------------------------------------------------------*/
@@ -193,6 +273,9 @@ remove_key(nbr_table_key_t *least_used_key)
   }
   /* Empty used map */
   used_map[index_from_key(least_used_key)] = 0;
+#if NBR_TABLE_WITH_HASH
+  hash_remove(index_from_key(least_used_key));
+#endif /* NBR_TABLE_WITH_HASH */
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, least_used_key);
 }
@@ -381,6 +464,9 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr, nbr_table_rea
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_WITH_HASH
+    hash_add(index);
+#endif /* NBR_TABLE_WITH_HASH */
   }
 
   /* Get item in the current table */
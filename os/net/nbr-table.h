@@ -46,6 +46,21 @@
 #define NBR_TABLE_MAX_NEIGHBORS 8
 #endif /* NBR_TABLE_CONF_MAX_NEIGHBORS */
 
+/* Keep a hash index of the link-layer addresses, so that looking up a
+ * neighbor does not require a walk over all neighbors */
+#ifdef NBR_TABLE_CONF_WITH_HASH
+#define NBR_TABLE_WITH_HASH NBR_TABLE_CONF_WITH_HASH
+#else /* NBR_TABLE_CONF_WITH_HASH */
+#define NBR_TABLE_WITH_HASH 0
+#endif /* NBR_TABLE_CONF_WITH_HASH */
+
+/* Number of slots of the hash index, at least NBR_TABLE_MAX_NEIGHBORS + 1 */
+#ifdef NBR_TABLE_CONF_HASH_SIZE
+#define NBR_TABLE_HASH_SIZE NBR_TABLE_CONF_HASH_SIZE
+#else /* NBR_TABLE_CONF_HASH_SIZE */
+#define NBR_TABLE_HASH_SIZE (2 * NBR_TABLE_MAX_NEIGHBORS)
+#endif /* NBR_TABLE_CONF_HASH_SIZE */
+
 /* An item in a neighbor table */
 typedef void nbr_table_item_t;
 
@@ -51,6 +51,7 @@
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uip-nd6.h"
 #include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-sr.h"
 #include "net/nbr-table.h"
 #include "net/ipv6/multicast/uip-mcast6.h"
 #include "lib/list.h"
@@ -674,6 +675,10 @@ rpl_free_dag(rpl_dag_t *dag)
     if(RPL_IS_STORING(dag->instance)) {
       rpl_remove_routes(dag);
     }
+#if UIP_SR_WITH_CACHE
+    /* Forget the source routes built for this DAG */
+    uip_sr_cache_flush();
+#endif /* UIP_SR_WITH_CACHE */
     /* Stop the DAO retransmit timer */
 #if RPL_WITH_DAO_ACK
     ctimer_stop(&dag->instance->dao_retransmit_timer);
@@ -68,8 +68,13 @@ rpl_ext_header_srh_get_next_hop(uip_ipaddr_t *ipaddr)
     return 0;
   }
 
-  root_node = uip_sr_get_node(NULL, &curr_instance.dag.dag_id);
-  dest_node = uip_sr_get_node(NULL, &UIP_IP_BUF->destipaddr);
+  /* The graph is only looked up when there is no SRH */
+  if(rh_header != NULL && rh_header->routing_type == RPL_RH_TYPE_SRH) {
+    root_node = dest_node = NULL;
+  } else {
+    root_node = uip_sr_get_node(NULL, &curr_instance.dag.dag_id);
+    dest_node = uip_sr_get_node(NULL, &UIP_IP_BUF->destipaddr);
+  }
 
   if((rh_header != NULL && rh_header->routing_type == RPL_RH_TYPE_SRH) ||
      (dest_node != NULL && root_node != NULL &&
@@ -184,6 +189,9 @@ insert_srh_header(void)
   uip_sr_node_t *root_node;
   uip_sr_node_t *node;
   uip_ipaddr_t node_addr;
+#if UIP_SR_WITH_CACHE
+  const uip_sr_cache_entry_t *entry;
+#endif /* UIP_SR_WITH_CACHE */
 
   /* Always insest SRH as first extension header */
   struct uip_routing_hdr *rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
@@ -203,6 +211,13 @@ insert_srh_header(void)
     return 1;
   }
 
+#if UIP_SR_WITH_CACHE
+  entry = uip_sr_cache_lookup(NULL, &UIP_IP_BUF->destipaddr);
+  if(entry != NULL) {
+    return uip_sr_cache_insert_hdr(entry);
+  }
+#endif /* UIP_SR_WITH_CACHE */
+
   dest_node = uip_sr_get_node(NULL, &UIP_IP_BUF->destipaddr);
   if(dest_node == NULL) {
     /* The destination is not found, skip SRH insertion */
@@ -298,6 +313,10 @@ insert_srh_header(void)
 
   /* The next hop (i.e. node whose parent is the root) is placed as the current IPv6 destination */
   NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+#if UIP_SR_WITH_CACHE
+  uip_sr_cache_add(NULL, &UIP_IP_BUF->destipaddr, &node_addr,
+                   (const uint8_t *)rh_hdr, ext_len);
+#endif /* UIP_SR_WITH_CACHE */
   uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
 
   /* Update the IPv6 length field */
@@ -445,14 +445,14 @@ lwm2m_engine_set_rd_data(lwm2m_buffer_t *outbuf, int block)
       len = snprintf((char *) &lwm2m_buf.buffer[pos],
                      lwm2m_buf.size - pos, (pos > 0 || block > 0) ? ",</%d/%d>" : "</%d/%d>",
                      instance->object_id, instance->instance_id);
-      LOG_DBG_((pos > 0 || block > 0) ? ",</%d/%d>" : "</%d/%d>",
+      LOG_DBG_("%s</%d/%d>", (pos > 0 || block > 0) ? "," : "",
                instance->object_id, instance->instance_id);
     } else if(object->impl != NULL) {
       len = snprintf((char *) &lwm2m_buf.buffer[pos],
                      lwm2m_buf.size - pos,
                      (pos > 0 || block > 0) ? ",</%d>" : "</%d>",
                      object->impl->object_id);
-      LOG_DBG_((pos > 0 || block > 0) ? ",</%d>" : "</%d>",
+      LOG_DBG_("%s</%d>", (pos > 0 || block > 0) ? "," : "",
                object->impl->object_id);
     } else {
       len = 0;
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         SLIP framing for the native border router
+ */
+
+#include "slip-codec.h"
+
+#include <string.h>
+
+/*---------------------------------------------------------------------------*/
+void
+slip_decoder_init(struct slip_decoder *d, uint8_t *buf, int size)
+{
+  d->buf = buf;
+  d->size = size;
+  d->len = 0;
+  d->esc = 0;
+  d->drop = 0;
+  d->dropped = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+append(struct slip_decoder *d, const uint8_t *data, int len)
+{
+  if(d->drop) {
+    return;
+  }
+  if(d->len + len > d->size) {
+    d->drop = 1;
+    d->dropped++;
+    d->len = 0;
+    return;
+  }
+  memcpy(d->buf + d->len, data, len);
+  d->len += len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+append_escaped(struct slip_decoder *d, uint8_t c)
+{
+  if(c == SLIP_ESC_END) {
+    c = SLIP_END;
+  } else if(c == SLIP_ESC_ESC) {
+    c = SLIP_ESC;
+  }
+  append(d, &c, 1);
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_decode(struct slip_decoder *d, const uint8_t *data, int len,
+            slip_frame_callback_t frame)
+{
+  const uint8_t *end = data + len;
+  const uint8_t *stop, *run_end, *esc;
+
+  if(len > 0 && d->esc) {
+    d->esc = 0;
+    append_escaped(d, *data++);
+  }
+
+  while(data < end) {
+    stop = memchr(data, SLIP_END, end - data);
+    run_end = stop != NULL ? stop : end;
+
+    if(d->len == 0 && !d->drop && stop != NULL &&
+       memchr(data, SLIP_ESC, stop - data) == NULL) {
+      /* A whole frame without escapes: no need to copy it */
+      if(stop > data) {
+        frame(data, stop - data);
+      }
+      data = stop + 1;
+      continue;
+    }
+
+    while(data < run_end) {
+      esc = memchr(data, SLIP_ESC, run_end - data);
+      append(d, data, (esc != NULL ? esc : run_end) - data);
+      if(esc == NULL) {
+        data = run_end;
+        break;
+      }
+      if(esc + 1 == end) {
+        d->esc = 1;
+        return;
+      }
+      /* An escaped SLIP_END is data, as it was before */
+      append_escaped(d, esc[1]);
+      data = esc + 2;
+    }
+
+    if(data == stop) {
+      if(d->len > 0 && !d->drop) {
+        frame(d->buf, d->len);
+      }
+      d->len = 0;
+      d->drop = 0;
+      data++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+slip_encode(uint8_t *dst, int size, const uint8_t *data, int len)
+{
+  const uint8_t *end = data + len;
+  const uint8_t *next_end, *next_esc, *special;
+  uint8_t *out = dst;
+  uint8_t *out_end = dst + size;
+  int run;
+
+  /* Track the next occurrence of each special byte, so that no part of
+     the frame is searched twice for the same one */
+  next_end = memchr(data, SLIP_END, len);
+  next_esc = memchr(data, SLIP_ESC, len);
+
+  for(;;) {
+    special = end;
+    if(next_end != NULL && next_end < special) {
+      special = next_end;
+    }
+    if(next_esc != NULL && next_esc < special) {
+      special = next_esc;
+    }
+
+    run = special - data;
+    if(run >= out_end - out) {
+      /* Not even room for the SLIP_END after the run */
+      return -1;
+    }
+    memcpy(out, data, run);
+    out += run;
+    if(special == end) {
+      break;
+    }
+
+    if(out_end - out < 2) {
+      return -1;
+    }
+    *out++ = SLIP_ESC;
+    if(special == next_end) {
+      *out++ = SLIP_ESC_END;
+      next_end = memchr(special + 1, SLIP_END, end - special - 1);
+    } else {
+      *out++ = SLIP_ESC_ESC;
+      next_esc = memchr(special + 1, SLIP_ESC, end - special - 1);
+    }
+    data = special + 1;
+  }
+
+  *out++ = SLIP_END;
+  return out - dst;
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         SLIP framing for the native border router. Decodes and
+ *         encodes whole buffers at a time: runs of bytes that need no
+ *         escaping are located with memchr() and moved with memcpy().
+ */
+
+#ifndef SLIP_CODEC_H_
+#define SLIP_CODEC_H_
+
+#include <stdint.h>
+
+#define SLIP_END     0300
+#define SLIP_ESC     0333
+#define SLIP_ESC_END 0334
+#define SLIP_ESC_ESC 0335
+
+/** Called by slip_decode() for each complete, non-empty frame */
+typedef void (*slip_frame_callback_t)(const uint8_t *data, int len);
+
+/** Decoder state, kept across calls to slip_decode() */
+struct slip_decoder {
+  uint8_t *buf;       /**< Holds a frame that spans several input buffers */
+  int size;
+  int len;            /**< Number of decoded bytes in buf */
+  uint8_t esc;        /**< The last input byte was SLIP_ESC */
+  uint8_t drop;       /**< Skip the rest of an oversized frame */
+  unsigned long dropped; /**< Number of frames too large for buf */
+};
+
+/**
+ * \brief Initialize a decoder
+ * \param d    The decoder
+ * \param buf  Buffer for frames that are not complete in one input buffer
+ * \param size The size of buf, which is the largest frame accepted
+ */
+void slip_decoder_init(struct slip_decoder *d, uint8_t *buf, int size);
+
+/**
+ * \brief Decode a buffer of SLIP encoded data
+ * \param d     The decoder
+ * \param data  The data, as read from the serial line
+ * \param len   The number of bytes in data
+ * \param frame Called for every frame completed by the data
+ *
+ * A frame that starts and ends within data and contains no escape
+ * sequence is handed to the callback in place, without being copied.
+ */
+void slip_decode(struct slip_decoder *d, const uint8_t *data, int len,
+                 slip_frame_callback_t frame);
+
+/**
+ * \brief SLIP encode a frame, terminated by SLIP_END
+ * \param dst  The destination buffer
+ * \param size The space available in dst
+ * \param data The frame
+ * \param len  The length of the frame
+ * \return     The number of bytes written to dst, or -1 if they did not fit
+ */
+int slip_encode(uint8_t *dst, int size, const uint8_t *data, int len);
+
+#endif /* SLIP_CODEC_H_ */
@@ -55,6 +55,7 @@
 #include "net/packetbuf.h"
 #include "cmd.h"
 #include "border-router-cmds.h"
+#include "slip-codec.h"
 
 extern int slip_config_verbose;
 extern int slip_config_flowcontrol;
@@ -72,8 +73,6 @@ extern speed_t slip_config_b_rate;
 
 int devopen(const char *dev, int flags);
 
-static FILE *inslip;
-
 /* for statistics */
 long slip_sent = 0;
 long slip_received = 0;
@@ -82,11 +81,6 @@ int slipfd = 0;
 
 #define PROGRESS(s) do { } while(0)
 
-#define SLIP_END     0300
-#define SLIP_ESC     0333
-#define SLIP_ESC_END 0334
-#define SLIP_ESC_ESC 0335
-
 /*---------------------------------------------------------------------------*/
 static void *
 get_in_addr(struct sockaddr *sa)
@@ -159,7 +153,7 @@ is_sensible_string(const unsigned char *s, int len)
 }
 /*---------------------------------------------------------------------------*/
 void
-slip_packet_input(unsigned char *data, int len)
+slip_packet_input(const unsigned char *data, int len)
 {
   packetbuf_copyfrom(data, len);
   if(slip_config_verbose > 0) {
@@ -168,123 +162,127 @@ slip_packet_input(unsigned char *data, int len)
   NETSTACK_MAC.input();
 }
 /*---------------------------------------------------------------------------*/
-/*
- * Read from serial, when we have a packet call slip_packet_input. No output
- * buffering, input buffered by stdio.
- */
-void
-serial_input(FILE *inslip)
+static void
+slip_frame_input(const uint8_t *inbuf, int inbufptr)
 {
-  static unsigned char inbuf[2048];
-  static int inbufptr = 0;
-  int ret, i;
-  unsigned char c;
-
-#ifdef linux
-  ret = fread(&c, 1, 1, inslip);
-  if(ret == -1 || ret == 0) {
-    err(1, "serial_input: read");
-  }
-  goto after_fread;
-#endif
+  int i;
 
-read_more:
-  if(inbufptr >= sizeof(inbuf)) {
-    fprintf(stderr, "*** dropping large %d byte packet\n", inbufptr);
-    inbufptr = 0;
-  }
-  ret = fread(&c, 1, 1, inslip);
-#ifdef linux
-after_fread:
-#endif
-  if(ret == -1) {
-    err(1, "serial_input: read");
-  }
-  if(ret == 0) {
-    clearerr(inslip);
-    return;
-  }
-  slip_received++;
-  switch(c) {
-  case SLIP_END:
-    if(inbufptr > 0) {
-      if(inbuf[0] == '!') {
-        command_context = CMD_CONTEXT_RADIO;
-        cmd_input(inbuf, inbufptr);
-      } else if(inbuf[0] == '?') {
+  if(inbuf[0] == '!') {
+    command_context = CMD_CONTEXT_RADIO;
+    cmd_input(inbuf, inbufptr);
+  } else if(inbuf[0] == '?') {
 #define DEBUG_LINE_MARKER '\r'
-      } else if(inbuf[0] == DEBUG_LINE_MARKER) {
-        fwrite(inbuf + 1, inbufptr - 1, 1, stdout);
-      } else if(is_sensible_string(inbuf, inbufptr)) {
-        if(slip_config_verbose == 1) {   /* strings already echoed below for verbose>1 */
-          fwrite(inbuf, inbufptr, 1, stdout);
-        }
-      } else {
-        if(slip_config_verbose > 2) {
-          printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
-          if(slip_config_verbose > 4) {
+  } else if(inbuf[0] == DEBUG_LINE_MARKER) {
+    fwrite(inbuf + 1, inbufptr - 1, 1, stdout);
+  } else if(is_sensible_string(inbuf, inbufptr)) {
+    if(slip_config_verbose == 1) {   /* strings already echoed below for verbose>1 */
+      fwrite(inbuf, inbufptr, 1, stdout);
+    }
+  } else {
+    if(slip_config_verbose > 2) {
+      printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
+      if(slip_config_verbose > 4) {
 #if WIRESHARK_IMPORT_FORMAT
-            printf("0000");
-            for(i = 0; i < inbufptr; i++) {
-              printf(" %02x", inbuf[i]);
-            }
+        printf("0000");
+        for(i = 0; i < inbufptr; i++) {
+          printf(" %02x", inbuf[i]);
+        }
 #else
-            printf("         ");
-            for(i = 0; i < inbufptr; i++) {
-              printf("%02x", inbuf[i]);
-              if((i & 3) == 3) {
-                printf(" ");
-              }
-              if((i & 15) == 15) {
-                printf("\n         ");
-              }
-            }
-#endif
-            printf("\n");
+        printf("         ");
+        for(i = 0; i < inbufptr; i++) {
+          printf("%02x", inbuf[i]);
+          if((i & 3) == 3) {
+            printf(" ");
+          }
+          if((i & 15) == 15) {
+            printf("\n         ");
           }
         }
-        slip_packet_input(inbuf, inbufptr);
+#endif
+        printf("\n");
       }
-      inbufptr = 0;
-    }
-    break;
-
-  case SLIP_ESC:
-    if(fread(&c, 1, 1, inslip) != 1) {
-      clearerr(inslip);
-      /* Put ESC back and give up! */
-      ungetc(SLIP_ESC, inslip);
-      return;
     }
+    slip_packet_input(inbuf, inbufptr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Echo lines as they are received for verbose=2,3,5+, and all printable
+ * characters for verbose==4. This needs to see every decoded byte, so
+ * the input is fed to the decoder one byte at a time.
+ */
+static void
+serial_echo_input(struct slip_decoder *d, const uint8_t *data, int len)
+{
+  unsigned char c;
+  int i, before;
 
-    switch(c) {
-    case SLIP_ESC_END:
-      c = SLIP_END;
-      break;
-    case SLIP_ESC_ESC:
-      c = SLIP_ESC;
-      break;
+  for(i = 0; i < len; i++) {
+    before = d->len;
+    slip_decode(d, &data[i], 1, slip_frame_input);
+    if(d->len != before + 1) {
+      continue;
     }
-    /* FALLTHROUGH */
-  default:
-    inbuf[inbufptr++] = c;
-
-    /* Echo lines as they are received for verbose=2,3,5+ */
-    /* Echo all printable characters for verbose==4 */
+    c = d->buf[d->len - 1];
     if(slip_config_verbose == 4) {
       if(c == 0 || c == '\r' || c == '\n' || c == '\t' || (c >= ' ' && c <= '~')) {
         fwrite(&c, 1, 1, stdout);
       }
-    } else if(slip_config_verbose >= 2) {
-      if(c == '\n' && is_sensible_string(inbuf, inbufptr)) {
-        fwrite(inbuf, inbufptr, 1, stdout);
-        inbufptr = 0;
-      }
+    } else if(c == '\n' && is_sensible_string(d->buf, d->len)) {
+      fwrite(d->buf, d->len, 1, stdout);
+      d->len = 0;
     }
-    break;
   }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Read from serial, when we have a packet call slip_packet_input. The
+ * input is read in chunks, and frames that arrive whole in a chunk are
+ * passed on without being copied.
+ */
+static void
+serial_input(void)
+{
+  static uint8_t inbuf[2048];
+  static struct slip_decoder decoder;
+  static uint8_t rxbuf[2048];
+  unsigned long dropped;
+  int ret;
+  int first = 1;
+
+  if(decoder.buf == NULL) {
+    slip_decoder_init(&decoder, inbuf, sizeof(inbuf));
+  }
+
+  for(;;) {
+    ret = read(slipfd, rxbuf, sizeof(rxbuf));
+    if(ret == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    if(ret == -1 || (ret == 0 && first)) {
+      /* Readable but nothing to read: the other end is gone */
+      err(1, "serial_input: read");
+    }
+    if(ret == 0) {
+      return;
+    }
+    first = 0;
+    slip_received += ret;
+
+    dropped = decoder.dropped;
+    if(slip_config_verbose >= 2) {
+      serial_echo_input(&decoder, rxbuf, ret);
+    } else {
+      slip_decode(&decoder, rxbuf, ret, slip_frame_input);
+    }
+    if(decoder.dropped != dropped) {
+      fprintf(stderr, "*** dropping large packet\n");
+    }
 
-  goto read_more;
+    if(ret < sizeof(rxbuf)) {
+      return;
+    }
+  }
 }
 unsigned char slip_buf[2048];
 int slip_end, slip_begin, slip_packet_end, slip_packet_count;
@@ -310,6 +308,23 @@ slip_send(int fd, unsigned char c)
   }
 }
 /*---------------------------------------------------------------------------*/
+static void
+slip_send_frame(int fd, const uint8_t *data, int len)
+{
+  int n;
+
+  n = slip_encode(slip_buf + slip_end, sizeof(slip_buf) - slip_end, data, len);
+  if(n < 0) {
+    err(1, "slip_send overflow");
+  }
+  slip_end += n;
+  slip_sent += n;
+  slip_packet_count++;
+  if(slip_packet_end == 0) {
+    slip_packet_end = slip_end;
+  }
+}
+/*---------------------------------------------------------------------------*/
 int
 slip_empty()
 {
@@ -342,12 +357,12 @@ slip_flushbuf(int fd)
       slip_end -= slip_packet_end;
       slip_begin = slip_packet_end = 0;
       if(slip_end > 0) {
+        unsigned char *end;
+
         /* Find end of next slip packet */
-        for(n = 1; n < slip_end; n++) {
-          if(slip_buf[n] == SLIP_END) {
-            slip_packet_end = n + 1;
-            break;
-          }
+        end = memchr(slip_buf + 1, SLIP_END, slip_end - 1);
+        if(end != NULL) {
+          slip_packet_end = end - slip_buf + 1;
         }
         /* a delay between slip packets to avoid losing data */
         if(send_delay > 0) {
@@ -397,22 +412,7 @@ write_to_serial(int outfd, const uint8_t *inbuf, int len)
    */
   /* slip_send(outfd, SLIP_END); */
 
-  for(i = 0; i < len; i++) {
-    switch(p[i]) {
-    case SLIP_END:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_END);
-      break;
-    case SLIP_ESC:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_ESC);
-      break;
-    default:
-      slip_send(outfd, p[i]);
-      break;
-    }
-  }
-  slip_send(outfd, SLIP_END);
+  slip_send_frame(outfd, p, len);
   PROGRESS("t");
 }
 /*---------------------------------------------------------------------------*/
@@ -489,6 +489,9 @@ set_fd(fd_set *rset, fd_set *wset)
   /* Anything to flush? */
   if(!slip_empty() && (send_delay == 0 || timer_expired(&send_delay_timer))) {
     FD_SET(slipfd, wset);
+  } else if(!slip_empty()) {
+    /* Wake up when the send delay is over */
+    select_set_timeout(timer_remaining(&send_delay_timer));
   }
 
   FD_SET(slipfd, rset);	/* Read from slip ASAP! */
@@ -499,7 +502,7 @@ static void
 handle_fd(fd_set *rset, fd_set *wset)
 {
   if(FD_ISSET(slipfd, rset)) {
-    serial_input(inslip);
+    serial_input();
   }
 
   if(FD_ISSET(slipfd, wset)) {
@@ -560,9 +563,5 @@ slip_init(void)
 
   timer_set(&send_delay_timer, 0);
   slip_send(slipfd, SLIP_END);
-  inslip = fdopen(slipfd, "r");
-  if(inslip == NULL) {
-    err(1, "slip_init: fdopen");
-  }
 }
 /*---------------------------------------------------------------------------*/
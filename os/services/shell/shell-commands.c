@@ -46,6 +46,7 @@
 #include "shell.h"
 #include "shell-commands.h"
 #include "lib/list.h"
+#include "lib/memb.h"
 #include "sys/log.h"
 #include "dev/watchdog.h"
 #include "net/ipv6/uip.h"
@@ -479,6 +480,24 @@ PT_THREAD(cmd_macaddr(struct pt *pt, shell_output_func output, char *args))
 
   PT_END(pt);
 }
+#if MEMB_WITH_STATS
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_memb_stats(struct pt *pt, shell_output_func output, char *args))
+{
+  struct memb *m;
+
+  PT_BEGIN(pt);
+
+  SHELL_OUTPUT(output, "Memory blocks:\n");
+  for(m = memb_stats_list(); m != NULL; m = m->next) {
+    SHELL_OUTPUT(output, "-- %s: size %u, used %u/%u, max %u, failures %u\n",
+                 m->name, m->size, m->count, m->num, m->max, m->failures);
+  }
+
+  PT_END(pt);
+}
+#endif /* MEMB_WITH_STATS */
 #if NETSTACK_CONF_WITH_IPV6
 /*---------------------------------------------------------------------------*/
 static
@@ -657,6 +676,12 @@ PT_THREAD(cmd_routes(struct pt *pt, shell_output_func output, char *args))
   } else {
     SHELL_OUTPUT(output, "No routing links\n");
   }
+#if UIP_SR_WITH_CACHE
+  SHELL_OUTPUT(output, "Source routing header cache: %lu hits, %lu misses, %lu flushes\n",
+               (unsigned long)uip_sr_cache_stats.hits,
+               (unsigned long)uip_sr_cache_stats.misses,
+               (unsigned long)uip_sr_cache_stats.flushes);
+#endif /* UIP_SR_WITH_CACHE */
 #endif /* UIP_CONF_IPV6_RPL */
 
 #if (UIP_MAX_ROUTES != 0)
@@ -981,6 +1006,9 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "reboot",               cmd_reboot,               "'> reboot': Reboot the board by watchdog_reboot()" },
   { "log",                  cmd_log,                  "'> log module level': Sets log level (0--4) for a given module (or \"all\"). For module \"mac\", level 4 also enables per-slot logging." },
   { "mac-addr",             cmd_macaddr,               "'> mac-addr': Shows the node's MAC address" },
+#if MEMB_WITH_STATS
+  { "memb-stats",           cmd_memb_stats,           "'> memb-stats': Shows the usage of the memory block pools" },
+#endif /* MEMB_WITH_STATS */
 #if NETSTACK_CONF_WITH_IPV6
   { "ip-addr",              cmd_ipaddr,               "'> ip-addr': Shows all IPv6 addresses" },
   { "ip-nbr",               cmd_ip_neighbors,         "'> ip-nbr': Shows all IPv6 neighbors" },
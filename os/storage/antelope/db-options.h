@@ -105,6 +105,19 @@
 #endif /* DB_MAX_ELEMENT_SIZE */
 
 
+/* The size of the buffer that rows are read ahead into when a relation
+   is scanned in sequence. Set to 0 to read one row at a time. */
+#ifndef DB_SCAN_BUFFER_SIZE
+#define DB_SCAN_BUFFER_SIZE		COFFEE_PAGE_SIZE
+#endif /* DB_SCAN_BUFFER_SIZE */
+
+/* The number of rows of the right relation that a hash join keeps in
+   its table at a time. Set to 0 to only use block nested-loop joins on
+   attributes without an index. */
+#ifndef DB_JOIN_HASH_SIZE
+#define DB_JOIN_HASH_SIZE		32
+#endif /* DB_JOIN_HASH_SIZE */
+
 /* The maximum size of the LVM bytecode compiled from a
    single database query. */
 #ifndef DB_VM_BYTECODE_SIZE
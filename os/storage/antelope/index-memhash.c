@@ -77,18 +77,7 @@ MEMB(hash_map_memb, hash_map_t, DB_MEMHASH_INDEX_LIMIT);
 static unsigned
 calculate_hash(attribute_value_t *value)
 {
-  unsigned char *cp, *end;
-  unsigned hash_value;
-
-  cp = (unsigned char *)value;
-  end = cp + sizeof(*value);
-  hash_value = 0;
-
-  while(cp < end) {
-    hash_value = hash_value * 33 + *cp++;
-  }
-
-  return hash_value % DB_MEMHASH_TABLE_SIZE;
+  return index_hash(value, sizeof(*value)) % DB_MEMHASH_TABLE_SIZE;
 }
 
 static db_result_t
@@ -342,6 +342,23 @@ index_exists(attribute_t *attr)
   return 1;
 }
 
+unsigned
+index_hash(const void *data, size_t size)
+{
+  const unsigned char *cp, *end;
+  unsigned hash_value;
+
+  cp = data;
+  end = cp + size;
+  hash_value = 0;
+
+  while(cp < end) {
+    hash_value = hash_value * 33 + *cp++;
+  }
+
+  return hash_value;
+}
+
 static index_t *
 get_next_index_to_load(void)
 {
@@ -108,6 +108,7 @@ db_result_t index_delete(index_t *, attribute_value_t *);
 db_result_t index_get_iterator(index_iterator_t *, index_t *,
                                attribute_value_t *, attribute_value_t *);
 tuple_id_t index_get_next(index_iterator_t *);
+unsigned index_hash(const void *, size_t);
 int index_exists(attribute_t *);
 
 #endif /* !INDEX_H */
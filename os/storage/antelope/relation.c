@@ -88,6 +88,34 @@ static unsigned char * const left_row = row;
 static unsigned char * const right_row = extra_row;
 static unsigned char * const join_row = result_row;
 
+/* Reads ahead when scanning the relation selected from, or the left
+   relation of a join. */
+static storage_cursor_t scan_cursor;
+
+#if DB_FEATURE_JOIN
+/*
+ * Joins on attributes that are not indexed compare the left relation
+ * with one block of the right relation at a time: either the rows that
+ * fit in the buffer of the join cursor, or the rows whose tuple IDs fit
+ * in a hash table on the join attribute.
+ */
+static storage_cursor_t join_cursor;
+static unsigned left_join_offset;
+static unsigned right_join_offset;
+
+#if DB_JOIN_HASH_SIZE > 0
+#define JOIN_HASH_END	0xffff
+
+struct join_hash_entry {
+  tuple_id_t tuple_id;
+  uint16_t next;
+};
+
+static uint16_t join_hash_buckets[DB_JOIN_HASH_SIZE];
+static struct join_hash_entry join_hash_table[DB_JOIN_HASH_SIZE];
+#endif /* DB_JOIN_HASH_SIZE > 0 */
+#endif /* DB_FEATURE_JOIN */
+
 LIST(relations);
 MEMB(relations_memb, relation_t, DB_RELATION_POOL_SIZE);
 MEMB(attributes_memb, attribute_t, DB_ATTRIBUTE_POOL_SIZE);
@@ -703,6 +731,7 @@ generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
     }
   }
 
+  storage_cursor_init(&scan_cursor, rel);
   handle->flags |= DB_HANDLE_FLAG_PROCESSING;
 
   return DB_OK;
@@ -771,12 +800,19 @@ relation_process_select(void *handle_ptr)
 
   /* Put the tuples fulfilling the given condition into a new relation.
      The tuples may be projected. */
-  result = storage_get_row(handle->rel, &handle->tuple_id, row);
+  if(handle->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
+    result = storage_get_row(handle->rel, &handle->tuple_id, row);
+  } else {
+    result = storage_cursor_get_row(&scan_cursor, handle->rel,
+                                    &handle->tuple_id, row);
+  }
   handle->tuple_id++;
   if(DB_ERROR(result)) {
     PRINTF("DB: Failed to get a row in relation %s!\n", handle->rel->name);
     return result;
   } else if(result == DB_FINISHED) {
+    PRINTF("DB: Scan hit the row cache %lu times in %lu reads\n",
+           scan_cursor.hits, scan_cursor.reads);
     if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
       goto end_aggregation;
     }
@@ -959,6 +995,190 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
 }
 
 #if DB_FEATURE_JOIN
+static db_result_t
+emit_join_row(db_handle_t *handle)
+{
+  relation_t *join_rel;
+  unsigned char *join_next_attribute_ptr;
+  size_t element_size;
+  int i;
+
+  join_rel = handle->join_rel;
+
+  /* Use the source attribute map to fill in the physical representation
+     of the resulting tuple. */
+  join_next_attribute_ptr = join_row;
+
+  for(i = 0; i < join_rel->attribute_count; i++) {
+    element_size = source_map[i].attr->element_size;
+
+    memcpy(join_next_attribute_ptr, source_map[i].from_ptr, element_size);
+    join_next_attribute_ptr += element_size;
+  }
+
+  if(((aql_adt_t *)handle->adt)->flags & AQL_FLAG_ASSIGN) {
+    if(DB_ERROR(storage_put_row(join_rel, join_row))) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+
+  handle->current_row++;
+  return DB_GOT_ROW;
+}
+
+#if DB_JOIN_HASH_SIZE > 0
+static unsigned
+join_hash(unsigned char *key, size_t key_size)
+{
+  return index_hash(key, key_size) % DB_JOIN_HASH_SIZE;
+}
+#endif /* DB_JOIN_HASH_SIZE > 0 */
+
+static db_result_t
+load_join_block(db_handle_t *handle)
+{
+  tuple_id_t tuple_id;
+  db_result_t result;
+#if DB_JOIN_HASH_SIZE > 0
+  unsigned i;
+  unsigned bucket;
+#endif
+
+  tuple_id = handle->block_start;
+  result = storage_cursor_get_row(&join_cursor, handle->right_rel,
+                                  &tuple_id, right_row);
+  if(result != DB_OK) {
+    return result;
+  }
+
+  if(handle->flags & DB_HANDLE_FLAG_BLOCK_JOIN) {
+    /* The block is what the cursor read ahead, or the single row if
+       the cursor could not buffer it. */
+    if(tuple_id - join_cursor.first_row < join_cursor.row_count) {
+      handle->block_end = join_cursor.first_row + join_cursor.row_count;
+    } else {
+      handle->block_end = tuple_id + 1;
+    }
+    return DB_OK;
+  }
+
+#if DB_JOIN_HASH_SIZE > 0
+  for(i = 0; i < DB_JOIN_HASH_SIZE; i++) {
+    join_hash_buckets[i] = JOIN_HASH_END;
+  }
+
+  for(i = 0; i < DB_JOIN_HASH_SIZE && result == DB_OK; i++) {
+    bucket = join_hash(right_row + right_join_offset,
+                       handle->right_join_attr->element_size);
+    join_hash_table[i].tuple_id = tuple_id;
+    join_hash_table[i].next = join_hash_buckets[bucket];
+    join_hash_buckets[bucket] = i;
+
+    tuple_id++;
+    if(i + 1 < DB_JOIN_HASH_SIZE) {
+      result = storage_cursor_get_row(&join_cursor, handle->right_rel,
+                                      &tuple_id, right_row);
+    }
+  }
+
+  if(DB_ERROR(result)) {
+    return result;
+  }
+  handle->block_end = tuple_id;
+#endif /* DB_JOIN_HASH_SIZE > 0 */
+
+  return DB_OK;
+}
+
+static db_result_t
+process_block_join(db_handle_t *handle)
+{
+  db_result_t result;
+  unsigned char *left_key;
+  size_t key_size;
+  tuple_id_t right_tuple_id;
+
+  left_key = left_row + left_join_offset;
+  key_size = handle->left_join_attr->element_size;
+
+  for(;;) {
+    if(handle->flags & DB_HANDLE_FLAG_BLOCK_STEP) {
+      result = load_join_block(handle);
+      if(result != DB_OK) {
+        return result;
+      }
+      PRINTF("DB: Joining with rows %lu to %lu of relation %s\n",
+             (unsigned long)handle->block_start,
+             (unsigned long)handle->block_end - 1, handle->right_rel->name);
+      handle->flags &= ~DB_HANDLE_FLAG_BLOCK_STEP;
+      handle->flags |= DB_HANDLE_FLAG_INDEX_STEP;
+      handle->tuple_id = 0;
+    }
+
+    if(handle->flags & DB_HANDLE_FLAG_INDEX_STEP) {
+      result = storage_cursor_get_row(&scan_cursor, handle->left_rel,
+                                      &handle->tuple_id, left_row);
+      if(DB_ERROR(result)) {
+        PRINTF("DB: Failed to get a row in left relation %s!\n",
+               handle->left_rel->name);
+        return result;
+      } else if(result == DB_FINISHED) {
+        /* All left rows have met this block; go on with the next one. */
+        handle->block_start = handle->block_end;
+        handle->flags |= DB_HANDLE_FLAG_BLOCK_STEP;
+        continue;
+      }
+      handle->tuple_id++;
+      handle->flags &= ~DB_HANDLE_FLAG_INDEX_STEP;
+
+      if(handle->flags & DB_HANDLE_FLAG_BLOCK_JOIN) {
+        handle->right_tuple_id = handle->block_start;
+      }
+#if DB_JOIN_HASH_SIZE > 0
+      else {
+        handle->right_tuple_id = join_hash_buckets[join_hash(left_key,
+                                                             key_size)];
+      }
+#endif
+    }
+
+    /* Compare the left row with the rows of the block that may match. */
+    for(;;) {
+      if(handle->flags & DB_HANDLE_FLAG_BLOCK_JOIN) {
+        if(handle->right_tuple_id >= handle->block_end) {
+          break;
+        }
+        right_tuple_id = handle->right_tuple_id++;
+      } else {
+#if DB_JOIN_HASH_SIZE > 0
+        if(handle->right_tuple_id == JOIN_HASH_END) {
+          break;
+        }
+        right_tuple_id = join_hash_table[handle->right_tuple_id].tuple_id;
+        handle->right_tuple_id = join_hash_table[handle->right_tuple_id].next;
+#else
+        break;
+#endif
+      }
+
+      result = storage_cursor_get_row(&join_cursor, handle->right_rel,
+                                      &right_tuple_id, right_row);
+      if(DB_ERROR(result)) {
+        PRINTF("DB: Failed to get a row in right relation %s!\n",
+               handle->right_rel->name);
+        return result;
+      } else if(result == DB_FINISHED) {
+        return DB_IMPLEMENTATION_ERROR;
+      }
+
+      if(memcmp(left_key, right_row + right_join_offset, key_size) == 0) {
+        return emit_join_row(handle);
+      }
+    }
+    handle->flags |= DB_HANDLE_FLAG_INDEX_STEP;
+  }
+}
+
 db_result_t
 relation_process_join(void *handle_ptr)
 {
@@ -966,17 +1186,16 @@ relation_process_join(void *handle_ptr)
   db_result_t result;
   relation_t *left_rel;
   relation_t *right_rel;
-  relation_t *join_rel;
-  unsigned char *join_next_attribute_ptr;
-  size_t element_size;
   tuple_id_t right_tuple_id;
   attribute_value_t value;
-  int i;
 
   handle = (db_handle_t *)handle_ptr;
   left_rel = handle->left_rel;
   right_rel = handle->right_rel;
-  join_rel = handle->join_rel;
+
+  if(handle->flags & (DB_HANDLE_FLAG_HASH_JOIN | DB_HANDLE_FLAG_BLOCK_JOIN)) {
+    return process_block_join(handle);
+  }
 
   if(!(handle->flags & DB_HANDLE_FLAG_INDEX_STEP)) {
     goto inner_loop;
@@ -985,7 +1204,8 @@ relation_process_join(void *handle_ptr)
   /* Equi-join for indexed attributes only. In the outer loop, we iterate over
      each tuple in the left relation. */
   for(handle->tuple_id = 0;; handle->tuple_id++) {
-    result = storage_get_row(left_rel, &handle->tuple_id, left_row);
+    result = storage_cursor_get_row(&scan_cursor, left_rel,
+                                    &handle->tuple_id, left_row);
     if(DB_ERROR(result)) {
       PRINTF("DB: Failed to get a row in left relation %s!\n", left_rel->name);
       return result;
@@ -1030,25 +1250,7 @@ inner_loop:
         return DB_IMPLEMENTATION_ERROR;
       }
 
-      /* Use the source attribute map to fill in the physical representation
-	 of the resulting tuple. */
-      join_next_attribute_ptr = join_row;
-
-      for(i = 0; i < join_rel->attribute_count; i++) {
-	element_size = source_map[i].attr->element_size;
-
-	memcpy(join_next_attribute_ptr, source_map[i].from_ptr, element_size);
-	join_next_attribute_ptr += element_size;
-      }
-
-      if(((aql_adt_t *)handle->adt)->flags & AQL_FLAG_ASSIGN) {
-        if(DB_ERROR(storage_put_row(join_rel, join_row))) {
-          return DB_STORAGE_ERROR;
-        }
-      }
-
-      handle->current_row++;
-      return DB_GOT_ROW;
+      return emit_join_row(handle);
     }
   }
 
@@ -1102,11 +1304,55 @@ generate_join_result(db_handle_t *handle)
     source_pair->from_ptr = from_ptr;
   }
 
+  storage_cursor_init(&scan_cursor, left_rel);
+  storage_cursor_init(&join_cursor, right_rel);
   handle->flags |= DB_HANDLE_FLAG_PROCESSING;
 
   return DB_OK;
 }
 
+/*
+ * Choose how to join on an attribute that the right relation has no
+ * index for. Both methods read the right relation once and scan the
+ * left relation once per block of the right one. A hash join has
+ * larger blocks, but reads each matching right row again, which we
+ * count as one row per left row.
+ */
+static uint8_t
+choose_join_method(relation_t *left_rel, relation_t *right_rel)
+{
+#if DB_JOIN_HASH_SIZE > 0
+  tuple_id_t left_rows;
+  tuple_id_t right_rows;
+  tuple_id_t block_rows;
+  unsigned long block_cost;
+  unsigned long hash_cost;
+
+  left_rows = relation_cardinality(left_rel);
+  right_rows = relation_cardinality(right_rel);
+
+  block_rows = 1;
+  if(right_rel->row_length > 0 &&
+     right_rel->row_length <= DB_SCAN_BUFFER_SIZE) {
+    block_rows = DB_SCAN_BUFFER_SIZE / right_rel->row_length;
+  }
+
+  block_cost = (unsigned long)((right_rows + block_rows - 1) / block_rows) *
+    left_rows;
+  hash_cost = (unsigned long)((right_rows + DB_JOIN_HASH_SIZE - 1) /
+                              DB_JOIN_HASH_SIZE + 1) * left_rows;
+
+  PRINTF("DB: Join cost %lu with blocks, %lu with hashing\n",
+         block_cost, hash_cost);
+
+  if(hash_cost < block_cost) {
+    return DB_HANDLE_FLAG_HASH_JOIN;
+  }
+#endif /* DB_JOIN_HASH_SIZE > 0 */
+
+  return DB_HANDLE_FLAG_BLOCK_JOIN;
+}
+
 db_result_t
 relation_join(void *query_result, void *adt_ptr)
 {
@@ -1159,8 +1405,28 @@ relation_join(void *query_result, void *adt_ptr)
   }
 
   if(!index_exists(handle->right_join_attr)) {
-    PRINTF("DB: The attribute to join on is not indexed\n");
-    return DB_INDEX_ERROR;
+    if(handle->left_join_attr->domain != handle->right_join_attr->domain ||
+       handle->left_join_attr->element_size !=
+       handle->right_join_attr->element_size) {
+      PRINTF("DB: The attributes to join on have different types\n");
+      return DB_TYPE_ERROR;
+    }
+
+    i = get_attribute_value_offset(left_rel, handle->left_join_attr);
+    if(i < 0) {
+      return DB_IMPLEMENTATION_ERROR;
+    }
+    left_join_offset = i;
+
+    i = get_attribute_value_offset(right_rel, handle->right_join_attr);
+    if(i < 0) {
+      return DB_IMPLEMENTATION_ERROR;
+    }
+    right_join_offset = i;
+
+    handle->flags = DB_HANDLE_FLAG_BLOCK_STEP |
+      choose_join_method(left_rel, right_rel);
+    handle->block_start = 0;
   }
 
   /*
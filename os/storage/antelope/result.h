@@ -49,11 +49,17 @@ typedef unsigned char *tuple_t;
 #define DB_HANDLE_FLAG_INDEX_STEP	0x01
 #define DB_HANDLE_FLAG_SEARCH_INDEX	0x02
 #define DB_HANDLE_FLAG_PROCESSING	0x04
+#define DB_HANDLE_FLAG_HASH_JOIN	0x08
+#define DB_HANDLE_FLAG_BLOCK_JOIN	0x10
+#define DB_HANDLE_FLAG_BLOCK_STEP	0x20
 
 struct db_handle {
   index_iterator_t index_iterator;
   tuple_id_t tuple_id;
   tuple_id_t current_row;
+  tuple_id_t block_start;
+  tuple_id_t block_end;
+  tuple_id_t right_tuple_id;
   relation_t *rel;
   relation_t *left_rel;
   relation_t *join_rel;
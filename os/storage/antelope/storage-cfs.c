@@ -437,6 +437,83 @@ storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
   return DB_OK;
 }
 
+void
+storage_cursor_init(storage_cursor_t *cursor, relation_t *rel)
+{
+  cursor->rel = rel;
+  cursor->first_row = 0;
+  cursor->row_count = 0;
+  cursor->hits = 0;
+  cursor->reads = 0;
+}
+
+db_result_t
+storage_cursor_get_row(storage_cursor_t *cursor, relation_t *rel,
+                       tuple_id_t *tuple_id, storage_row_t row)
+{
+#if DB_SCAN_BUFFER_SIZE > 0
+  tuple_id_t nrows;
+  tuple_id_t batch;
+  unsigned char *ptr;
+  int r;
+
+  if(cursor->rel != rel) {
+    storage_cursor_init(cursor, rel);
+  }
+
+  if(rel->row_length == 0 || rel->row_length > sizeof(cursor->buf)) {
+    return storage_get_row(rel, tuple_id, row);
+  }
+
+  /* Rows are only ever appended, so the buffered ones stay valid. */
+  if(*tuple_id - cursor->first_row < cursor->row_count) {
+    cursor->hits++;
+  } else {
+    if(DB_ERROR(storage_get_row_amount(rel, &nrows))) {
+      return DB_STORAGE_ERROR;
+    }
+
+    if(*tuple_id >= nrows) {
+      return DB_FINISHED;
+    }
+
+    batch = sizeof(cursor->buf) / rel->row_length;
+    if(batch > nrows - *tuple_id) {
+      batch = nrows - *tuple_id;
+    }
+
+    if(cfs_seek(rel->tuple_storage, *tuple_id * rel->row_length,
+                CFS_SEEK_SET) == (cfs_offset_t)-1) {
+      return DB_STORAGE_ERROR;
+    }
+
+    r = cfs_read(rel->tuple_storage, cursor->buf, batch * rel->row_length);
+    if(r < 0) {
+      PRINTF("DB: Reading failed on fd %d\n", rel->tuple_storage);
+      return DB_STORAGE_ERROR;
+    } else if(r < rel->row_length) {
+      PRINTF("DB: Incomplete record: %d < %d\n", r, rel->row_length);
+      return DB_STORAGE_ERROR;
+    }
+
+    cursor->first_row = *tuple_id;
+    cursor->row_count = r / rel->row_length;
+    cursor->reads++;
+
+    PRINTF("DB: Read %lu rows from relation %s\n",
+           (unsigned long)cursor->row_count, rel->name);
+  }
+
+  ptr = cursor->buf + (*tuple_id - cursor->first_row) * rel->row_length;
+  memcpy(row, ptr, rel->row_length);
+  row[rel->row_length - 1] ^= ROW_XOR;
+
+  return DB_OK;
+#else
+  return storage_get_row(rel, tuple_id, row);
+#endif /* DB_SCAN_BUFFER_SIZE > 0 */
+}
+
 db_result_t
 storage_put_row(relation_t *rel, storage_row_t row)
 {
@@ -50,6 +50,22 @@
 
 typedef unsigned char * storage_row_t;
 
+/*
+ * A cursor reads the rows of a relation in batches that fill its
+ * buffer, and serves the following rows from the buffer. The hits
+ * counter tells how many rows were served without accessing storage.
+ */
+typedef struct storage_cursor {
+  relation_t *rel;
+  tuple_id_t first_row;
+  tuple_id_t row_count;
+  unsigned long hits;
+  unsigned long reads;
+#if DB_SCAN_BUFFER_SIZE > 0
+  unsigned char buf[DB_SCAN_BUFFER_SIZE];
+#endif
+} storage_cursor_t;
+
 char *storage_generate_file(char *, unsigned long);
 
 db_result_t storage_load(relation_t *);
@@ -68,6 +84,10 @@ db_result_t storage_get_row(relation_t *, tuple_id_t *, storage_row_t);
 db_result_t storage_put_row(relation_t *, storage_row_t);
 db_result_t storage_get_row_amount(relation_t *, tuple_id_t *);
 
+void storage_cursor_init(storage_cursor_t *, relation_t *);
+db_result_t storage_cursor_get_row(storage_cursor_t *, relation_t *,
+                                   tuple_id_t *, storage_row_t);
+
 db_storage_id_t storage_open(const char *);
 void storage_close(db_storage_id_t);
 db_result_t storage_read(db_storage_id_t, void *, unsigned long, unsigned);
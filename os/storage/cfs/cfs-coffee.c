@@ -84,6 +84,52 @@
 #define COFFEE_EXTENDED_WEAR_LEVELLING  1
 #endif
 
+/*
+ * Keep an index from file name hashes to file pages in RAM, so that
+ * finding a file takes a single header read instead of a scan of the
+ * storage. The index is built on first use and updated when files are
+ * reserved and removed. If there are more files than index entries,
+ * files that did not fit are found by scanning as before.
+ */
+#ifndef COFFEE_NAME_INDEX_SIZE
+#define COFFEE_NAME_INDEX_SIZE  0
+#endif
+
+/*
+ * Cache this many storage pages in RAM. Only reads smaller than a page
+ * go through the cache, which keeps file headers and log tables in it
+ * rather than bulk file data.
+ */
+#ifndef COFFEE_PAGE_CACHE_SIZE
+#define COFFEE_PAGE_CACHE_SIZE  0
+#endif
+
+/*
+ * Record in each file header how far into its extent the file has been
+ * written, in eighths, so that finding the end of a file after opening
+ * it only needs to search one eighth of the extent.
+ */
+#ifndef COFFEE_END_HINTS
+#define COFFEE_END_HINTS        0
+#endif
+
+/*
+ * Reclaim obsolete sectors in a background process, one sector per
+ * time it is scheduled, once fewer than COFFEE_GC_LOW_WATERMARK pages
+ * are estimated to be free. Sectors freed in the background are not
+ * handed out again until the allocator wraps around, which spreads
+ * erasures over the storage. The erase counts that are kept per sector
+ * are diagnostic only. Reserving a file still collects garbage
+ * synchronously if no space is left.
+ */
+#ifndef COFFEE_BACKGROUND_GC
+#define COFFEE_BACKGROUND_GC    0
+#endif
+
+#ifndef COFFEE_GC_LOW_WATERMARK
+#define COFFEE_GC_LOW_WATERMARK (COFFEE_PAGE_COUNT / 4)
+#endif
+
 #if COFFEE_START & (COFFEE_SECTOR_SIZE - 1)
 #error COFFEE_START must point to the first byte in a sector.
 #endif
@@ -97,6 +143,10 @@
 /* File object flags. */
 #define COFFEE_FILE_MODIFIED  0x1
 
+/* End hint bits. Bit n, for n from 1 to 7, is set once the file has
+   been written past n eighths of its extent. */
+#define END_HINT_IN_USE   0x01
+
 /* Internal Coffee markers. */
 #define INVALID_PAGE      ((coffee_page_t)-1)
 #define UNKNOWN_OFFSET    ((cfs_offset_t)-1)
@@ -160,6 +210,12 @@ struct sector_status {
   coffee_page_t free;
 };
 
+/* State carried between sectors while iterating over them in order. */
+struct sector_scan {
+  coffee_page_t skip_pages;
+  char last_pages_are_active;
+};
+
 /* The structure of cached file objects. */
 struct file {
   cfs_offset_t end;
@@ -168,6 +224,9 @@ struct file {
   int16_t record_count;
   uint8_t references;
   uint8_t flags;
+#if COFFEE_END_HINTS
+  uint8_t end_hint;
+#endif
 };
 
 /* The file descriptor structure. */
@@ -185,7 +244,7 @@ struct file_header {
   uint16_t log_records;
   uint16_t log_record_size;
   coffee_page_t max_pages;
-  uint8_t deprecated_eof_hint;
+  uint8_t eof_hint;
   uint8_t flags;
   char name[COFFEE_NAME_LENGTH];
 };
@@ -206,18 +265,141 @@ static struct file_desc coffee_fd_set[COFFEE_FD_SET_SIZE];
 static coffee_page_t next_free;
 static char gc_wait;
 
+#if COFFEE_BACKGROUND_GC
+PROCESS(coffee_gc_process, "Coffee GC");
+
+/* Erase counts since boot, for diagnostics only; they do not steer
+   the choice of sectors. */
+static uint16_t sector_erasures[COFFEE_SECTOR_COUNT];
+static uint16_t erasures;
+
+/* Estimated number of free pages, or INVALID_PAGE if unknown. */
+static coffee_page_t free_pages = INVALID_PAGE;
+/* Set when files have been removed since the last collection. */
+static char gc_pending = 1;
+
+static struct sector_scan gc_scan;
+static coffee_page_t gc_sector;
+static coffee_page_t gc_free;
+static uint16_t gc_erasures;
+#endif /* COFFEE_BACKGROUND_GC */
+
+#if COFFEE_PAGE_CACHE_SIZE > 0
+struct cached_page {
+  coffee_page_t page;
+  uint16_t last_used;
+  uint8_t valid;
+  uint8_t data[COFFEE_PAGE_SIZE];
+};
+
+static struct cached_page page_cache[COFFEE_PAGE_CACHE_SIZE];
+static uint16_t page_cache_clock;
+#endif /* COFFEE_PAGE_CACHE_SIZE > 0 */
+
+#if COFFEE_NAME_INDEX_SIZE > 0
+struct name_entry {
+  coffee_page_t page;
+  uint16_t hash;
+};
+
+#define NAME_INDEX_UNBUILT  0
+#define NAME_INDEX_COMPLETE 1
+#define NAME_INDEX_PARTIAL  2 /* Some files did not fit. */
+
+static struct name_entry name_index[COFFEE_NAME_INDEX_SIZE];
+static uint8_t name_index_state;
+#endif /* COFFEE_NAME_INDEX_SIZE > 0 */
+
+/*---------------------------------------------------------------------------*/
+#if COFFEE_PAGE_CACHE_SIZE > 0
+static void
+invalidate_pages(coffee_page_t first, coffee_page_t last)
+{
+  int i;
+
+  for(i = 0; i < COFFEE_PAGE_CACHE_SIZE; i++) {
+    if(page_cache[i].page >= first && page_cache[i].page <= last) {
+      page_cache[i].valid = 0;
+    }
+  }
+}
+#endif /* COFFEE_PAGE_CACHE_SIZE > 0 */
+/*---------------------------------------------------------------------------*/
+static void
+flash_read(void *buf, unsigned size, cfs_offset_t offset)
+{
+#if COFFEE_PAGE_CACHE_SIZE > 0
+  coffee_page_t page;
+  struct cached_page *entry, *victim;
+
+  page = offset / COFFEE_PAGE_SIZE;
+  if(size > 0 && size < COFFEE_PAGE_SIZE &&
+     (offset + size - 1) / COFFEE_PAGE_SIZE == page) {
+    victim = &page_cache[0];
+    for(entry = page_cache; entry < page_cache + COFFEE_PAGE_CACHE_SIZE;
+        entry++) {
+      if(entry->valid && entry->page == page) {
+        break;
+      }
+      if(victim->valid && (!entry->valid ||
+         (uint16_t)(page_cache_clock - entry->last_used) >
+         (uint16_t)(page_cache_clock - victim->last_used))) {
+        victim = entry;
+      }
+    }
+    if(entry == page_cache + COFFEE_PAGE_CACHE_SIZE) {
+      entry = victim;
+      COFFEE_READ(entry->data, COFFEE_PAGE_SIZE, page * COFFEE_PAGE_SIZE);
+      entry->page = page;
+      entry->valid = 1;
+    }
+    entry->last_used = ++page_cache_clock;
+    memcpy(buf, &entry->data[offset % COFFEE_PAGE_SIZE], size);
+    return;
+  }
+#endif /* COFFEE_PAGE_CACHE_SIZE > 0 */
+  COFFEE_READ(buf, size, offset);
+}
+/*---------------------------------------------------------------------------*/
+static void
+flash_write(const void *buf, unsigned size, cfs_offset_t offset)
+{
+  COFFEE_WRITE(buf, size, offset);
+#if COFFEE_PAGE_CACHE_SIZE > 0
+  /* What the storage holds after a write depends on what it held
+     before, so drop the cached copies rather than patching them. */
+  if(size > 0) {
+    invalidate_pages(offset / COFFEE_PAGE_SIZE,
+                     (offset + size - 1) / COFFEE_PAGE_SIZE);
+  }
+#endif /* COFFEE_PAGE_CACHE_SIZE > 0 */
+}
+/*---------------------------------------------------------------------------*/
+static void
+flash_erase(coffee_page_t sector)
+{
+  COFFEE_ERASE(sector);
+#if COFFEE_BACKGROUND_GC
+  sector_erasures[sector]++;
+  erasures++;
+#endif
+#if COFFEE_PAGE_CACHE_SIZE > 0
+  invalidate_pages(sector * COFFEE_PAGES_PER_SECTOR,
+                   (sector + 1) * COFFEE_PAGES_PER_SECTOR - 1);
+#endif /* COFFEE_PAGE_CACHE_SIZE > 0 */
+}
 /*---------------------------------------------------------------------------*/
 static void
 write_header(struct file_header *hdr, coffee_page_t page)
 {
   hdr->flags |= HDR_FLAG_VALID;
-  COFFEE_WRITE(hdr, sizeof(*hdr), page * COFFEE_PAGE_SIZE);
+  flash_write(hdr, sizeof(*hdr), page * COFFEE_PAGE_SIZE);
 }
 /*---------------------------------------------------------------------------*/
 static void
 read_header(struct file_header *hdr, coffee_page_t page)
 {
-  COFFEE_READ(hdr, sizeof(*hdr), page * COFFEE_PAGE_SIZE);
+  flash_read(hdr, sizeof(*hdr), page * COFFEE_PAGE_SIZE);
   if(DEBUG && HDR_ACTIVE(*hdr) && !HDR_VALID(*hdr)) {
     PRINTF("Coffee: Invalid header at page %u!\n", (unsigned)page);
   }
@@ -230,10 +412,9 @@ absolute_offset(coffee_page_t page, cfs_offset_t offset)
 }
 /*---------------------------------------------------------------------------*/
 static coffee_page_t
-get_sector_status(coffee_page_t sector, struct sector_status *stats)
+get_sector_status(struct sector_scan *scan, coffee_page_t sector,
+                  struct sector_status *stats)
 {
-  static coffee_page_t skip_pages;
-  static char last_pages_are_active;
   struct file_header hdr;
   coffee_page_t active, obsolete, free;
   coffee_page_t sector_start, sector_end;
@@ -243,13 +424,13 @@ get_sector_status(coffee_page_t sector, struct sector_status *stats)
   active = obsolete = free = 0;
 
   /*
-   * get_sector_status() is an iterative function using local static
-   * state. It therefore requires that the caller starts iterating from
-   * sector 0 in order to reset the internal state.
+   * get_sector_status() is an iterative function keeping its state in
+   * the scan structure. It therefore requires that the caller starts
+   * iterating from sector 0 in order to reset the state.
    */
   if(sector == 0) {
-    skip_pages = 0;
-    last_pages_are_active = 0;
+    scan->skip_pages = 0;
+    scan->last_pages_are_active = 0;
   }
 
   sector_start = sector * COFFEE_PAGES_PER_SECTOR;
@@ -260,29 +441,30 @@ get_sector_status(coffee_page_t sector, struct sector_status *stats)
    * segment that extends into this segment. If the whole segment is
    * covered, we do not need to continue counting pages in this iteration.
    */
-  if(last_pages_are_active) {
-    if(skip_pages >= COFFEE_PAGES_PER_SECTOR) {
+  if(scan->last_pages_are_active) {
+    if(scan->skip_pages >= COFFEE_PAGES_PER_SECTOR) {
       stats->active = COFFEE_PAGES_PER_SECTOR;
-      skip_pages -= COFFEE_PAGES_PER_SECTOR;
+      scan->skip_pages -= COFFEE_PAGES_PER_SECTOR;
       return 0;
     }
-    active = skip_pages;
+    active = scan->skip_pages;
   } else {
-    if(skip_pages >= COFFEE_PAGES_PER_SECTOR) {
+    if(scan->skip_pages >= COFFEE_PAGES_PER_SECTOR) {
       stats->obsolete = COFFEE_PAGES_PER_SECTOR;
-      skip_pages -= COFFEE_PAGES_PER_SECTOR;
-      return skip_pages >= COFFEE_PAGES_PER_SECTOR ? 0 : skip_pages;
+      scan->skip_pages -= COFFEE_PAGES_PER_SECTOR;
+      return scan->skip_pages >= COFFEE_PAGES_PER_SECTOR ?
+             0 : scan->skip_pages;
     }
-    obsolete = skip_pages;
+    obsolete = scan->skip_pages;
   }
 
   /* Determine the amount of pages of each type that have not been
      accounted for yet in the current sector. */
-  for(page = sector_start + skip_pages; page < sector_end;) {
+  for(page = sector_start + scan->skip_pages; page < sector_end;) {
     read_header(&hdr, page);
-    last_pages_are_active = 0;
+    scan->last_pages_are_active = 0;
     if(HDR_ACTIVE(hdr)) {
-      last_pages_are_active = 1;
+      scan->last_pages_are_active = 1;
       page += hdr.max_pages;
       active += hdr.max_pages;
     } else if(HDR_ISOLATED(hdr)) {
@@ -305,9 +487,9 @@ get_sector_status(coffee_page_t sector, struct sector_status *stats)
    * amount is that there is no need to read in the headers of each
    * of these pages from the storage.
    */
-  skip_pages = active + obsolete + free - COFFEE_PAGES_PER_SECTOR;
-  if(skip_pages > 0) {
-    if(last_pages_are_active) {
+  scan->skip_pages = active + obsolete + free - COFFEE_PAGES_PER_SECTOR;
+  if(scan->skip_pages > 0) {
+    if(scan->last_pages_are_active) {
       active = COFFEE_PAGES_PER_SECTOR - obsolete;
     } else {
       obsolete = COFFEE_PAGES_PER_SECTOR - active;
@@ -325,8 +507,8 @@ get_sector_status(coffee_page_t sector, struct sector_status *stats)
    * sector, however, the garbage collection can free the next sector
    * immediately without requiring page isolation.
    */
-  return (last_pages_are_active || (skip_pages >= COFFEE_PAGES_PER_SECTOR)) ?
-         0 : skip_pages;
+  return (scan->last_pages_are_active ||
+          scan->skip_pages >= COFFEE_PAGES_PER_SECTOR) ? 0 : scan->skip_pages;
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -352,6 +534,7 @@ static void
 collect_garbage(int mode)
 {
   coffee_page_t sector;
+  struct sector_scan scan;
   struct sector_status stats;
   coffee_page_t first_page, isolation_count;
 
@@ -362,7 +545,7 @@ collect_garbage(int mode)
    * erasable if there are only free or obsolete pages in it.
    */
   for(sector = 0; sector < COFFEE_SECTOR_COUNT; sector++) {
-    isolation_count = get_sector_status(sector, &stats);
+    isolation_count = get_sector_status(&scan, sector, &stats);
     PRINTF("Coffee: Sector %u has %u active, %u obsolete, and %u free pages.\n",
            (unsigned)sector, (unsigned)stats.active,
            (unsigned)stats.obsolete, (unsigned)stats.free);
@@ -382,7 +565,7 @@ collect_garbage(int mode)
         isolate_pages(first_page + COFFEE_PAGES_PER_SECTOR, isolation_count);
       }
 
-      COFFEE_ERASE(sector);
+      flash_erase(sector);
       PRINTF("Coffee: Erased sector %d!\n", sector);
 
       if(mode == GC_RELUCTANT && isolation_count > 0) {
@@ -390,8 +573,107 @@ collect_garbage(int mode)
       }
     }
   }
+#if COFFEE_BACKGROUND_GC
+  free_pages = INVALID_PAGE;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+#if COFFEE_BACKGROUND_GC
+/* Examine the next sector and erase it if it holds no active pages.
+   Returns 1 when all sectors have been examined. */
+static int
+collect_garbage_step(void)
+{
+  struct sector_status stats;
+  coffee_page_t isolation_count;
+
+  /* Erasures done elsewhere invalidate the state of the scan. */
+  if(gc_erasures != erasures) {
+    gc_sector = 0;
+  }
+  if(gc_sector == 0) {
+    gc_free = 0;
+  }
+
+  isolation_count = get_sector_status(&gc_scan, gc_sector, &stats);
+  if(stats.active == 0 && stats.obsolete > 0) {
+    if(isolation_count > 0) {
+      isolate_pages((gc_sector + 1) * COFFEE_PAGES_PER_SECTOR,
+                    isolation_count);
+    }
+    flash_erase(gc_sector);
+    PRINTF("Coffee: Erased sector %d in the background\n", gc_sector);
+    stats.free = COFFEE_PAGES_PER_SECTOR;
+  }
+  gc_free += stats.free;
+  gc_erasures = erasures;
+
+  if(++gc_sector < COFFEE_SECTOR_COUNT) {
+    return 0;
+  }
+  gc_sector = 0;
+  free_pages = gc_free;
+  return 1;
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Keep the state of a background scan in progress valid after a file
+ * has been reserved. The scan reads the header of a file reserved in a
+ * sector it has yet to examine, but a file starting in a sector that
+ * has been examined may extend into the next one.
+ */
+static void
+gc_reserved(coffee_page_t page, coffee_page_t pages)
+{
+  coffee_page_t scanned;
+  coffee_page_t taken;
+
+  scanned = gc_sector * COFFEE_PAGES_PER_SECTOR;
+  if(page >= scanned) {
+    return;
+  }
+
+  /* The pages were free when they were examined. */
+  taken = MIN(pages, scanned - page);
+  gc_free = gc_free > taken ? gc_free - taken : 0;
+
+  if(page + pages > scanned) {
+    gc_scan.skip_pages = page + pages - scanned;
+    gc_scan.last_pages_are_active = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+request_gc(void)
+{
+  if(!gc_pending ||
+     (free_pages != INVALID_PAGE && free_pages >= COFFEE_GC_LOW_WATERMARK)) {
+    return;
+  }
+  if(!process_is_running(&coffee_gc_process)) {
+    process_start(&coffee_gc_process, NULL);
+  }
+  process_poll(&coffee_gc_process);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_gc_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    gc_pending = 0;
+    while(!collect_garbage_step()) {
+      PROCESS_PAUSE();
+    }
+    PRINTF("Coffee: Background collection done, %d pages free\n",
+           (int)free_pages);
+  }
+
+  PROCESS_END();
+}
+#endif /* COFFEE_BACKGROUND_GC */
+/*---------------------------------------------------------------------------*/
 static coffee_page_t
 next_file(coffee_page_t page, struct file_header *hdr)
 {
@@ -448,16 +730,115 @@ load_file(coffee_page_t start, struct file_header *hdr)
   file->flags = HDR_MODIFIED(*hdr) ? COFFEE_FILE_MODIFIED : 0;
   /* We don't know the amount of records yet. */
   file->record_count = -1;
+#if COFFEE_END_HINTS
+  file->end_hint = hdr->eof_hint;
+#endif
 
   return file;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_NAME_INDEX_SIZE > 0
+static uint16_t
+name_hash(const char *name)
+{
+  uint16_t hash = 5381;
+  int i;
+
+  /* Only the part of the name that fits in a file header counts. */
+  for(i = 0; i < COFFEE_NAME_LENGTH - 1 && name[i] != '\0'; i++) {
+    hash = hash * 33 + (unsigned char)name[i];
+  }
+  return hash;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_add(coffee_page_t page, const char *name)
+{
+  int i;
+
+  for(i = 0; i < COFFEE_NAME_INDEX_SIZE; i++) {
+    if(name_index[i].page == INVALID_PAGE) {
+      name_index[i].page = page;
+      name_index[i].hash = name_hash(name);
+      return;
+    }
+  }
+  name_index_state = NAME_INDEX_PARTIAL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_remove(coffee_page_t page)
+{
+  int i;
+
+  for(i = 0; i < COFFEE_NAME_INDEX_SIZE; i++) {
+    if(name_index[i].page == page) {
+      name_index[i].page = INVALID_PAGE;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_clear(void)
+{
+  int i;
+
+  for(i = 0; i < COFFEE_NAME_INDEX_SIZE; i++) {
+    name_index[i].page = INVALID_PAGE;
+  }
+  name_index_state = NAME_INDEX_COMPLETE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_build(void)
+{
+  struct file_header hdr;
+  coffee_page_t page;
+
+  name_index_clear();
+  for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
+    read_header(&hdr, page);
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr)) {
+      name_index_add(page, hdr.name);
+    }
+  }
+}
+#endif /* COFFEE_NAME_INDEX_SIZE > 0 */
+/*---------------------------------------------------------------------------*/
 static struct file *
 find_file(const char *name)
 {
   int i;
   struct file_header hdr;
   coffee_page_t page;
+#if COFFEE_NAME_INDEX_SIZE > 0
+  uint16_t hash;
+
+  if(name_index_state == NAME_INDEX_UNBUILT) {
+    name_index_build();
+  }
+
+  hash = name_hash(name);
+  for(i = 0; i < COFFEE_NAME_INDEX_SIZE; i++) {
+    page = name_index[i].page;
+    if(page == INVALID_PAGE || name_index[i].hash != hash) {
+      continue;
+    }
+    read_header(&hdr, page);
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && strcmp(name, hdr.name) == 0) {
+      for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
+        if(!FILE_FREE(&coffee_files[i]) && coffee_files[i].page == page) {
+          return &coffee_files[i];
+        }
+      }
+      return load_file(page, &hdr);
+    }
+  }
+
+  if(name_index_state == NAME_INDEX_COMPLETE) {
+    return NULL;
+  }
+#endif /* COFFEE_NAME_INDEX_SIZE > 0 */
 
   /* First check if the file metadata is cached. */
   for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
@@ -482,6 +863,45 @@ find_file(const char *name)
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_END_HINTS
+static cfs_offset_t
+file_extent(coffee_page_t max_pages)
+{
+  return max_pages * COFFEE_PAGE_SIZE - sizeof(struct file_header);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Mark the file as written up to end. This must be done before the
+ * data is written: if the data were written first and the power were
+ * lost before the hint, file_end() would start below the real end of
+ * the file.
+ */
+static void
+update_end_hint(struct file *file, cfs_offset_t end)
+{
+  struct file_header hdr;
+  cfs_offset_t extent;
+  uint8_t hint;
+  int n;
+
+  extent = file_extent(file->max_pages);
+  hint = END_HINT_IN_USE;
+  for(n = 1; n < 8; n++) {
+    if(end > extent * n / 8) {
+      hint |= 1 << n;
+    }
+  }
+
+  /* Hint bits are only ever set, which flash allows in place. */
+  if((hint & ~file->end_hint) != 0) {
+    read_header(&hdr, file->page);
+    hdr.eof_hint |= hint;
+    write_header(&hdr, file->page);
+    file->end_hint = hdr.eof_hint;
+  }
+}
+#endif /* COFFEE_END_HINTS */
+/*---------------------------------------------------------------------------*/
 static cfs_offset_t
 file_end(coffee_page_t start)
 {
@@ -491,6 +911,22 @@ file_end(coffee_page_t start)
   int i;
 
   read_header(&hdr, start);
+  page = hdr.max_pages - 1;
+
+#if COFFEE_END_HINTS
+  /* Nothing has been written past the eighth above the highest one
+     marked in the hint. */
+  if(hdr.eof_hint & END_HINT_IN_USE) {
+    for(i = 7; i > 0 && !(hdr.eof_hint & (1 << i)); i--);
+    if(i < 7) {
+      page = (sizeof(hdr) + file_extent(hdr.max_pages) * (i + 1) / 8) /
+        COFFEE_PAGE_SIZE;
+      if(page > hdr.max_pages - 1) {
+        page = hdr.max_pages - 1;
+      }
+    }
+  }
+#endif /* COFFEE_END_HINTS */
 
   /*
    * Move from the end of the range towards the beginning and look for
@@ -500,8 +936,8 @@ file_end(coffee_page_t start)
    * are zeroes, then these are skipped from the calculation.
    */
 
-  for(page = hdr.max_pages - 1; page >= 0; page--) {
-    COFFEE_READ(buf, sizeof(buf), (start + page) * COFFEE_PAGE_SIZE);
+  for(; page >= 0; page--) {
+    flash_read(buf, sizeof(buf), (start + page) * COFFEE_PAGE_SIZE);
     for(i = COFFEE_PAGE_SIZE - 1; i >= 0; i--) {
       if(buf[i] != 0) {
         if(page == 0 && i < sizeof(hdr)) {
@@ -572,6 +1008,9 @@ remove_by_page(coffee_page_t page, int remove_log,
 
   hdr.flags |= HDR_FLAG_OBSOLETE;
   write_header(&hdr, page);
+#if COFFEE_NAME_INDEX_SIZE > 0
+  name_index_remove(page);
+#endif
 
   gc_wait = 0;
 
@@ -592,9 +1031,16 @@ remove_by_page(coffee_page_t page, int remove_log,
     }
   }
 
+#if COFFEE_BACKGROUND_GC
+  gc_pending = 1;
+  if(gc_allowed) {
+    request_gc();
+  }
+#else
   if(!COFFEE_EXTENDED_WEAR_LEVELLING && gc_allowed) {
     collect_garbage(GC_RELUCTANT);
   }
+#endif
 
   return 0;
 }
@@ -619,6 +1065,13 @@ reserve(const char *name, coffee_page_t pages,
   }
 
   page = find_contiguous_pages(pages);
+#if COFFEE_BACKGROUND_GC
+  /* Wrap around to the sectors freed behind the allocator. */
+  if(page == INVALID_PAGE && next_free > 0) {
+    next_free = 0;
+    page = find_contiguous_pages(pages);
+  }
+#endif
   if(page == INVALID_PAGE) {
     if(gc_wait) {
       return NULL;
@@ -635,11 +1088,27 @@ reserve(const char *name, coffee_page_t pages,
   strncpy(hdr.name, name, sizeof(hdr.name) - 1);
   hdr.max_pages = pages;
   hdr.flags = HDR_FLAG_ALLOCATED | flags;
+#if COFFEE_END_HINTS
+  hdr.eof_hint = END_HINT_IN_USE;
+#endif
   write_header(&hdr, page);
+#if COFFEE_NAME_INDEX_SIZE > 0
+  if(name_index_state != NAME_INDEX_UNBUILT && !(flags & HDR_FLAG_LOG)) {
+    name_index_add(page, hdr.name);
+  }
+#endif
 
   PRINTF("Coffee: Reserved %u pages starting from %u for file %s\n",
          (unsigned)pages, (unsigned)page, name);
 
+#if COFFEE_BACKGROUND_GC
+  gc_reserved(page, pages);
+  if(free_pages != INVALID_PAGE) {
+    free_pages = free_pages > pages ? free_pages - pages : 0;
+  }
+  request_gc();
+#endif
+
   file = load_file(page, &hdr);
   if(file != NULL) {
     file->end = 0;
@@ -703,7 +1172,7 @@ get_record_index(coffee_page_t log_page, uint16_t search_records,
       }
 
       base -= batch_size * sizeof(indices[0]);
-      COFFEE_READ(&indices, sizeof(indices[0]) * batch_size, base);
+      flash_read(&indices, sizeof(indices[0]) * batch_size, base);
 
       for(i = batch_size - 1; i >= 0; i--) {
         if(indices[i] - 1 == region) {
@@ -744,7 +1213,7 @@ read_log_page(struct file_header *hdr, int16_t record_count,
   base = absolute_offset(hdr->log_page, log_records * sizeof(region));
   base += (cfs_offset_t)match_index * log_record_size;
   base += lp->offset;
-  COFFEE_READ(lp->buf, lp->size, base);
+  flash_read(lp->buf, lp->size, base);
 
   return lp->size;
 }
@@ -805,6 +1274,10 @@ merge_log(coffee_page_t file_page, int extend)
     return -1;
   }
 
+#if COFFEE_END_HINTS
+  update_end_hint(new_file, coffee_fd_set[fd].file->end);
+#endif
+
   offset = 0;
   do {
     char buf[hdr.log_record_size == 0 ? COFFEE_PAGE_SIZE : hdr.log_record_size];
@@ -814,7 +1287,7 @@ merge_log(coffee_page_t file_page, int extend)
       cfs_close(fd);
       return -1;
     } else if(n > 0) {
-      COFFEE_WRITE(buf, n, absolute_offset(new_file->page, offset));
+      flash_write(buf, n, absolute_offset(new_file->page, offset));
       offset += n;
     }
   } while(n != 0);
@@ -871,7 +1344,7 @@ find_next_record(struct file *file, coffee_page_t log_page,
       batch_size = log_records - processed >= preferred_batch_size ?
         preferred_batch_size : log_records - processed;
 
-      COFFEE_READ(&indices, batch_size * sizeof(indices[0]),
+      flash_read(&indices, batch_size * sizeof(indices[0]),
                   absolute_offset(log_page, processed * sizeof(indices[0])));
       for(log_record = 0; log_record < batch_size; log_record++) {
         if(indices[log_record] == 0) {
@@ -935,7 +1408,7 @@ write_log_page(struct file *file, struct log_param *lp)
 
     if((lp->offset > 0 || lp->size != log_record_size) &&
        read_log_page(&hdr, log_record, &lp_out) < 0) {
-      COFFEE_READ(copy_buf, sizeof(copy_buf),
+      flash_read(copy_buf, sizeof(copy_buf),
                   absolute_offset(file->page, offset));
     }
 
@@ -947,11 +1420,11 @@ write_log_page(struct file *file, struct log_param *lp)
      */
     offset = absolute_offset(log_page, 0);
     ++region;
-    COFFEE_WRITE(&region, sizeof(region),
+    flash_write(&region, sizeof(region),
                  offset + log_record * sizeof(region));
 
     offset += log_records * sizeof(region);
-    COFFEE_WRITE(copy_buf, sizeof(copy_buf),
+    flash_write(copy_buf, sizeof(copy_buf),
                  offset + log_record * log_record_size);
     file->record_count = log_record + 1;
   }
@@ -1105,7 +1578,7 @@ cfs_read(int fd, void *buf, unsigned size)
 
   /* If the file is not modified, read directly from the file extent. */
   if(!FILE_MODIFIED(file)) {
-    COFFEE_READ(buf, size, absolute_offset(file->page, fdp->offset));
+    flash_read(buf, size, absolute_offset(file->page, fdp->offset));
     fdp->offset += size;
     return size;
   }
@@ -1126,7 +1599,7 @@ cfs_read(int fd, void *buf, unsigned size)
 
     /* Read from the original file if we cannot find the data in the log. */
     if(r < 0) {
-      COFFEE_READ(buf, lp.size, absolute_offset(file->page, fdp->offset));
+      flash_read(buf, lp.size, absolute_offset(file->page, fdp->offset));
       r = lp.size;
     }
     fdp->offset += r;
@@ -1209,7 +1682,10 @@ cfs_write(int fd, const void *buf, unsigned size)
        * corresponding end offset in the original extent to ensure that
        * the correct file size is calculated when opening the file again.
        */
-      COFFEE_WRITE(dummy, 1, absolute_offset(file->page, fdp->offset - 1));
+#if COFFEE_END_HINTS
+      update_end_hint(file, fdp->offset);
+#endif
+      flash_write(dummy, 1, absolute_offset(file->page, fdp->offset - 1));
     }
   } else {
 #endif /* COFFEE_MICRO_LOGS */
@@ -1217,7 +1693,10 @@ cfs_write(int fd, const void *buf, unsigned size)
       return -1;
     }
 
-    COFFEE_WRITE(buf, size, absolute_offset(file->page, fdp->offset));
+#if COFFEE_END_HINTS
+    update_end_hint(file, fdp->offset + size);
+#endif
+    flash_write(buf, size, absolute_offset(file->page, fdp->offset));
     fdp->offset += size;
 #if COFFEE_MICRO_LOGS
   }
@@ -1253,7 +1732,7 @@ cfs_readdir(struct cfs_dir *dir, struct cfs_dirent *record)
   while(page < COFFEE_PAGE_COUNT) {
     read_header(&hdr, page);
     if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr)) {
-      memcpy(record->name, hdr.name, sizeof(record->name));
+      memcpy(record->name, hdr.name, MIN(sizeof(record->name), sizeof(hdr.name)));
       record->name[sizeof(record->name) - 1] = '\0';
       record->size = file_end(page);
 
@@ -1329,7 +1808,7 @@ cfs_coffee_format(void)
   PRINTF("Coffee: Formatting %u sectors", (unsigned)COFFEE_SECTOR_COUNT);
 
   for(i = 0; i < COFFEE_SECTOR_COUNT; i++) {
-    COFFEE_ERASE(i);
+    flash_erase(i);
     PRINTF(".");
   }
 
@@ -1338,9 +1817,29 @@ cfs_coffee_format(void)
   memset(&coffee_fd_set, 0, sizeof(coffee_fd_set));
   next_free = 0;
   gc_wait = 1;
+#if COFFEE_NAME_INDEX_SIZE > 0
+  name_index_clear();
+#endif
+#if COFFEE_BACKGROUND_GC
+  free_pages = COFFEE_PAGE_COUNT;
+  gc_pending = 0;
+#endif
 
   PRINTF(" done!\n");
 
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+int
+cfs_coffee_erase_count(unsigned sector)
+{
+  if(sector >= COFFEE_SECTOR_COUNT) {
+    return -1;
+  }
+#if COFFEE_BACKGROUND_GC
+  return sector_erasures[sector];
+#else
+  return 0;
+#endif
+}
+/*---------------------------------------------------------------------------*/
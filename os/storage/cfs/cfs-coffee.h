@@ -140,6 +140,19 @@ int cfs_coffee_set_io_semantics(int fd, unsigned flags);
  */
 int cfs_coffee_format(void);
 
+/**
+ * \brief Get the number of times a sector has been erased.
+ * \param sector The sector number, counted from the start of Coffee.
+ * \return The erase count since boot, or -1 if there is no such sector.
+ *
+ * The erase counts show how evenly wear is spread over the storage.
+ * They are diagnostic only: they are kept in RAM, and Coffee does not
+ * use them to choose sectors. They are only kept when Coffee collects
+ * garbage in the background (COFFEE_BACKGROUND_GC); otherwise all
+ * counts are zero.
+ */
+int cfs_coffee_erase_count(unsigned sector);
+
 /** @} */
 /** @} */
 
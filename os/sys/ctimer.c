@@ -46,9 +46,10 @@
 #include "contiki.h"
 #include "lib/list.h"
 
-LIST(ctimer_list);
+#include <stddef.h>
 
 static char initialized;
+static struct ctimer_stats stats;
 
 #define DEBUG 0
 #if DEBUG
@@ -58,8 +59,175 @@ static char initialized;
 #define PRINTF(...)
 #endif
 
+PROCESS_PRIO(ctimer_process, "Ctimer process", PROCESS_PRIO_HIGH);
+/*---------------------------------------------------------------------------*/
+static void
+call(struct ctimer *c)
+{
+  clock_time_t latency;
+
+  latency = clock_time() - etimer_expiration_time(&c->etimer);
+  stats.callbacks++;
+  stats.total_latency += latency;
+  if(latency > stats.max_latency) {
+    stats.max_latency = latency;
+  }
+
+  PROCESS_CONTEXT_BEGIN(c->p);
+  if(c->f != NULL) {
+    c->f(c->ptr);
+  }
+  PROCESS_CONTEXT_END(c->p);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_stats(struct ctimer_stats *s)
+{
+  *s = stats;
+}
+#if CTIMER_DIRECT_DISPATCH
+/*---------------------------------------------------------------------------*/
+#define CTIMER(et) ((struct ctimer *)((char *)(et) - offsetof(struct ctimer, etimer)))
+
+static struct etimer *ctimer_heap;
+static unsigned pending;
+
+/* The event timer for the earliest pending callback timer. */
+static struct etimer wakeup;
+/*---------------------------------------------------------------------------*/
+/*
+ * Make sure that the ctimer process wakes up no later than the
+ * earliest callback timer expires. A wakeup that comes too early, for
+ * instance after the earliest timer has been stopped, is harmless, so
+ * the event timer is only set again when it would be late.
+ */
+static void
+schedule_wakeup(void)
+{
+  clock_time_t expiration;
+  clock_time_t diff;
+
+  if(!initialized || ctimer_heap == NULL) {
+    return;
+  }
+
+  expiration = etimer_expiration_time(ctimer_heap);
+  diff = etimer_expiration_time(&wakeup) - expiration;
+  if(!etimer_expired(&wakeup) &&
+     (diff == 0 || diff > ((clock_time_t)~(clock_time_t)0) >> 1)) {
+    return;
+  }
+
+  PROCESS_CONTEXT_BEGIN(&ctimer_process);
+  if(timer_expired(&ctimer_heap->timer)) {
+    etimer_set(&wakeup, 0);
+  } else {
+    etimer_set(&wakeup, expiration - clock_time());
+  }
+  PROCESS_CONTEXT_END(&ctimer_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_ctimer(struct ctimer *c)
+{
+  if(etimer_heap_contains(&ctimer_heap, &c->etimer)) {
+    etimer_heap_remove(&ctimer_heap, &c->etimer);
+    pending--;
+  }
+  c->etimer.p = PROCESS_NONE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_ctimer(struct ctimer *c)
+{
+  remove_ctimer(c);
+  c->etimer.p = &ctimer_process;
+  etimer_heap_insert(&ctimer_heap, &c->etimer);
+  pending++;
+  schedule_wakeup();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ctimer_process, ev, data)
+{
+  struct ctimer *c;
+  unsigned budget;
+
+  PROCESS_BEGIN();
+
+  initialized = 1;
+  schedule_wakeup();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
+
+    /*
+     * Call at most as many timers as were pending on wakeup, so that
+     * a callback that sets its timer to expire at once cannot keep
+     * the process from returning.
+     */
+    for(budget = pending;
+        budget > 0 && ctimer_heap != NULL &&
+          timer_expired(&ctimer_heap->timer);
+        budget--) {
+      c = CTIMER(ctimer_heap);
+      remove_ctimer(c);
+      call(c);
+    }
+    schedule_wakeup();
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_init(void)
+{
+  initialized = 0;
+  ctimer_heap = NULL;
+  pending = 0;
+  process_start(&ctimer_process, NULL);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_set_with_process(struct ctimer *c, clock_time_t t,
+                        void (*f)(void *), void *ptr, struct process *p)
+{
+  PRINTF("ctimer_set %p %lu\n", c, (unsigned long)t);
+  c->p = p;
+  c->f = f;
+  c->ptr = ptr;
+  timer_set(&c->etimer.timer, t);
+  add_ctimer(c);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_reset(struct ctimer *c)
+{
+  timer_reset(&c->etimer.timer);
+  add_ctimer(c);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_restart(struct ctimer *c)
+{
+  timer_restart(&c->etimer.timer);
+  add_ctimer(c);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_stop(struct ctimer *c)
+{
+  remove_ctimer(c);
+}
+/*---------------------------------------------------------------------------*/
+int
+ctimer_expired(struct ctimer *c)
+{
+  return !etimer_heap_contains(&ctimer_heap, &c->etimer);
+}
+#else /* CTIMER_DIRECT_DISPATCH */
+/*---------------------------------------------------------------------------*/
+LIST(ctimer_list);
 /*---------------------------------------------------------------------------*/
-PROCESS(ctimer_process, "Ctimer process");
 PROCESS_THREAD(ctimer_process, ev, data)
 {
   struct ctimer *c;
@@ -75,11 +243,7 @@ PROCESS_THREAD(ctimer_process, ev, data)
     for(c = list_head(ctimer_list); c != NULL; c = c->next) {
       if(&c->etimer == data) {
         list_remove(ctimer_list, c);
-        PROCESS_CONTEXT_BEGIN(c->p);
-        if(c->f != NULL) {
-          c->f(c->ptr);
-        }
-        PROCESS_CONTEXT_END(c->p);
+        call(c);
         break;
       }
     }
@@ -96,13 +260,6 @@ ctimer_init(void)
 }
 /*---------------------------------------------------------------------------*/
 void
-ctimer_set(struct ctimer *c, clock_time_t t,
-           void (*f)(void *), void *ptr)
-{
-  ctimer_set_with_process(c, t, f, ptr, PROCESS_CURRENT());
-}
-/*---------------------------------------------------------------------------*/
-void
 ctimer_set_with_process(struct ctimer *c, clock_time_t t,
                         void (*f)(void *), void *ptr, struct process *p)
 {
@@ -171,5 +328,13 @@ ctimer_expired(struct ctimer *c)
   }
   return 1;
 }
+#endif /* CTIMER_DIRECT_DISPATCH */
+/*---------------------------------------------------------------------------*/
+void
+ctimer_set(struct ctimer *c, clock_time_t t,
+           void (*f)(void *), void *ptr)
+{
+  ctimer_set_with_process(c, t, f, ptr, PROCESS_CURRENT());
+}
 /*---------------------------------------------------------------------------*/
 /** @} */
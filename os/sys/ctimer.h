@@ -58,6 +58,28 @@
 #include "contiki.h"
 #include "sys/etimer.h"
 
+/**
+ * \brief Dispatch callback timers directly from the ctimer process
+ *
+ * By default, each callback timer is an event timer of its own. Its
+ * expiry is posted as an event to the ctimer process, which then
+ * searches the list of callback timers for the one that fired. When
+ * enabled, pending callback timers are instead kept in a heap of their
+ * own, ordered on expiration time, and a single event timer is set for
+ * the earliest one. When it fires, all callback timers that have
+ * expired are called in deadline order, without an event or a search
+ * for each of them. This requires ETIMER_CONF_WITH_HEAP.
+ */
+#ifdef CTIMER_CONF_DIRECT_DISPATCH
+#define CTIMER_DIRECT_DISPATCH CTIMER_CONF_DIRECT_DISPATCH
+#else /* CTIMER_CONF_DIRECT_DISPATCH */
+#define CTIMER_DIRECT_DISPATCH 0
+#endif /* CTIMER_CONF_DIRECT_DISPATCH */
+
+#if CTIMER_DIRECT_DISPATCH && !ETIMER_WITH_HEAP
+#error "CTIMER_CONF_DIRECT_DISPATCH requires ETIMER_CONF_WITH_HEAP"
+#endif
+
 struct ctimer {
   struct ctimer *next;
   struct etimer etimer;
@@ -156,6 +178,28 @@ void ctimer_stop(struct ctimer *c);
  */
 int ctimer_expired(struct ctimer *c);
 
+/**
+ * Statistics on the callbacks made by callback timers.
+ */
+struct ctimer_stats {
+  /** The number of callbacks made. */
+  unsigned long callbacks;
+  /** The sum of the time from expiration to callback, in clock ticks. */
+  unsigned long total_latency;
+  /** The longest time from expiration to callback, in clock ticks. */
+  clock_time_t max_latency;
+};
+
+/**
+ * \brief       Obtain statistics on the callbacks made so far.
+ * \param stats A pointer to an object that will be filled in.
+ *
+ *              The latency of a callback is the time from the expiration
+ *              time of the callback timer to the call of its callback
+ *              function.
+ */
+void ctimer_stats(struct ctimer_stats *stats);
+
 /**
  * \brief      Initialize the callback timer library.
  *
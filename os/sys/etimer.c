@@ -49,10 +49,276 @@
 #include "sys/etimer.h"
 #include "sys/process.h"
 
+PROCESS_PRIO(etimer_process, "Event timer", PROCESS_PRIO_HIGH);
+
+#if ETIMER_WITH_HEAP
+static struct etimer *timerheap;
+/*---------------------------------------------------------------------------*/
+/*
+ * Wrap-safe ordering of two timers on their expiration time. This is
+ * correct as long as all pending timers expire within half the range
+ * of clock_time_t of each other.
+ */
+static int
+expires_before(struct etimer *a, struct etimer *b)
+{
+  clock_time_t diff = etimer_expiration_time(b) - etimer_expiration_time(a);
+
+  return diff != 0 && diff <= ((clock_time_t)~(clock_time_t)0) >> 1;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Meld two heaps, and return the new root. The roots of both heaps
+ * must not have any siblings.
+ */
+static struct etimer *
+meld(struct etimer *a, struct etimer *b)
+{
+  struct etimer *t;
+
+  if(a == NULL) {
+    return b;
+  }
+  if(b == NULL) {
+    return a;
+  }
+  if(expires_before(b, a)) {
+    t = a;
+    a = b;
+    b = t;
+  }
+
+  /* Make b the first child of a. */
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Meld a list of siblings into a single heap with the standard
+ * two-pass pairing: meld pairs left to right, then meld the pairs
+ * right to left.
+ */
+static struct etimer *
+merge_pairs(struct etimer *list)
+{
+  struct etimer *a, *b;
+  struct etimer *pairs = NULL;
+  struct etimer *result = NULL;
+
+  while(list != NULL) {
+    a = list;
+    b = a->next;
+    list = b != NULL ? b->next : NULL;
+
+    a->next = a->prev = NULL;
+    if(b != NULL) {
+      b->next = b->prev = NULL;
+      a = meld(a, b);
+    }
+    /* Keep the pairs in reverse order for the second pass. */
+    a->next = pairs;
+    pairs = a;
+  }
+
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = pairs->next;
+    a->next = NULL;
+    result = meld(result, a);
+  }
+  return result;
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_heap_insert(struct etimer **heap, struct etimer *et)
+{
+  et->next = et->child = et->prev = NULL;
+  et->heap = heap;
+  *heap = meld(*heap, et);
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_heap_remove(struct etimer **heap, struct etimer *et)
+{
+  struct etimer *sub;
+
+  if(et == *heap) {
+    *heap = merge_pairs(et->child);
+  } else {
+    /* Unlink et from its parent or its left sibling. */
+    if(et->prev->child == et) {
+      et->prev->child = et->next;
+    } else {
+      et->prev->next = et->next;
+    }
+    if(et->next != NULL) {
+      et->next->prev = et->prev;
+    }
+    sub = merge_pairs(et->child);
+    *heap = meld(*heap, sub);
+  }
+  et->next = et->child = et->prev = NULL;
+  et->heap = NULL;
+}
+/*---------------------------------------------------------------------------*/
+int
+etimer_heap_contains(struct etimer * const *heap, struct etimer *et)
+{
+  /*
+   * A timer that was never set may hold anything, even a copy of a
+   * timer in the heap, so its links are only trusted if the heap
+   * links back to it.
+   */
+  if(et->heap != heap || et->p == PROCESS_NONE) {
+    return 0;
+  }
+  if(et == *heap) {
+    return 1;
+  }
+  return et->prev != NULL &&
+    (et->prev->child == et || et->prev->next == et);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Remove all timers that belong to process p. Every timer is visited
+ * once: the heap is flattened into a list that is linked through the
+ * next pointers, and the remaining timers are inserted again.
+ */
+static void
+heap_remove_process(struct process *p)
+{
+  struct etimer *t, *tail, *next;
+
+  tail = timerheap;
+  for(t = timerheap; t != NULL; t = t->next) {
+    if(t->child != NULL) {
+      tail->next = t->child;
+      t->child = NULL;
+      while(tail->next != NULL) {
+        tail = tail->next;
+      }
+    }
+  }
+
+  t = timerheap;
+  timerheap = NULL;
+  for(; t != NULL; t = next) {
+    next = t->next;
+    if(t->p == p) {
+      t->next = t->child = t->prev = NULL;
+      t->heap = NULL;
+    } else {
+      etimer_heap_insert(&timerheap, t);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_process, ev, data)
+{
+  struct etimer *t, *deferred;
+
+  PROCESS_BEGIN();
+
+  timerheap = NULL;
+
+  while(1) {
+    PROCESS_YIELD();
+
+    if(ev == PROCESS_EVENT_EXITED) {
+      heap_remove_process(data);
+      continue;
+    } else if(ev != PROCESS_EVENT_POLL) {
+      continue;
+    }
+
+    /*
+     * Timers whose event could not be posted are kept aside, so that
+     * the timers behind them in the heap are still served.
+     */
+    deferred = NULL;
+    while(timerheap != NULL && timer_expired(&timerheap->timer)) {
+      t = timerheap;
+      etimer_heap_remove(&timerheap, t);
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+        /* Reset the process ID of the event timer, to signal that the
+           etimer has expired. This is later checked in the
+           etimer_expired() function. */
+        t->p = PROCESS_NONE;
+      } else {
+        t->next = deferred;
+        deferred = t;
+      }
+    }
+
+    if(deferred != NULL) {
+      while(deferred != NULL) {
+        t = deferred;
+        deferred = t->next;
+        etimer_heap_insert(&timerheap, t);
+      }
+      etimer_request_poll();
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_timer(struct etimer *timer)
+{
+  etimer_request_poll();
+
+  if(etimer_heap_contains(&timerheap, timer)) {
+    /* The expiration time has changed, so the timer must be moved. */
+    etimer_heap_remove(&timerheap, timer);
+  }
+
+  timer->p = PROCESS_CURRENT();
+  etimer_heap_insert(&timerheap, timer);
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_adjust(struct etimer *et, int timediff)
+{
+  if(etimer_heap_contains(&timerheap, et)) {
+    etimer_heap_remove(&timerheap, et);
+    et->timer.start += timediff;
+    etimer_heap_insert(&timerheap, et);
+  } else {
+    et->timer.start += timediff;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+etimer_pending(void)
+{
+  return timerheap != NULL;
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+etimer_next_expiration_time(void)
+{
+  return etimer_pending() ? etimer_expiration_time(timerheap) : 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_stop(struct etimer *et)
+{
+  if(etimer_heap_contains(&timerheap, et)) {
+    etimer_heap_remove(&timerheap, et);
+  }
+
+  /* Set the timer as expired */
+  et->p = PROCESS_NONE;
+}
+#else /* ETIMER_WITH_HEAP */
 static struct etimer *timerlist;
 static clock_time_t next_expiration;
-
-PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
 static void
 update_time(void)
@@ -79,7 +345,8 @@ update_time(void)
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
-  struct etimer *t, *u;
+  struct etimer *t, *u, *next;
+  int removed;
 
   PROCESS_BEGIN();
 
@@ -110,11 +377,13 @@ PROCESS_THREAD(etimer_process, ev, data)
       continue;
     }
 
-again:
-
+    /* Remove all expired timers in a single pass over the list, and
+       recalculate the next expiration time once afterwards. */
     u = NULL;
+    removed = 0;
 
-    for(t = timerlist; t != NULL; t = t->next) {
+    for(t = timerlist; t != NULL; t = next) {
+      next = t->next;
       if(timer_expired(&t->timer)) {
         if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
 
@@ -123,30 +392,28 @@ again:
              etimer_expired() function. */
           t->p = PROCESS_NONE;
           if(u != NULL) {
-            u->next = t->next;
+            u->next = next;
           } else {
-            timerlist = t->next;
+            timerlist = next;
           }
           t->next = NULL;
-          update_time();
-          goto again;
+          removed = 1;
+          continue;
         } else {
           etimer_request_poll();
         }
       }
       u = t;
     }
+
+    if(removed) {
+      update_time();
+    }
   }
 
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
-void
-etimer_request_poll(void)
-{
-  process_poll(&etimer_process);
-}
-/*---------------------------------------------------------------------------*/
 static void
 add_timer(struct etimer *timer)
 {
@@ -174,35 +441,6 @@ add_timer(struct etimer *timer)
 }
 /*---------------------------------------------------------------------------*/
 void
-etimer_set(struct etimer *et, clock_time_t interval)
-{
-  timer_set(&et->timer, interval);
-  add_timer(et);
-}
-/*---------------------------------------------------------------------------*/
-void
-etimer_reset_with_new_interval(struct etimer *et, clock_time_t interval)
-{
-  timer_reset(&et->timer);
-  et->timer.interval = interval;
-  add_timer(et);
-}
-/*---------------------------------------------------------------------------*/
-void
-etimer_reset(struct etimer *et)
-{
-  timer_reset(&et->timer);
-  add_timer(et);
-}
-/*---------------------------------------------------------------------------*/
-void
-etimer_restart(struct etimer *et)
-{
-  timer_restart(&et->timer);
-  add_timer(et);
-}
-/*---------------------------------------------------------------------------*/
-void
 etimer_adjust(struct etimer *et, int timediff)
 {
   et->timer.start += timediff;
@@ -210,24 +448,6 @@ etimer_adjust(struct etimer *et, int timediff)
 }
 /*---------------------------------------------------------------------------*/
 int
-etimer_expired(struct etimer *et)
-{
-  return et->p == PROCESS_NONE;
-}
-/*---------------------------------------------------------------------------*/
-clock_time_t
-etimer_expiration_time(struct etimer *et)
-{
-  return et->timer.start + et->timer.interval;
-}
-/*---------------------------------------------------------------------------*/
-clock_time_t
-etimer_start_time(struct etimer *et)
-{
-  return et->timer.start;
-}
-/*---------------------------------------------------------------------------*/
-int
 etimer_pending(void)
 {
   return timerlist != NULL;
@@ -269,5 +489,59 @@ etimer_stop(struct etimer *et)
   /* Set the timer as expired */
   et->p = PROCESS_NONE;
 }
+#endif /* ETIMER_WITH_HEAP */
+/*---------------------------------------------------------------------------*/
+void
+etimer_request_poll(void)
+{
+  process_poll(&etimer_process);
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_set(struct etimer *et, clock_time_t interval)
+{
+  timer_set(&et->timer, interval);
+  add_timer(et);
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_reset_with_new_interval(struct etimer *et, clock_time_t interval)
+{
+  timer_reset(&et->timer);
+  et->timer.interval = interval;
+  add_timer(et);
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_reset(struct etimer *et)
+{
+  timer_reset(&et->timer);
+  add_timer(et);
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_restart(struct etimer *et)
+{
+  timer_restart(&et->timer);
+  add_timer(et);
+}
+/*---------------------------------------------------------------------------*/
+int
+etimer_expired(struct etimer *et)
+{
+  return et->p == PROCESS_NONE;
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+etimer_expiration_time(struct etimer *et)
+{
+  return et->timer.start + et->timer.interval;
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+etimer_start_time(struct etimer *et)
+{
+  return et->timer.start;
+}
 /*---------------------------------------------------------------------------*/
 /** @} */
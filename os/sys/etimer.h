@@ -65,6 +65,23 @@
 
 #include "contiki.h"
 
+/**
+ * \brief Keep pending event timers in a pairing heap
+ *
+ * By default, pending event timers are kept in an unsorted list, so
+ * that adding or stopping a timer and finding the next expiration
+ * time take time proportional to the number of timers. When enabled,
+ * the timers are instead kept in a pairing heap ordered on expiration
+ * time: setting a timer is O(1), stopping and expiring a timer are
+ * amortized O(log n), and the next expiration time is read from the
+ * root of the heap. This costs two extra pointers per event timer.
+ */
+#ifdef ETIMER_CONF_WITH_HEAP
+#define ETIMER_WITH_HEAP ETIMER_CONF_WITH_HEAP
+#else /* ETIMER_CONF_WITH_HEAP */
+#define ETIMER_WITH_HEAP 0
+#endif /* ETIMER_CONF_WITH_HEAP */
+
 /**
  * A timer.
  *
@@ -76,6 +93,11 @@
 struct etimer {
   struct timer timer;
   struct etimer *next;
+#if ETIMER_WITH_HEAP
+  struct etimer *child;
+  struct etimer *prev;
+  struct etimer * const *heap; /* The heap the timer is in, or NULL */
+#endif /* ETIMER_WITH_HEAP */
   struct process *p;
 };
 
@@ -249,6 +271,44 @@ clock_time_t etimer_next_expiration_time(void);
 
 /** @} */
 
+#if ETIMER_WITH_HEAP
+/**
+ * \name Functions called from other timer libraries
+ *
+ *        These functions manage a pairing heap of event timers, ordered
+ *        on expiration time, with a root that is owned by the caller.
+ *        They let a library keep its own timers in the same kind of heap
+ *        as the event timer module, without posting an event for each of
+ *        them. The p field of a timer must not be PROCESS_NONE while the
+ *        timer is in a heap.
+ * @{
+ */
+
+/**
+ * \brief      Insert an event timer into a heap.
+ * \param heap A pointer to the root of the heap.
+ * \param et   A pointer to an event timer that is in no heap.
+ */
+void etimer_heap_insert(struct etimer **heap, struct etimer *et);
+
+/**
+ * \brief      Remove an event timer from a heap.
+ * \param heap A pointer to the root of the heap.
+ * \param et   A pointer to an event timer in the heap.
+ */
+void etimer_heap_remove(struct etimer **heap, struct etimer *et);
+
+/**
+ * \brief      Check if an event timer is in a heap.
+ * \param heap A pointer to the root of the heap.
+ * \param et   A pointer to the event timer.
+ * \return     Non-zero if the event timer is in the heap.
+ */
+int etimer_heap_contains(struct etimer * const *heap, struct etimer *et);
+
+/** @} */
+#endif /* ETIMER_WITH_HEAP */
+
 PROCESS_NAME(etimer_process);
 #endif /* ETIMER_H_ */
 /** @} */
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Binary, deferred logging
+ */
+
+/** \addtogroup sys
+ * @{ */
+
+/** \addtogroup log
+ * @{ */
+
+#include "contiki.h"
+#include "sys/log.h"
+#include "sys/atomic.h"
+#include "sys/memory-barrier.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+
+#if LOG_BINARY
+
+#define HEADER_SIZE  10
+#define ARGS_SIZE    (LOG_BINARY_SLOT_SIZE - HEADER_SIZE)
+
+/* A frame adds the magic byte and the checksum, and must fit in 255 bytes. */
+#if ARGS_SIZE < 8 || ARGS_SIZE > 244
+#error LOG_BINARY_CONF_SLOT_SIZE must be between 18 and 254
+#endif
+
+#define SLOT_FREE       0
+#define SLOT_READY      1
+#define SLOT_TRUNCATED  2
+
+/* The header fields are laid out as in a frame, after the magic byte. */
+struct slot {
+  volatile uint8_t state;
+  uint8_t len;
+  uint8_t id[4];
+  uint8_t time[4];
+  uint8_t args[ARGS_SIZE];
+};
+
+/* The start of the format table, as defined by the linker */
+extern const char __start_log_fmt[];
+
+static struct slot slots[LOG_BINARY_SLOTS];
+/* Free-running indices; the ring holds the slots from get to put. */
+static volatile uint8_t put_index;
+static volatile uint8_t get_index;
+/* Records dropped since the last report, up to 255 */
+static volatile uint8_t dropped_pending;
+
+static struct log_binary_stats stats;
+
+PROCESS(log_binary_process, "Binary log");
+/*---------------------------------------------------------------------------*/
+static void
+count_drop(void)
+{
+  uint8_t dropped;
+
+  do {
+    dropped = dropped_pending;
+    if(dropped == 0xff) {
+      return;
+    }
+  } while(!atomic_cas_uint8((uint8_t *)&dropped_pending,
+                            dropped, dropped + 1));
+}
+/*---------------------------------------------------------------------------*/
+static int
+put_arg(struct slot *s, const void *arg, size_t size)
+{
+  if(s->len + size > ARGS_SIZE) {
+    return 0;
+  }
+  memcpy(&s->args[s->len], arg, size);
+  s->len += size;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+put_string(struct slot *s, const char *str, int precision)
+{
+  size_t room = ARGS_SIZE - s->len;
+  size_t len;
+
+  if(room == 0) {
+    return 0;
+  }
+  if(str == NULL) {
+    str = "(null)";
+  }
+  /* The string need not be terminated within the precision. */
+  for(len = 0; str[len] != '\0' && (precision < 0 || len < (size_t)precision);
+      len++);
+  if(len >= room) {
+    /* Keep what fits, and let the next argument find the slot full. */
+    memcpy(&s->args[s->len], str, room - 1);
+    s->args[ARGS_SIZE - 1] = '\0';
+    s->len = ARGS_SIZE;
+    return 0;
+  }
+  memcpy(&s->args[s->len], str, len);
+  s->args[s->len + len] = '\0';
+  s->len += len + 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+#define PUT(type) do {                                  \
+    type v = va_arg(*ap, type);                         \
+    if(!put_arg(s, &v, sizeof(v))) {                    \
+      return 0;                                         \
+    }                                                   \
+  } while(0)
+
+#define PUT_INT(var) do {                               \
+    var = va_arg(*ap, int);                             \
+    if(!put_arg(s, &var, sizeof(var))) {                \
+      return 0;                                         \
+    }                                                   \
+  } while(0)
+/*---------------------------------------------------------------------------*/
+/*
+ * Copies the arguments of each conversion of the format in turn, and
+ * returns zero if they did not all fit the slot.
+ */
+static int
+put_args(struct slot *s, const char *fmt, va_list *ap)
+{
+  char length;
+  char length2;
+  int precision;
+
+  for(; *fmt != '\0'; fmt++) {
+    if(*fmt != '%') {
+      continue;
+    }
+    fmt++;
+
+    /* Flags */
+    while(*fmt == '-' || *fmt == '+' || *fmt == ' ' ||
+          *fmt == '#' || *fmt == '0') {
+      fmt++;
+    }
+
+    /* Width and precision */
+    if(*fmt == '*') {
+      PUT(int);
+      fmt++;
+    }
+    while(*fmt >= '0' && *fmt <= '9') {
+      fmt++;
+    }
+    precision = -1;
+    if(*fmt == '.') {
+      fmt++;
+      if(*fmt == '*') {
+        PUT_INT(precision);
+        fmt++;
+      } else {
+        precision = 0;
+        while(*fmt >= '0' && *fmt <= '9') {
+          precision = precision * 10 + *fmt++ - '0';
+        }
+      }
+    }
+
+    /* Length modifier */
+    length = '\0';
+    length2 = '\0';
+    if(*fmt == 'h' || *fmt == 'l' || *fmt == 'z' ||
+       *fmt == 'j' || *fmt == 't' || *fmt == 'L') {
+      length = *fmt++;
+      if((length == 'h' || length == 'l') && *fmt == length) {
+        length2 = *fmt++;
+      }
+    }
+
+    switch(*fmt) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      if(length == 'l' && length2 == 'l') {
+        PUT(long long);
+      } else if(length == 'l') {
+        PUT(long);
+      } else if(length == 'z') {
+        PUT(size_t);
+      } else if(length == 'j') {
+        PUT(intmax_t);
+      } else if(length == 't') {
+        PUT(ptrdiff_t);
+      } else {
+        /* Also char and short, which are promoted to int. */
+        PUT(int);
+      }
+      break;
+    case 'c':
+      PUT(int);
+      break;
+    case 'p':
+      PUT(void *);
+      break;
+    case 's':
+      if(!put_string(s, va_arg(*ap, const char *), precision)) {
+        return 0;
+      }
+      break;
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      if(length == 'L') {
+        double v = (double)va_arg(*ap, long double);
+        if(!put_arg(s, &v, sizeof(v))) {
+          return 0;
+        }
+      } else {
+        PUT(double);
+      }
+      break;
+    case '%':
+      break;
+    case 'n':
+      (void)va_arg(*ap, void *);
+      break;
+    default:
+      /* The types of any further arguments are unknown. */
+      return *fmt == '\0';
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_write(const char *record, ...)
+{
+  uint8_t put;
+  uint32_t id;
+  clock_time_t now;
+  struct slot *s;
+  const char *fmt;
+  int fields;
+  int complete;
+  va_list ap;
+
+  do {
+    put = put_index;
+    if((uint8_t)(put - get_index) >= LOG_BINARY_SLOTS) {
+      count_drop();
+      return;
+    }
+  } while(!atomic_cas_uint8((uint8_t *)&put_index, put, put + 1));
+
+  s = &slots[put & (LOG_BINARY_SLOTS - 1)];
+  id = (uint32_t)(record - __start_log_fmt);
+  now = clock_time();
+  s->len = 0;
+  s->id[0] = id & 0xff;
+  s->id[1] = (id >> 8) & 0xff;
+  s->id[2] = (id >> 16) & 0xff;
+  s->id[3] = (id >> 24) & 0xff;
+  s->time[0] = now & 0xff;
+  s->time[1] = (now >> 8) & 0xff;
+  s->time[2] = ((uint32_t)now >> 16) & 0xff;
+  s->time[3] = ((uint32_t)now >> 24) & 0xff;
+
+  /* The format follows the other fields of the record. */
+  fmt = record;
+  for(fields = 0; fields < 4; fmt++) {
+    if(*fmt == LOG_BINARY_SEPARATOR[0]) {
+      fields++;
+    }
+  }
+
+  va_start(ap, record);
+  complete = put_args(s, fmt, &ap);
+  va_end(ap);
+
+  memory_barrier();
+  s->state = complete ? SLOT_READY : SLOT_TRUNCATED;
+  process_poll(&log_binary_process);
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_output(const uint8_t *data, uint8_t len)
+{
+  while(len-- > 0) {
+    putchar(*data++);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Writes a frame, given the header that starts with the length. */
+static void
+output_frame(const uint8_t *header, const uint8_t *args)
+{
+  uint8_t frame[HEADER_SIZE + ARGS_SIZE + 1];
+  uint8_t len = header[0];
+  uint8_t sum;
+  int i;
+
+  frame[0] = LOG_BINARY_MAGIC;
+  memcpy(&frame[1], header, HEADER_SIZE - 1);
+  memcpy(&frame[HEADER_SIZE], args, len);
+  sum = 0;
+  for(i = 1; i < HEADER_SIZE + len; i++) {
+    sum += frame[i];
+  }
+  frame[HEADER_SIZE + len] = ~sum;
+  LOG_BINARY_OUTPUT(frame, HEADER_SIZE + len + 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+report_drops(void)
+{
+  uint8_t dropped;
+  uint8_t header[HEADER_SIZE - 1];
+  uint8_t args[2];
+  clock_time_t now;
+
+  do {
+    dropped = dropped_pending;
+    if(dropped == 0) {
+      return;
+    }
+  } while(!atomic_cas_uint8((uint8_t *)&dropped_pending, dropped, 0));
+
+  stats.dropped += dropped;
+
+  now = clock_time();
+  header[0] = sizeof(args);
+  header[1] = LOG_BINARY_ID_DROPPED & 0xff;
+  header[2] = (LOG_BINARY_ID_DROPPED >> 8) & 0xff;
+  header[3] = (LOG_BINARY_ID_DROPPED >> 16) & 0xff;
+  header[4] = (LOG_BINARY_ID_DROPPED >> 24) & 0xff;
+  header[5] = now & 0xff;
+  header[6] = (now >> 8) & 0xff;
+  header[7] = ((uint32_t)now >> 16) & 0xff;
+  header[8] = ((uint32_t)now >> 24) & 0xff;
+  args[0] = dropped;
+  args[1] = 0;
+  output_frame(header, args);
+}
+/*---------------------------------------------------------------------------*/
+/* Writes the oldest record, unless it is still being logged. */
+static int
+drain_one(void)
+{
+  struct slot *s;
+
+  s = &slots[get_index & (LOG_BINARY_SLOTS - 1)];
+  if(s->state == SLOT_FREE) {
+    if(put_index == get_index) {
+      /* Report the drops once the records before them are written. */
+      report_drops();
+    }
+    return 0;
+  }
+
+  stats.records++;
+  if(s->state == SLOT_TRUNCATED) {
+    stats.truncated++;
+  }
+  output_frame(&s->len, s->args);
+
+  s->state = SLOT_FREE;
+  memory_barrier();
+  get_index++;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_flush(void)
+{
+  while(drain_one());
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_stats(struct log_binary_stats *s)
+{
+  *s = stats;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_init(void)
+{
+  process_start(&log_binary_process, NULL);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(log_binary_process, ev, data)
+{
+  static int i;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    for(i = 0; i < LOG_BINARY_DRAIN_BATCH && drain_one(); i++);
+
+    if(i < LOG_BINARY_DRAIN_BATCH) {
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+    } else {
+      /* Queue behind the events of other processes before going on. */
+      if(process_post(PROCESS_CURRENT(), PROCESS_EVENT_CONTINUE, NULL) !=
+         PROCESS_ERR_OK) {
+        process_poll(PROCESS_CURRENT());
+      }
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE ||
+                               ev == PROCESS_EVENT_POLL);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+#endif /* LOG_BINARY */
+
+/** @} */
+/** @} */
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Header file for binary, deferred logging
+ */
+
+/** \addtogroup sys
+ * @{ */
+
+/** \addtogroup log
+ * @{
+ *
+ * With LOG_CONF_BINARY enabled, the LOG macros do not format any text
+ * on the device. Each call site instead places a record with its level,
+ * module and format string in the log_fmt section of the firmware, and
+ * the call only copies the offset of that record and the raw arguments
+ * into a slot of a lock-free ring. A low-priority process drains the
+ * ring to the output as frames of the following form, where all header
+ * fields are little-endian and the arguments are in the byte order and
+ * sizes of the device:
+ *
+ * | 0x1e | length | id (4) | clock time (4) | arguments | checksum |
+ *
+ * The checksum is the one's complement of the 8-bit sum of the bytes
+ * from length to the last argument. Strings are copied into the frame,
+ * truncated if needed. Any bytes outside frames, such as printf output,
+ * are left untouched, and tools/log-binary/log-binary-decode.py prints
+ * the stream as text, with the format table taken from the ELF file of
+ * the firmware.
+ */
+
+#ifndef LOG_BINARY_H_
+#define LOG_BINARY_H_
+
+#include "contiki.h"
+
+/** The number of ring slots, a power of two of at most 128 */
+#ifdef LOG_BINARY_CONF_SLOTS
+#define LOG_BINARY_SLOTS LOG_BINARY_CONF_SLOTS
+#else /* LOG_BINARY_CONF_SLOTS */
+#define LOG_BINARY_SLOTS 16
+#endif /* LOG_BINARY_CONF_SLOTS */
+
+/** The size of a slot, which holds 10 bytes of header and the arguments */
+#ifdef LOG_BINARY_CONF_SLOT_SIZE
+#define LOG_BINARY_SLOT_SIZE LOG_BINARY_CONF_SLOT_SIZE
+#else /* LOG_BINARY_CONF_SLOT_SIZE */
+#define LOG_BINARY_SLOT_SIZE 50
+#endif /* LOG_BINARY_CONF_SLOT_SIZE */
+
+/** The most records that the process drains before it yields */
+#ifdef LOG_BINARY_CONF_DRAIN_BATCH
+#define LOG_BINARY_DRAIN_BATCH LOG_BINARY_CONF_DRAIN_BATCH
+#else /* LOG_BINARY_CONF_DRAIN_BATCH */
+#define LOG_BINARY_DRAIN_BATCH 4
+#endif /* LOG_BINARY_CONF_DRAIN_BATCH */
+
+/*
+ * Custom output function for frames -- the default writes them with
+ * putchar.
+ */
+#ifdef LOG_BINARY_CONF_OUTPUT
+#define LOG_BINARY_OUTPUT(data, len) LOG_BINARY_CONF_OUTPUT(data, len)
+#else /* LOG_BINARY_CONF_OUTPUT */
+#define LOG_BINARY_OUTPUT(data, len) log_binary_output(data, len)
+#endif /* LOG_BINARY_CONF_OUTPUT */
+
+#define LOG_BINARY_MAGIC        0x1e
+#define LOG_BINARY_SEPARATOR    "\x1f"
+/** The id of the frame that reports records dropped on a full ring */
+#define LOG_BINARY_ID_DROPPED   0xffffffffUL
+
+#if (LOG_BINARY_SLOTS & (LOG_BINARY_SLOTS - 1)) != 0 || LOG_BINARY_SLOTS > 128
+#error LOG_BINARY_CONF_SLOTS must be a power of two of at most 128
+#endif
+
+#define LOG_BINARY_STR_(x)      #x
+#define LOG_BINARY_STR(x)       LOG_BINARY_STR_(x)
+
+#if LOG_WITH_LOC
+#define LOG_BINARY_LOC          __FILE__ ": " LOG_BINARY_STR(__LINE__)
+#else /* LOG_WITH_LOC */
+#define LOG_BINARY_LOC          ""
+#endif /* LOG_WITH_LOC */
+
+/*
+ * Places the record of a call site in the format table and logs it.
+ * The record holds the newline flag, the level, the module, the
+ * location and the format, separated by LOG_BINARY_SEPARATOR. The
+ * format must be a string literal.
+ */
+#define LOG_BINARY_RECORD(newline, levelstr, module, fmt, ...) do { \
+    static const char log_binary_record_[] \
+    __attribute__((section("log_fmt"), aligned(1))) = \
+      #newline LOG_BINARY_SEPARATOR levelstr LOG_BINARY_SEPARATOR \
+      module LOG_BINARY_SEPARATOR LOG_BINARY_LOC LOG_BINARY_SEPARATOR fmt; \
+    log_binary_write(log_binary_record_, ##__VA_ARGS__); \
+  } while(0)
+
+struct log_binary_stats {
+  /** The number of records logged. */
+  unsigned long records;
+  /** The number of records dropped because the ring was full. */
+  unsigned long dropped;
+  /** The number of records with arguments that did not fit a slot. */
+  unsigned long truncated;
+};
+
+/**
+ * \brief        Log a record without formatting it
+ * \param record The record of the call site, in the log_fmt section
+ *
+ *               This function is safe to call from interrupts. The
+ *               format of the record is only scanned to find the types
+ *               of the arguments, which are copied as they are. When
+ *               the ring is full, the record is dropped and counted.
+ */
+void log_binary_write(const char *record, ...);
+
+/**
+ * \brief        Write all logged records to the output at once
+ */
+void log_binary_flush(void);
+
+/**
+ * \brief        The default output function for frames
+ * \param data   The frame
+ * \param len    The length of the frame
+ */
+void log_binary_output(const uint8_t *data, uint8_t len);
+
+/**
+ * \brief        Obtain statistics on the binary log
+ * \param stats  A pointer to an object that will be filled in.
+ */
+void log_binary_stats(struct log_binary_stats *stats);
+
+/**
+ * \brief        Start the process that drains the ring
+ *
+ *               Records may be logged before this is called; they are
+ *               written once the process has started.
+ */
+void log_binary_init(void);
+
+#endif /* LOG_BINARY_H_ */
+
+/** @} */
+/** @} */
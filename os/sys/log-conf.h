@@ -75,8 +75,17 @@
 #define LOG_WITH_ANNOTATE 0
 #endif /* LOG_CONF_WITH_ANNOTATE */
 
+/* Log records in binary and write them later, see sys/log-binary.h */
+#ifdef LOG_CONF_BINARY
+#define LOG_BINARY LOG_CONF_BINARY
+#else /* LOG_CONF_BINARY */
+#define LOG_BINARY 0
+#endif /* LOG_CONF_BINARY */
+
 /* Custom output function -- default is printf */
-#ifdef LOG_CONF_OUTPUT
+#if LOG_BINARY
+#define LOG_OUTPUT(...) LOG_BINARY_RECORD(0, "", "", __VA_ARGS__)
+#elif defined(LOG_CONF_OUTPUT)
 #define LOG_OUTPUT(...) LOG_CONF_OUTPUT(__VA_ARGS__)
 #else /* LOG_CONF_OUTPUT */
 #define LOG_OUTPUT(...) printf(__VA_ARGS__)
@@ -131,13 +131,20 @@ log_lladdr(const linkaddr_t *lladdr)
     LOG_OUTPUT("(NULL LL addr)");
     return;
   } else {
+    static const char hex[] = "0123456789abcdef";
+    char buf[LINKADDR_SIZE * 3];
+    char *p = buf;
     unsigned int i;
+    /* Output the address at once, as a single record of a binary log. */
     for(i = 0; i < LINKADDR_SIZE; i++) {
       if(i > 0 && i % 2 == 0) {
-        LOG_OUTPUT(".");
+        *p++ = '.';
       }
-      LOG_OUTPUT("%02x", lladdr->u8[i]);
+      *p++ = hex[lladdr->u8[i] >> 4];
+      *p++ = hex[lladdr->u8[i] & 0xf];
     }
+    *p = '\0';
+    LOG_OUTPUT("%s", buf);
   }
 }
 /*---------------------------------------------------------------------------*/
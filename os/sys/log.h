@@ -54,6 +54,7 @@
 #include <stdio.h>
 #include "net/linkaddr.h"
 #include "sys/log-conf.h"
+#include "sys/log-binary.h"
 #if NETSTACK_CONF_WITH_IPV6
 #include "net/ipv6/uip.h"
 #endif /* NETSTACK_CONF_WITH_IPV6 */
@@ -103,6 +104,22 @@ extern struct log_module all_modules[];
 
 /* Main log function */
 
+#if LOG_BINARY
+/* Place a record of the call site in the format table, see log-binary.h */
+#if LOG_WITH_MODULE_PREFIX
+#define LOG(newline, level, levelstr, ...) do {  \
+                            if(level <= (LOG_LEVEL)) { \
+                              LOG_BINARY_RECORD(newline, levelstr, LOG_MODULE, __VA_ARGS__); \
+                            } \
+                          } while (0)
+#else /* LOG_WITH_MODULE_PREFIX */
+#define LOG(newline, level, levelstr, ...) do {  \
+                            if(level <= (LOG_LEVEL)) { \
+                              LOG_BINARY_RECORD(newline, "", "", __VA_ARGS__); \
+                            } \
+                          } while (0)
+#endif /* LOG_WITH_MODULE_PREFIX */
+#else /* LOG_BINARY */
 #define LOG(newline, level, levelstr, ...) do {  \
                             if(level <= (LOG_LEVEL)) { \
                               if(newline) { \
@@ -116,6 +133,7 @@ extern struct log_module all_modules[];
                               LOG_OUTPUT(__VA_ARGS__); \
                             } \
                           } while (0)
+#endif /* LOG_BINARY */
 
 /* For Cooja annotations */
 #define LOG_ANNOTATE(...) do {  \
@@ -47,6 +47,8 @@
 
 #include "contiki.h"
 #include "sys/process.h"
+#include "sys/atomic.h"
+#include "sys/critical.h"
 
 /*
  * Pointer to the currently running process structure.
@@ -65,14 +67,38 @@ struct event_data {
   struct process *p;
 };
 
-static process_num_events_t nevents, fevent;
-static struct event_data events[PROCESS_CONF_NUMEVENTS];
+/*
+ * One ring of events per priority level.
+ */
+struct event_queue {
+  process_num_events_t nevents, fevent;
+  struct event_data events[PROCESS_CONF_NUMEVENTS];
+};
+
+static struct event_queue queues[PROCESS_PRIO_LEVELS];
+
+/* The total number of events in all queues. */
+static int nevents;
 
 #if PROCESS_CONF_STATS
-process_num_events_t process_maxevents;
+int process_maxevents;
+unsigned short process_overflows[PROCESS_PRIO_LEVELS];
+unsigned short process_maxpolls;
+clock_time_t process_maxpolllatency;
+#endif
+
+/*
+ * Queue of processes with a pending poll request. Processes are
+ * linked through their pollnext field, and the queue may be appended
+ * to from interrupt context.
+ */
+static struct process *volatile poll_head;
+static struct process *volatile poll_tail;
+#if PROCESS_CONF_STATS
+static unsigned short npolls;
 #endif
 
-static volatile unsigned char poll_requested;
+#define poll_requested (poll_head != NULL)
 
 #define PROCESS_STATE_NONE        0
 #define PROCESS_STATE_RUNNING     1
@@ -207,11 +233,23 @@ process_exit(struct process *p)
 void
 process_init(void)
 {
+  int i;
+
   lastevent = PROCESS_EVENT_MAX;
 
-  nevents = fevent = 0;
+  for(i = 0; i < PROCESS_PRIO_LEVELS; i++) {
+    queues[i].nevents = queues[i].fevent = 0;
+#if PROCESS_CONF_STATS
+    process_overflows[i] = 0;
+#endif /* PROCESS_CONF_STATS */
+  }
+  nevents = 0;
+  poll_head = poll_tail = NULL;
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
+  process_maxpolls = 0;
+  process_maxpolllatency = 0;
+  npolls = 0;
 #endif /* PROCESS_CONF_STATS */
 
   process_current = process_list = NULL;
@@ -225,13 +263,39 @@ static void
 do_poll(void)
 {
   struct process *p;
+  struct process *next;
+  int_master_status_t status;
+#if PROCESS_CONF_STATS
+  clock_time_t latency;
+#endif /* PROCESS_CONF_STATS */
+
+  /*
+   * Detach the current queue of poll requests. Processes that are
+   * polled while we are calling the handlers below end up in a new
+   * queue, and are serviced in the next round.
+   */
+  status = critical_enter();
+  p = poll_head;
+  poll_head = poll_tail = NULL;
+#if PROCESS_CONF_STATS
+  npolls = 0;
+#endif /* PROCESS_CONF_STATS */
+  critical_exit(status);
 
-  poll_requested = 0;
   /* Call the processes that needs to be polled. */
-  for(p = process_list; p != NULL; p = p->next) {
-    if(p->needspoll) {
+  for(; p != NULL; p = next) {
+    next = p->pollnext;
+    p->pollnext = NULL;
+    p->needspoll = 0;
+#if PROCESS_CONF_STATS
+    latency = clock_time() - p->polltime;
+    if(latency > process_maxpolllatency) {
+      process_maxpolllatency = latency;
+    }
+#endif /* PROCESS_CONF_STATS */
+    /* The process may have exited after the poll was requested. */
+    if(process_is_running(p)) {
       p->state = PROCESS_STATE_RUNNING;
-      p->needspoll = 0;
       call_process(p, PROCESS_EVENT_POLL, NULL);
     }
   }
@@ -249,6 +313,7 @@ do_event(void)
   process_data_t data;
   struct process *receiver;
   struct process *p;
+  struct event_queue *q;
 
   /*
    * If there are any events in the queue, take the first one and walk
@@ -260,15 +325,19 @@ do_event(void)
 
   if(nevents > 0) {
 
+    /* Pick the queue of the highest priority level that has events. */
+    for(q = &queues[PROCESS_PRIO_LEVELS - 1]; q->nevents == 0; q--);
+
     /* There are events that we should deliver. */
-    ev = events[fevent].ev;
+    ev = q->events[q->fevent].ev;
 
-    data = events[fevent].data;
-    receiver = events[fevent].p;
+    data = q->events[q->fevent].data;
+    receiver = q->events[q->fevent].p;
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    q->fevent = (q->fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    --q->nevents;
     --nevents;
 
     /* If this is a broadcast event, we deliver it to all events, in
@@ -322,6 +391,7 @@ int
 process_post(struct process *p, process_event_t ev, process_data_t data)
 {
   process_num_events_t snum;
+  struct event_queue *q;
 
   if(PROCESS_CURRENT() == NULL) {
     PRINTF("process_post: NULL process posts event %d to process '%s', nevents %d\n",
@@ -332,7 +402,19 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
            p == PROCESS_BROADCAST ? "<broadcast>" : PROCESS_NAME_STRING(p), nevents);
   }
 
-  if(nevents == PROCESS_CONF_NUMEVENTS) {
+  /* Broadcast events are queued at the priority of the poster. */
+  if(p != PROCESS_BROADCAST) {
+    q = &queues[PROCESS_PRIO_CAP(p->prio)];
+  } else if(PROCESS_CURRENT() != NULL) {
+    q = &queues[PROCESS_PRIO_CAP(PROCESS_CURRENT()->prio)];
+  } else {
+    q = &queues[PROCESS_PRIO_NORMAL];
+  }
+
+  if(q->nevents == PROCESS_CONF_NUMEVENTS) {
+#if PROCESS_CONF_STATS
+    process_overflows[q - queues]++;
+#endif /* PROCESS_CONF_STATS */
 #if DEBUG
     if(p == PROCESS_BROADCAST) {
       printf("soft panic: event queue is full when broadcast event %d was posted from %s\n", ev, PROCESS_NAME_STRING(process_current));
@@ -343,10 +425,11 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
     return PROCESS_ERR_FULL;
   }
 
-  snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
-  events[snum].ev = ev;
-  events[snum].data = data;
-  events[snum].p = p;
+  snum = (process_num_events_t)(q->fevent + q->nevents) % PROCESS_CONF_NUMEVENTS;
+  q->events[snum].ev = ev;
+  q->events[snum].data = data;
+  q->events[snum].p = p;
+  ++q->nevents;
   ++nevents;
 
 #if PROCESS_CONF_STATS
@@ -370,11 +453,34 @@ process_post_synch(struct process *p, process_event_t ev, process_data_t data)
 void
 process_poll(struct process *p)
 {
+  int_master_status_t status;
+
   if(p != NULL) {
     if(p->state == PROCESS_STATE_RUNNING ||
        p->state == PROCESS_STATE_CALLED) {
-      p->needspoll = 1;
-      poll_requested = 1;
+      /* Only the caller that sets the flag may queue the process. */
+      if(!atomic_cas_uint8((uint8_t *)&p->needspoll, 0, 1)) {
+        return;
+      }
+
+      p->pollnext = NULL;
+#if PROCESS_CONF_STATS
+      p->polltime = clock_time();
+#endif /* PROCESS_CONF_STATS */
+
+      status = critical_enter();
+      if(poll_tail == NULL) {
+        poll_head = p;
+      } else {
+        poll_tail->pollnext = p;
+      }
+      poll_tail = p;
+#if PROCESS_CONF_STATS
+      if(++npolls > process_maxpolls) {
+        process_maxpolls = npolls;
+      }
+#endif /* PROCESS_CONF_STATS */
+      critical_exit(status);
     }
   }
 }
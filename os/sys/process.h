@@ -88,6 +88,30 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/**
+ * \name Process priorities
+ *
+ * Events are queued in one FIFO per priority level, each holding up
+ * to PROCESS_CONF_NUMEVENTS events. The event queue of the highest
+ * priority level that has pending events is always serviced first. An
+ * event is queued at the priority of the receiving process; broadcast
+ * events are queued at the priority of the posting process.
+ *
+ * With the default single level, all processes share one queue.
+ * @{
+ */
+#ifndef PROCESS_CONF_PRIO_LEVELS
+#define PROCESS_CONF_PRIO_LEVELS 1
+#endif /* PROCESS_CONF_PRIO_LEVELS */
+
+#define PROCESS_PRIO_LEVELS PROCESS_CONF_PRIO_LEVELS
+
+/** The priority of processes declared with PROCESS() */
+#define PROCESS_PRIO_NORMAL   0
+/** The highest priority, intended for the network stack and timers */
+#define PROCESS_PRIO_HIGH     (PROCESS_PRIO_LEVELS - 1)
+/** @} */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -298,18 +322,40 @@ static PT_THREAD(process_thread_##name(struct pt *process_pt,	\
  *
  * \hideinitializer
  */
-#if PROCESS_CONF_NO_PROCESS_NAMES
 #define PROCESS(name, strname)				\
+  PROCESS_PRIO(name, strname, PROCESS_PRIO_NORMAL)
+
+/**
+ * Declare a process with a given priority.
+ *
+ * This macro works like PROCESS(), but also sets the priority at
+ * which events to the process are queued. Priorities range from
+ * PROCESS_PRIO_NORMAL to PROCESS_PRIO_HIGH; a priority above the
+ * number of configured levels is capped to the highest level.
+ *
+ * \param name The variable name of the process structure.
+ * \param strname The string representation of the process' name.
+ * \param prio The priority of the process.
+ *
+ * \hideinitializer
+ */
+#if PROCESS_CONF_NO_PROCESS_NAMES
+#define PROCESS_PRIO(name, strname, prio)		\
   PROCESS_THREAD(name, ev, data);			\
   struct process name = { NULL,		        \
-                          process_thread_##name }
+                          process_thread_##name,	\
+                          PROCESS_PRIO_CAP(prio) }
 #else
-#define PROCESS(name, strname)				\
+#define PROCESS_PRIO(name, strname, prio)		\
   PROCESS_THREAD(name, ev, data);			\
   struct process name = { NULL, strname,		\
-                          process_thread_##name }
+                          process_thread_##name,	\
+                          PROCESS_PRIO_CAP(prio) }
 #endif
 
+#define PROCESS_PRIO_CAP(prio)                                  \
+  ((prio) < PROCESS_PRIO_LEVELS ? (prio) : PROCESS_PRIO_HIGH)
+
 /** @} */
 
 struct process {
@@ -321,8 +367,15 @@ struct process {
 #define PROCESS_NAME_STRING(process) (process)->name
 #endif
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
+  unsigned char prio;
   struct pt pt;
   unsigned char state, needspoll;
+  /* Link in the queue of processes waiting to be polled */
+  struct process *pollnext;
+#if PROCESS_CONF_STATS
+  /* The time at which the pending poll request was queued */
+  clock_time_t polltime;
+#endif /* PROCESS_CONF_STATS */
 };
 
 /**
@@ -463,7 +516,10 @@ process_event_t process_alloc_event(void);
  * Request a process to be polled.
  *
  * This function typically is called from an interrupt handler to
- * cause a process to be polled.
+ * cause a process to be polled. The process is appended to a queue
+ * of pending poll requests, so the cost of servicing polls does not
+ * depend on the total number of processes in the system. Polling a
+ * process that already has a pending poll request has no effect.
  *
  * \param p A pointer to the process' process structure.
  */
@@ -525,6 +581,17 @@ extern struct process *process_list;
 
 #define PROCESS_LIST() process_list
 
+#if PROCESS_CONF_STATS
+/** The maximum number of events that have been waiting in the queues */
+extern int process_maxevents;
+/** The number of events dropped because the queue of a level was full */
+extern unsigned short process_overflows[PROCESS_PRIO_LEVELS];
+/** The maximum number of processes that have been waiting to be polled */
+extern unsigned short process_maxpolls;
+/** The maximum time (in clock ticks) from process_poll() to delivery */
+extern clock_time_t process_maxpolllatency;
+#endif /* PROCESS_CONF_STATS */
+
 #endif /* PROCESS_H_ */
 
 /** @} */
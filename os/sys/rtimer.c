@@ -54,6 +54,184 @@
 #define PRINTF(...)
 #endif
 
+#if RTIMER_MULTIPLEX
+#include "sys/critical.h"
+
+/* Pending tasks, sorted on time. */
+static struct rtimer *queue;
+static struct rtimer_stats stats;
+
+/*---------------------------------------------------------------------------*/
+void
+rtimer_init(void)
+{
+  queue = NULL;
+  rtimer_arch_init();
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Set the hardware timer for the head of the queue. A time that has
+ * passed, or is about to, is moved forward by the guard time, so that
+ * the timer is never set in the past.
+ */
+static void
+schedule_head(void)
+{
+  rtimer_clock_t earliest;
+
+  if(queue == NULL) {
+    return;
+  }
+
+  earliest = RTIMER_NOW() + RTIMER_GUARD_TIME;
+  if(RTIMER_CLOCK_LT(queue->time, earliest)) {
+    rtimer_arch_schedule(earliest);
+  } else {
+    rtimer_arch_schedule(queue->time);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+dequeue(struct rtimer *task)
+{
+  struct rtimer **tp;
+
+  for(tp = &queue; *tp != NULL; tp = &(*tp)->next) {
+    if(*tp == task) {
+      *tp = task->next;
+      break;
+    }
+  }
+  task->next = NULL;
+  task->queued = 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+covers(const struct rtimer *task, rtimer_clock_t time)
+{
+  return !RTIMER_CLOCK_LT(time, task->time) &&
+    RTIMER_CLOCK_LT(time, task->time + task->duration);
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_set_with_priority(struct rtimer *task, rtimer_clock_t time,
+                         rtimer_clock_t duration, rtimer_callback_t func,
+                         void *ptr, uint8_t priority)
+{
+  struct rtimer **tp;
+  int_master_status_t status;
+  int overlap;
+
+  PRINTF("rtimer_set time %lu\n", (unsigned long)time);
+
+  status = critical_enter();
+
+  if(task->queued) {
+    dequeue(task);
+  }
+
+  task->func = func;
+  task->ptr = ptr;
+  task->time = time;
+  task->duration = duration;
+  task->priority = priority;
+
+  /* Tasks that are due at the same time keep the order they were set in. */
+  overlap = 0;
+  for(tp = &queue;
+      *tp != NULL && !RTIMER_CLOCK_LT(time, (*tp)->time);
+      tp = &(*tp)->next) {
+    overlap |= covers(*tp, time);
+  }
+  if(*tp != NULL) {
+    overlap |= covers(task, (*tp)->time);
+  }
+  if(overlap) {
+    stats.overlaps++;
+  }
+
+  task->next = *tp;
+  task->queued = 1;
+  *tp = task;
+
+  if(queue == task) {
+    schedule_head();
+  }
+
+  critical_exit(status);
+
+  return RTIMER_OK;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_set(struct rtimer *task, rtimer_clock_t time,
+           rtimer_clock_t duration,
+           rtimer_callback_t func, void *ptr)
+{
+  return rtimer_set_with_priority(task, time, duration, func, ptr,
+                                  RTIMER_PRIO_DEFAULT);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Run the task with the highest priority among those that are due,
+ * and set the hardware timer for the next one. The function may be
+ * called before any task is due, in which case it only sets the
+ * timer again.
+ */
+void
+rtimer_run_next(void)
+{
+  struct rtimer *t, *best;
+  rtimer_clock_t now, lateness, slack;
+  int_master_status_t status;
+
+  status = critical_enter();
+
+  now = RTIMER_NOW();
+  best = NULL;
+  for(t = queue; t != NULL && !RTIMER_CLOCK_LT(now, t->time); t = t->next) {
+    if(best == NULL || t->priority > best->priority) {
+      best = t;
+    }
+  }
+
+  if(best != NULL) {
+    dequeue(best);
+
+    lateness = now - best->time;
+    slack = MAX(best->duration, RTIMER_GUARD_TIME);
+    stats.runs++;
+    stats.total_lateness += lateness;
+    if(lateness > slack) {
+      stats.missed++;
+    }
+    if(lateness > stats.max_lateness) {
+      stats.max_lateness = lateness;
+    }
+  }
+
+  critical_exit(status);
+
+  if(best != NULL) {
+    best->func(best, best->ptr);
+  }
+
+  status = critical_enter();
+  schedule_head();
+  critical_exit(status);
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_stats(struct rtimer_stats *s)
+{
+  int_master_status_t status;
+
+  status = critical_enter();
+  *s = stats;
+  critical_exit(status);
+}
+/*---------------------------------------------------------------------------*/
+#else /* RTIMER_MULTIPLEX */
 static struct rtimer *next_rtimer;
 
 /*---------------------------------------------------------------------------*/
@@ -103,6 +281,7 @@ rtimer_run_next(void)
   }
   return;
 }
+#endif /* RTIMER_MULTIPLEX */
 /*---------------------------------------------------------------------------*/
 
 /** @}*/
@@ -104,6 +104,21 @@ typedef uint64_t rtimer_clock_t;
 #define RTIMER_GUARD_TIME (RTIMER_ARCH_SECOND >> 14)
 #endif /* RTIMER_CONF_GUARD_TIME */
 
+/**
+ * \brief Allow several real-time tasks to be pending at once
+ *
+ * By default, only one real-time task can be pending, and setting
+ * another one replaces it. When enabled, pending tasks are kept in a
+ * queue sorted on time, and the hardware timer is always set for the
+ * task at the head of the queue. Tasks that are due at the same time
+ * are run in order of priority.
+ */
+#ifdef RTIMER_CONF_MULTIPLEX
+#define RTIMER_MULTIPLEX RTIMER_CONF_MULTIPLEX
+#else /* RTIMER_CONF_MULTIPLEX */
+#define RTIMER_MULTIPLEX 0
+#endif /* RTIMER_CONF_MULTIPLEX */
+
 /*---------------------------------------------------------------------------*/
 
 /**
@@ -134,7 +149,35 @@ struct rtimer {
   rtimer_clock_t time;
   rtimer_callback_t func;
   void *ptr;
+#if RTIMER_MULTIPLEX
+  struct rtimer *next;
+  rtimer_clock_t duration;
+  uint8_t priority;
+  uint8_t queued;
+#endif /* RTIMER_MULTIPLEX */
+};
+
+#if RTIMER_MULTIPLEX
+/** The priority of tasks set with rtimer_set() */
+#define RTIMER_PRIO_DEFAULT 0
+
+/**
+ * Statistics on the real-time task queue.
+ */
+struct rtimer_stats {
+  /** The number of tasks that have been run. */
+  unsigned long runs;
+  /** The number of tasks scheduled within the duration of another. */
+  unsigned long overlaps;
+  /** The number of tasks that started after their duration had passed. */
+  unsigned long missed;
+  /** The sum of the times from the scheduled time of a task to its start,
+      which is 64-bit so that fine-grained ticks do not wrap. */
+  uint64_t total_lateness;
+  /** The longest time from the scheduled time of a task to its start. */
+  rtimer_clock_t max_lateness;
 };
+#endif /* RTIMER_MULTIPLEX */
 
 /**
  * TODO: we need to document meanings of these symbols.
@@ -150,7 +193,8 @@ enum {
  * \brief      Post a real-time task.
  * \param task A pointer to the task variable allocated somewhere.
  * \param time The time when the task is to be executed.
- * \param duration Unused argument.
+ * \param duration The time that the task is expected to run. Only used
+ *             when RTIMER_CONF_MULTIPLEX is enabled.
  * \param func A function to be called when the task is executed.
  * \param ptr An opaque pointer that will be supplied as an argument to the callback function.
  * \return     RTIMER_OK if the task could be scheduled. Any other value indicates
@@ -163,6 +207,41 @@ enum {
 int rtimer_set(struct rtimer *task, rtimer_clock_t time,
 	       rtimer_clock_t duration, rtimer_callback_t func, void *ptr);
 
+#if RTIMER_MULTIPLEX
+/**
+ * \brief      Post a real-time task with a priority.
+ * \param task A pointer to the task variable allocated somewhere.
+ * \param time The time when the task is to be executed.
+ * \param duration The time that the task is expected to run.
+ * \param func A function to be called when the task is executed.
+ * \param ptr An opaque pointer that will be supplied as an argument to the callback function.
+ * \param priority The priority of the task. When several tasks are due,
+ *             the one with the highest priority is run first.
+ * \return     RTIMER_OK if the task could be scheduled. Any other value indicates
+ *             the task could not be scheduled.
+ *
+ *             This function schedules a real-time task at a specified
+ *             time in the future, along with the tasks that are
+ *             already pending. If the task is already pending, it is
+ *             moved to the new time. A task whose time falls within
+ *             the duration of another pending task is counted as an
+ *             overlap, but is scheduled all the same.
+ */
+int rtimer_set_with_priority(struct rtimer *task, rtimer_clock_t time,
+                             rtimer_clock_t duration, rtimer_callback_t func,
+                             void *ptr, uint8_t priority);
+
+/**
+ * \brief       Obtain statistics on the real-time task queue.
+ * \param stats A pointer to an object that will be filled in.
+ *
+ *              A task has missed its deadline if it starts later than
+ *              its scheduled time plus its duration, or plus
+ *              RTIMER_GUARD_TIME if that is longer.
+ */
+void rtimer_stats(struct rtimer_stats *stats);
+#endif /* RTIMER_MULTIPLEX */
+
 /**
  * \brief      Execute the next real-time task and schedule the next task, if any
  *
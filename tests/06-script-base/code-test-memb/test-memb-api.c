@@ -98,6 +98,20 @@ main(void)
     printf("- memb_alloc is OK: we cannot get any more memory block\n");
   }
 
+#if MEMB_WITH_STATS
+  if(memb_pool.max != NUM_MEMB_BLOCKS || memb_pool.failures != 1) {
+    printf("test failed: memb statistics report max %u and failures %u, "
+           "which should be %u and 1\n",
+           memb_pool.max, memb_pool.failures, NUM_MEMB_BLOCKS);
+    return -1;
+  } else if(memb_stats_list() != &memb_pool) {
+    printf("test failed: memb_stats_list() does not return the pool\n");
+    return -1;
+  } else {
+    printf("- memb statistics are OK\n");
+  }
+#endif /* MEMB_WITH_STATS */
+
   /* free the allocated memory blocks */
   for(int i = 0; i < NUM_MEMB_BLOCKS; i++) {
     memb_block_p = memb_block_list[i];
@@ -136,6 +150,39 @@ main(void)
     }
   }
 
+  /*
+   * free and allocate blocks in a different order than they were
+   * allocated in, and check that no block is handed out twice
+   */
+  for(int i = 0; i < NUM_MEMB_BLOCKS; i++) {
+    memb_block_list[i] = memb_alloc(&memb_pool);
+  }
+  for(int i = 1; i < NUM_MEMB_BLOCKS; i += 2) {
+    (void)memb_free(&memb_pool, memb_block_list[i]);
+  }
+  for(int i = 1; i < NUM_MEMB_BLOCKS; i += 2) {
+    memb_block_list[i] = memb_alloc(&memb_pool);
+  }
+  for(int i = 0; i < NUM_MEMB_BLOCKS; i++) {
+    for(int j = i + 1; j < NUM_MEMB_BLOCKS; j++) {
+      if(memb_block_list[i] == NULL || memb_block_list[i] == memb_block_list[j]) {
+        printf("test failed: memory block %p is allocated twice\n",
+               memb_block_list[i]);
+        return -1;
+      }
+    }
+  }
+  for(int i = 0; i < NUM_MEMB_BLOCKS; i++) {
+    (void)memb_free(&memb_pool, memb_block_list[i]);
+  }
+  if((ret = memb_numfree(&memb_pool)) != NUM_MEMB_BLOCKS) {
+    printf("test failed: memb_numfree() returns %d after reallocation, "
+           "which should be %d\n", ret, NUM_MEMB_BLOCKS);
+    return -1;
+  } else {
+    printf("- memb_alloc is OK: freed memory blocks are reused\n");
+  }
+
   /* free with a invalid address, which are not the beginning of a block */
   if((memb_block_p = memb_alloc(&memb_pool)) == NULL) {
     printf("test failed: memb_alloc() returns NULL while no memory is used\n");
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Checks that the Internet checksum routines agree with the
+ *         reference routine for random data, lengths, alignments and
+ *         initial sums, and prints how long each takes for a packet.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include "net/ipv6/uip-chksum.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define ROUNDS     20000
+#define MAXLEN     1600
+#define BUFLEN     65536 + 16
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static uint8_t buffer[BUFLEN];
+
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(uint8_t *data, int len)
+{
+  int i;
+  /* Runs of 0x00 and 0xff exercise the carries */
+  int pattern = random_rand() % 4;
+
+  for(i = 0; i < len; i++) {
+    data[i] = pattern == 0 ? 0x00 : pattern == 1 ? 0xff : random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+random_sum(void)
+{
+  switch(random_rand() % 4) {
+  case 0:
+    return 0;
+  case 1:
+    return 0xffff;
+  default:
+    return random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+check(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t expected = uip_chksum_add_ref(sum, data, len);
+
+  if(uip_chksum_add_word(sum, data, len) != expected ||
+     uip_chksum_add(sum, data, len) != expected) {
+    printf("TEST: mismatch for sum 0x%04x, len %u, offset %u: "
+           "ref 0x%04x word 0x%04x uip 0x%04x\n",
+           sum, len, (unsigned)(data - buffer), expected,
+           uip_chksum_add_word(sum, data, len),
+           uip_chksum_add(sum, data, len));
+    return 0;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(chksum_random, "Checksum of random data");
+UNIT_TEST(chksum_random)
+{
+  int i;
+  int offset;
+  int len;
+  int failures = 0;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < ROUNDS; i++) {
+    offset = random_rand() % 16;
+    len = random_rand() % MAXLEN;
+    fill(buffer + offset, len);
+    failures += !check(random_sum(), buffer + offset, len);
+  }
+  printf("TEST: %d rounds, %d failures\n", ROUNDS, failures);
+  UNIT_TEST_ASSERT(failures == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(chksum_edges, "Checksum of edge cases");
+UNIT_TEST(chksum_edges)
+{
+  int offset;
+  int len;
+  int failures = 0;
+
+  UNIT_TEST_BEGIN();
+
+  /* Every short length at every alignment */
+  for(offset = 0; offset < 16; offset++) {
+    for(len = 0; len <= 96; len++) {
+      memset(buffer, 0xff, sizeof(buffer));
+      failures += !check(0xffff, buffer + offset, len);
+      failures += !check(0, buffer + offset, len);
+      memset(buffer, 0, sizeof(buffer));
+      failures += !check(0, buffer + offset, len);
+      failures += !check(0xffff, buffer + offset, len);
+    }
+  }
+
+  /* The longest data, with as many carries as possible */
+  memset(buffer, 0xff, sizeof(buffer));
+  failures += !check(0xffff, buffer, 0xffff);
+  failures += !check(0xfffe, buffer + 1, 0xfffe);
+  fill(buffer, sizeof(buffer));
+  failures += !check(random_sum(), buffer + 3, 0xffff);
+
+  printf("TEST: edge cases, %d failures\n", failures);
+  UNIT_TEST_ASSERT(failures == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+time_ns(uint16_t (*f)(uint16_t, const uint8_t *, uint16_t), uint16_t len)
+{
+  struct timespec start, end;
+  volatile uint16_t sum = 0;
+  int i;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(i = 0; i < ROUNDS; i++) {
+    sum = f(sum, buffer, len);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return ((end.tv_sec - start.tv_sec) * 1000000000UL +
+          end.tv_nsec - start.tv_nsec) / ROUNDS;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+chksum_add(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  return uip_chksum_add(sum, data, len);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(chksum_random);
+  UNIT_TEST_RUN(chksum_edges);
+
+  fill(buffer, 1280);
+  printf("Time per 1280 bytes: ref %lu ns, word %lu ns, uip %lu ns\n",
+         time_ns(uip_chksum_add_ref, 1280), time_ns(uip_chksum_add_word, 1280),
+         time_ns(chksum_add, 1280));
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
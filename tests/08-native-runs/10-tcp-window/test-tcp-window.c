@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Sends a stream over a TCP connection through a simulated link
+ *         with limited bandwidth, delay and random loss, checks that it
+ *         arrives intact and prints the throughput. Both ends of the
+ *         connection run in this node: the link turns every packet
+ *         around, so the connection to fe80::99 loops back to ourselves.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include "net/netstack.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/tcp-socket.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define PORT         8080
+#define TOTAL        32768
+#define TIMEOUT      (90 * CLOCK_SECOND)
+
+/* The simulated link */
+#define LINK_RATE    31250 /* Bytes per second, 250 kbit/s */
+#define LINK_DELAY   (CLOCK_SECOND / 20)
+#ifndef LINK_LOSS
+#define LINK_LOSS    3 /* Percent */
+#endif
+#define LINK_QUEUE   16
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+struct packet {
+  clock_time_t due;
+  uint16_t len;
+  uint8_t data[UIP_BUFSIZE];
+};
+
+static struct packet queue[LINK_QUEUE];
+static uint8_t queue_head, queue_len;
+static clock_time_t link_busy;
+static struct ctimer link_timer;
+static unsigned long link_sent, link_lost;
+
+static struct tcp_socket client, server;
+static uint8_t client_in[64], client_out[2048];
+static uint8_t server_in[UIP_TCP_MSS], server_out[64];
+static uint32_t sent, received, errors;
+static clock_time_t start, end;
+
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void link_deliver(void *ptr);
+
+static void
+link_schedule(void)
+{
+  clock_time_t now = clock_time();
+  clock_time_t due = queue[queue_head].due;
+
+  ctimer_set(&link_timer, due > now ? due - now : 0, link_deliver, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+link_deliver(void *ptr)
+{
+  struct packet *p;
+  uip_ipaddr_t addr;
+
+  p = &queue[queue_head];
+  memcpy(uip_buf, p->data, p->len);
+  uip_len = p->len;
+  queue_head = (queue_head + 1) % LINK_QUEUE;
+  queue_len--;
+  if(queue_len > 0) {
+    link_schedule();
+  }
+
+  /* Swapping the addresses leaves the checksum intact */
+  uip_ipaddr_copy(&addr, &UIP_IP_BUF->srcipaddr);
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &UIP_IP_BUF->destipaddr);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &addr);
+  tcpip_input();
+}
+/*---------------------------------------------------------------------------*/
+static void
+link_init(void)
+{
+  queue_head = queue_len = 0;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+link_output(const linkaddr_t *localdest)
+{
+  struct packet *p;
+  clock_time_t now = clock_time();
+
+  link_sent++;
+  if(queue_len == LINK_QUEUE || random_rand() % 100 < LINK_LOSS) {
+    link_lost++;
+    uipbuf_clear();
+    return 0;
+  }
+
+  /* Packets leave one after the other at the link rate */
+  if(link_busy < now) {
+    link_busy = now;
+  }
+  link_busy += (clock_time_t)uip_len * CLOCK_SECOND / LINK_RATE;
+
+  p = &queue[(queue_head + queue_len) % LINK_QUEUE];
+  p->due = link_busy + LINK_DELAY;
+  p->len = uip_len;
+  memcpy(p->data, uip_buf, uip_len);
+  if(queue_len++ == 0) {
+    link_schedule();
+  }
+  uipbuf_clear();
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const struct network_driver lossy_link_driver = {
+  "lossy link",
+  link_init,
+  NULL,
+  link_output
+};
+/*---------------------------------------------------------------------------*/
+static void
+fill(void)
+{
+  uint8_t buf[256];
+  int i, len;
+
+  while(sent < TOTAL) {
+    len = MIN(sizeof(buf), TOTAL - sent);
+    for(i = 0; i < len; i++) {
+      buf[i] = (sent + i) * 7;
+    }
+    len = tcp_socket_send(&client, buf, len);
+    if(len <= 0) {
+      break;
+    }
+    sent += len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+client_event(struct tcp_socket *s, void *ptr, tcp_socket_event_t event)
+{
+  if(event == TCP_SOCKET_CONNECTED || event == TCP_SOCKET_DATA_SENT) {
+    fill();
+  } else if(event != TCP_SOCKET_CLOSED) {
+    printf("TEST: client event %d\n", event);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+server_input(struct tcp_socket *s, void *ptr, const uint8_t *data, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    if(data[i] != (uint8_t)((received + i) * 7)) {
+      errors++;
+    }
+  }
+  received += len;
+  if(received >= TOTAL) {
+    end = clock_time();
+    process_poll(&test_process);
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+server_event(struct tcp_socket *s, void *ptr, tcp_socket_event_t event)
+{
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(tcp_stream, "TCP stream over a lossy link");
+UNIT_TEST(tcp_stream)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(received == TOTAL);
+  UNIT_TEST_ASSERT(errors == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer timeout;
+  static uip_ipaddr_t peer;
+  static const uip_lladdr_t peer_lladdr = { { 0x02, 0x99 } };
+  unsigned long ms;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  random_init(1);
+  uip_ip6addr(&peer, 0xfe80, 0, 0, 0, 0, 0, 0, 0x99);
+  uip_ds6_nbr_add(&peer, &peer_lladdr, 0, NBR_REACHABLE,
+                  NBR_TABLE_REASON_UNDEFINED, NULL);
+
+  tcp_socket_register(&server, NULL, server_in, sizeof(server_in),
+                      server_out, sizeof(server_out),
+                      server_input, server_event);
+  tcp_socket_listen(&server, PORT);
+  tcp_socket_register(&client, NULL, client_in, sizeof(client_in),
+                      client_out, sizeof(client_out),
+                      NULL, client_event);
+
+  start = clock_time();
+  tcp_socket_connect(&client, &peer, PORT);
+
+  etimer_set(&timeout, TIMEOUT);
+  PROCESS_WAIT_UNTIL(received >= TOTAL || etimer_expired(&timeout));
+
+  ms = (unsigned long)((received >= TOTAL ? end : clock_time()) - start) *
+    1000 / CLOCK_SECOND;
+  printf("TEST: window %u, %lu of %u bytes in %lu ms, %lu bytes/s, "
+         "%lu of %lu packets lost\n",
+         UIP_TCP_SEND_WINDOW, (unsigned long)received, TOTAL, ms,
+         ms > 0 ? (unsigned long)received * 1000 / ms : 0,
+         link_lost, link_sent);
+
+  UNIT_TEST_RUN(tcp_stream);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
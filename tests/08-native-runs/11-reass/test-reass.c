@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Feeds interleaved trains of IPv6 fragments from several sources
+ *         into uIP and checks that each datagram is reassembled, that the
+ *         least recently updated packet is evicted when the contexts run
+ *         out and that an incomplete packet times out.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "net/netstack.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/simple-udp.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define PORT         5683
+#define PAYLOAD_LEN  1000
+#define FRAG_LEN     256
+#define FRAGS        ((UIP_UDPH_LEN + PAYLOAD_LEN + FRAG_LEN - 1) / FRAG_LEN)
+#define SOURCES      (UIP_REASS_CONTEXTS + 1)
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static struct simple_udp_connection conn;
+static uint8_t packets[SOURCES][UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN];
+static uint8_t delivered[SOURCES];
+static unsigned long sent, errors;
+
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+sink_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+sink_output(const linkaddr_t *localdest)
+{
+  sent++;
+  uipbuf_clear();
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const struct network_driver fragment_sink_driver = {
+  "fragment sink",
+  sink_init,
+  NULL,
+  sink_output
+};
+/*---------------------------------------------------------------------------*/
+static void
+receiver(struct simple_udp_connection *c,
+         const uip_ipaddr_t *sender_addr,
+         uint16_t sender_port,
+         const uip_ipaddr_t *receiver_addr,
+         uint16_t receiver_port,
+         const uint8_t *data,
+         uint16_t datalen)
+{
+  int src = sender_addr->u8[15] - 1;
+  int i;
+
+  if(src < 0 || src >= SOURCES || datalen != PAYLOAD_LEN) {
+    errors++;
+    return;
+  }
+  for(i = 0; i < datalen; i++) {
+    if(data[i] != (uint8_t)(src * 31 + i)) {
+      errors++;
+      return;
+    }
+  }
+  delivered[src]++;
+}
+/*---------------------------------------------------------------------------*/
+/* Build an unfragmented UDP datagram from fd00::<src + 1> to us */
+static void
+build_packet(int src, const uip_ipaddr_t *dest)
+{
+  int i;
+
+  uipbuf_clear();
+  memset(UIP_IP_BUF, 0, UIP_IPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, src + 1);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, dest);
+  uipbuf_set_len_field(UIP_IP_BUF, UIP_UDPH_LEN + PAYLOAD_LEN);
+  UIP_UDP_BUF->srcport = UIP_HTONS(PORT);
+  UIP_UDP_BUF->destport = UIP_HTONS(PORT);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  UIP_UDP_BUF->udpchksum = 0;
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    uip_buf[UIP_IPH_LEN + UIP_UDPH_LEN + i] = src * 31 + i;
+  }
+  uip_len = sizeof(packets[src]);
+  uip_ext_len = 0;
+  UIP_UDP_BUF->udpchksum = ~uip_udpchksum();
+  memcpy(packets[src], uip_buf, uip_len);
+}
+/*---------------------------------------------------------------------------*/
+/* Hand fragment number frag of the datagram from src to uIP */
+static void
+input_fragment(int src, int frag)
+{
+  const uint8_t *pkt = packets[src];
+  struct uip_frag_hdr *hdr;
+  uint16_t offset = frag * FRAG_LEN;
+  uint16_t len = MIN(FRAG_LEN, UIP_UDPH_LEN + PAYLOAD_LEN - offset);
+  uint16_t more = frag < FRAGS - 1;
+
+  uipbuf_clear();
+  memcpy(uip_buf, pkt, UIP_IPH_LEN);
+  UIP_IP_BUF->proto = UIP_PROTO_FRAG;
+  uipbuf_set_len_field(UIP_IP_BUF, UIP_FRAGH_LEN + len);
+  hdr = (struct uip_frag_hdr *)&uip_buf[UIP_IPH_LEN];
+  hdr->next = UIP_PROTO_UDP;
+  hdr->res = 0;
+  hdr->offsetresmore = uip_htons(offset | more);
+  hdr->id = uip_htonl(0x1000 + src);
+  memcpy(&uip_buf[UIP_IPH_LEN + UIP_FRAGH_LEN], pkt + UIP_IPH_LEN + offset, len);
+  uip_len = UIP_IPH_LEN + UIP_FRAGH_LEN + len;
+  tcpip_input();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(interleaved, "Interleaved fragment trains");
+UNIT_TEST(interleaved)
+{
+  int src, frag;
+
+  UNIT_TEST_BEGIN();
+
+  memset(delivered, 0, sizeof(delivered));
+  /* One train per context, last fragment first to exercise the bitmap */
+  for(frag = FRAGS - 1; frag >= 0; frag--) {
+    for(src = 0; src < UIP_REASS_CONTEXTS; src++) {
+      input_fragment(src, frag);
+    }
+  }
+
+  for(src = 0; src < UIP_REASS_CONTEXTS; src++) {
+    UNIT_TEST_ASSERT(delivered[src] == 1);
+  }
+  UNIT_TEST_ASSERT(errors == 0);
+  UNIT_TEST_ASSERT(uip_stat.reass.reassembled == UIP_REASS_CONTEXTS);
+  UNIT_TEST_ASSERT(uip_stat.reass.evicted == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(eviction, "Least recently updated packet is evicted");
+UNIT_TEST(eviction)
+{
+  int src, frag;
+
+  UNIT_TEST_BEGIN();
+
+  memset(delivered, 0, sizeof(delivered));
+  /* The first fragment of the last train evicts the first train */
+  for(src = 0; src < SOURCES; src++) {
+    input_fragment(src, 0);
+  }
+  UNIT_TEST_ASSERT(uip_stat.reass.evicted == 1);
+
+  for(frag = 1; frag < FRAGS; frag++) {
+    for(src = 1; src < SOURCES; src++) {
+      input_fragment(src, frag);
+    }
+  }
+  /* The rest of the first train starts over and never completes */
+  input_fragment(0, 1);
+
+  UNIT_TEST_ASSERT(delivered[0] == 0);
+  for(src = 1; src < SOURCES; src++) {
+    UNIT_TEST_ASSERT(delivered[src] == 1);
+  }
+  UNIT_TEST_ASSERT(errors == 0);
+  UNIT_TEST_ASSERT(uip_stat.reass.evicted == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(timeout, "Incomplete packet times out");
+UNIT_TEST(timeout)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(uip_stat.reass.timeout == 1);
+  UNIT_TEST_ASSERT(delivered[0] == 0);
+  /* No Time Exceeded message without the first fragment */
+  UNIT_TEST_ASSERT(sent == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer wait;
+  static uip_ipaddr_t dest;
+  int src;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  simple_udp_register(&conn, PORT, NULL, PORT, receiver);
+  uip_ipaddr_copy(&dest, &uip_ds6_get_link_local(-1)->ipaddr);
+  for(src = 0; src < SOURCES; src++) {
+    build_packet(src, &dest);
+  }
+
+  UNIT_TEST_RUN(interleaved);
+  UNIT_TEST_RUN(eviction);
+
+  etimer_set(&wait, (UIP_REASS_MAXAGE + 1) * CLOCK_SECOND);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+  UNIT_TEST_RUN(timeout);
+
+  printf("TEST: %lu fragments, %lu reassembled, %lu evicted, "
+         "%lu timed out\n",
+         (unsigned long)uip_stat.reass.recv,
+         (unsigned long)uip_stat.reass.reassembled,
+         (unsigned long)uip_stat.reass.evicted,
+         (unsigned long)uip_stat.reass.timeout);
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
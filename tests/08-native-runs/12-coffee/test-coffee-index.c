@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Creates more Coffee files than fit in the name index and checks
+ *         that each of them can be found, that removed files are gone,
+ *         and that file sizes recovered from the end hints after the file
+ *         metadata has been evicted are right, also when the power is
+ *         lost in the middle of an append. Then removes a large
+ *         file and checks that its sectors are erased in the background
+ *         without disturbing the other files, also while new files are
+ *         written between the steps of the collection, and that a writer
+ *         that reserves a file at every step does not hold it back.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "dev/xmem.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define FILES        (COFFEE_CONF_NAME_INDEX_SIZE * 2)
+#define EXTENT       8192
+#define SIZED_FILES  (sizeof(sizes) / sizeof(sizes[0]))
+#define BIG_SIZE     (3 * 65536L - 256)
+#define GC_FILES     48
+#define GC_KEPT      6
+#define GC_SIZE      40000L
+#define CUT_FIRST    100
+#define CUT_APPEND   3000
+#define CUT_LATER    50
+#define LATE_SIZE    (2 * 65536L)
+#define STEADY_FILES 64
+#define STEADY_SIZE  100
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static const cfs_offset_t sizes[] = { 1, 100, 1000, 3000, 5000, 7000, EXTENT };
+static uint8_t buf[EXTENT];
+static unsigned long erasures_before;
+static uint8_t gc_data[GC_SIZE];
+static int gc_written;
+static int gc_lost;
+static unsigned long steady_erasures;
+static int steady_written;
+/* The number of flash writes to do before the power is cut, or -1 */
+static int writes_left = -1;
+
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+test_flash_write(const void *buf, int size, unsigned long offset)
+{
+  if(writes_left == 0) {
+    return size;
+  }
+  if(writes_left > 0) {
+    writes_left--;
+  }
+  return xmem_pwrite(buf, size, offset);
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(uint8_t *data, cfs_offset_t len, unsigned seed)
+{
+  cfs_offset_t i;
+
+  /* Coffee takes trailing zeros to be unwritten space. */
+  for(i = 0; i < len; i++) {
+    data[i] = (seed + i) % 251 + 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_file(const char *name, const uint8_t *data, cfs_offset_t len)
+{
+  static uint8_t tmp[EXTENT];
+  int fd, r;
+
+  fd = cfs_open(name, CFS_READ);
+  if(fd < 0) {
+    return 0;
+  }
+  r = cfs_read(fd, tmp, sizeof(tmp));
+  cfs_close(fd);
+  return r == len && memcmp(tmp, data, len) == 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_file_big(const char *name)
+{
+  static uint8_t tmp[EXTENT];
+  cfs_offset_t total;
+  int fd, r;
+
+  fd = cfs_open(name, CFS_READ);
+  if(fd < 0) {
+    return 0;
+  }
+  total = 0;
+  while((r = cfs_read(fd, tmp, sizeof(tmp))) > 0) {
+    if(memcmp(tmp, gc_data, r) != 0) {
+      break;
+    }
+    total += r;
+  }
+  cfs_close(fd);
+  return total == GC_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+static int
+write_file(const char *name, const uint8_t *data, cfs_offset_t len)
+{
+  int fd, r;
+
+  fd = cfs_open(name, CFS_WRITE);
+  if(fd < 0) {
+    return 0;
+  }
+  r = cfs_write(fd, data, len);
+  cfs_close(fd);
+  return r == len;
+}
+/*---------------------------------------------------------------------------*/
+/* Loading the metadata of other files pushes out what Coffee keeps for
+   the files written earlier, so their ends are found from storage. */
+static void
+evict_file_metadata(void)
+{
+  char name[16];
+  int i;
+
+  for(i = 0; i < FILES; i++) {
+    snprintf(name, sizeof(name), "f%d", i);
+    cfs_close(cfs_open(name, CFS_READ));
+  }
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+erase_total(void)
+{
+  unsigned long total;
+  unsigned sector;
+  int count;
+
+  total = 0;
+  for(sector = 0; (count = cfs_coffee_erase_count(sector)) >= 0; sector++) {
+    total += count;
+  }
+  return total;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(many_files, "Files beyond the name index are found");
+UNIT_TEST(many_files)
+{
+  char name[16];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+
+  for(i = 0; i < FILES; i++) {
+    snprintf(name, sizeof(name), "f%d", i);
+    UNIT_TEST_ASSERT(cfs_open(name, CFS_READ) < 0);
+    UNIT_TEST_ASSERT(write_file(name, (uint8_t *)name, strlen(name)));
+  }
+
+  for(i = 0; i < FILES; i++) {
+    snprintf(name, sizeof(name), "f%d", i);
+    UNIT_TEST_ASSERT(check_file(name, (uint8_t *)name, strlen(name)));
+  }
+
+  /* Remove every other file, both from inside and outside the index. */
+  for(i = 0; i < FILES; i += 2) {
+    snprintf(name, sizeof(name), "f%d", i);
+    UNIT_TEST_ASSERT(cfs_remove(name) == 0);
+  }
+
+  for(i = 0; i < FILES; i++) {
+    snprintf(name, sizeof(name), "f%d", i);
+    if(i % 2 == 0) {
+      UNIT_TEST_ASSERT(cfs_open(name, CFS_READ) < 0);
+    } else {
+      UNIT_TEST_ASSERT(check_file(name, (uint8_t *)name, strlen(name)));
+    }
+  }
+
+  /* Freed index entries are reused. */
+  for(i = 0; i < FILES; i += 2) {
+    snprintf(name, sizeof(name), "f%d", i);
+    UNIT_TEST_ASSERT(write_file(name, (uint8_t *)name, strlen(name)));
+    UNIT_TEST_ASSERT(check_file(name, (uint8_t *)name, strlen(name)));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(end_hints, "File ends are found after reloading");
+UNIT_TEST(end_hints)
+{
+  struct cfs_dir dir;
+  struct cfs_dirent dirent;
+  char name[16];
+  unsigned i, found;
+  int fd;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < SIZED_FILES; i++) {
+    snprintf(name, sizeof(name), "s%u", i);
+    UNIT_TEST_ASSERT(cfs_coffee_reserve(name, EXTENT) == 0);
+    fill(buf, sizes[i], i);
+    UNIT_TEST_ASSERT(write_file(name, buf, sizes[i]));
+  }
+
+  evict_file_metadata();
+
+  for(i = 0; i < SIZED_FILES; i++) {
+    snprintf(name, sizeof(name), "s%u", i);
+    fd = cfs_open(name, CFS_READ);
+    UNIT_TEST_ASSERT(fd >= 0);
+    UNIT_TEST_ASSERT(cfs_seek(fd, 0, CFS_SEEK_END) == sizes[i]);
+    cfs_close(fd);
+  }
+
+  /* The directory listing reads the ends straight from storage. */
+  found = 0;
+  UNIT_TEST_ASSERT(cfs_opendir(&dir, "/") == 0);
+  while(cfs_readdir(&dir, &dirent) == 0) {
+    if(dirent.name[0] == 's') {
+      i = dirent.name[1] - '0';
+      UNIT_TEST_ASSERT(i < SIZED_FILES);
+      UNIT_TEST_ASSERT(dirent.size == sizes[i]);
+      found++;
+    }
+  }
+  cfs_closedir(&dir);
+  UNIT_TEST_ASSERT(found == SIZED_FILES);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(append, "Reads see data written since");
+UNIT_TEST(append)
+{
+  cfs_offset_t len;
+  int fd;
+
+  UNIT_TEST_BEGIN();
+
+  /* Small reads are served from cached pages, which writes to the same
+     pages must invalidate. */
+  fill(buf, EXTENT, 7);
+  UNIT_TEST_ASSERT(cfs_coffee_reserve("append", EXTENT) == 0);
+  for(len = 0; len < 1000; len += 50) {
+    fd = cfs_open("append", CFS_WRITE | CFS_APPEND);
+    UNIT_TEST_ASSERT(fd >= 0);
+    UNIT_TEST_ASSERT(cfs_write(fd, &buf[len], 50) == 50);
+    cfs_close(fd);
+    UNIT_TEST_ASSERT(check_file("append", buf, len + 50));
+  }
+
+  evict_file_metadata();
+  UNIT_TEST_ASSERT(check_file("append", buf, len));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(interrupted_append, "Appends cut by a power loss");
+UNIT_TEST(interrupted_append)
+{
+  char name[16];
+  cfs_offset_t len;
+  int cut;
+  int done;
+  int fd;
+
+  UNIT_TEST_BEGIN();
+
+  /* Cut the power after each of the flash writes of an append that
+     crosses eighths of the extent, until the append completes. */
+  fill(buf, EXTENT, 11);
+  for(cut = 0, done = 0; !done; cut++) {
+    UNIT_TEST_ASSERT(cut < 16);
+    snprintf(name, sizeof(name), "cut%d", cut);
+    UNIT_TEST_ASSERT(cfs_coffee_reserve(name, EXTENT) == 0);
+    UNIT_TEST_ASSERT(write_file(name, buf, CUT_FIRST));
+
+    writes_left = cut;
+    fd = cfs_open(name, CFS_WRITE | CFS_APPEND);
+    UNIT_TEST_ASSERT(fd >= 0);
+    cfs_write(fd, &buf[CUT_FIRST], CUT_APPEND);
+    cfs_close(fd);
+    done = writes_left > 0;
+    writes_left = -1;
+
+    /* After a restart, the file holds either all of the append or none
+       of it, and appending goes on from its end. */
+    evict_file_metadata();
+    fd = cfs_open(name, CFS_READ);
+    UNIT_TEST_ASSERT(fd >= 0);
+    len = cfs_seek(fd, 0, CFS_SEEK_END);
+    cfs_close(fd);
+    UNIT_TEST_ASSERT(len == CUT_FIRST + CUT_APPEND ||
+                     (len == CUT_FIRST && !done));
+    UNIT_TEST_ASSERT(check_file(name, buf, len));
+
+    fd = cfs_open(name, CFS_WRITE | CFS_APPEND);
+    UNIT_TEST_ASSERT(fd >= 0);
+    UNIT_TEST_ASSERT(cfs_write(fd, &buf[len], CUT_LATER) == CUT_LATER);
+    cfs_close(fd);
+    evict_file_metadata();
+    UNIT_TEST_ASSERT(check_file(name, buf, len + CUT_LATER));
+
+    UNIT_TEST_ASSERT(cfs_remove(name) == 0);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(remove_big, "Removing a file does not erase sectors");
+UNIT_TEST(remove_big)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_coffee_reserve("big", BIG_SIZE) == 0);
+  UNIT_TEST_ASSERT(write_file("big", buf, EXTENT));
+
+  erasures_before = erase_total();
+  UNIT_TEST_ASSERT(cfs_remove("big") == 0);
+  UNIT_TEST_ASSERT(erase_total() == erasures_before);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(background_gc, "Obsolete sectors are erased in the background");
+UNIT_TEST(background_gc)
+{
+  char name[16];
+  unsigned i;
+  int fd;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(erase_total() > erasures_before);
+  UNIT_TEST_ASSERT(cfs_open("big", CFS_READ) < 0);
+
+  for(i = 0; i < FILES; i++) {
+    snprintf(name, sizeof(name), "f%u", i);
+    UNIT_TEST_ASSERT(check_file(name, (uint8_t *)name, strlen(name)));
+  }
+  for(i = 0; i < SIZED_FILES; i++) {
+    snprintf(name, sizeof(name), "s%u", i);
+    fd = cfs_open(name, CFS_READ);
+    UNIT_TEST_ASSERT(fd >= 0);
+    UNIT_TEST_ASSERT(cfs_seek(fd, 0, CFS_SEEK_END) == sizes[i]);
+    cfs_close(fd);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(interleaved_gc, "Files written during a collection are kept");
+UNIT_TEST(interleaved_gc)
+{
+  char name[16];
+  unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(gc_written);
+  UNIT_TEST_ASSERT(gc_lost == 0);
+  for(i = GC_FILES - GC_KEPT; i < GC_FILES; i++) {
+    snprintf(name, sizeof(name), "g%u", i);
+    UNIT_TEST_ASSERT(check_file_big(name));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(steady_writer, "Collection keeps up with a steady writer");
+UNIT_TEST(steady_writer)
+{
+  char name[16];
+  unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(steady_written);
+  /* The removed file covered at least one whole sector */
+  UNIT_TEST_ASSERT(erase_total() > steady_erasures);
+  for(i = 0; i < STEADY_FILES; i++) {
+    snprintf(name, sizeof(name), "w%u", i);
+    UNIT_TEST_ASSERT(check_file(name, buf, STEADY_SIZE));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer wait;
+  static unsigned i, j;
+  char name[16];
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(many_files);
+  UNIT_TEST_RUN(end_hints);
+  UNIT_TEST_RUN(append);
+  UNIT_TEST_RUN(interrupted_append);
+  UNIT_TEST_RUN(remove_big);
+
+  etimer_set(&wait, CLOCK_SECOND);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+  UNIT_TEST_RUN(background_gc);
+
+  /*
+   * Write files across sector boundaries while the collection steps
+   * through the sectors, and remove old ones to keep it going. The data
+   * looks like the headers of isolated pages, so a scan that takes file
+   * data for headers would erase the sectors of the files.
+   */
+  memset(gc_data, 0x22, sizeof(gc_data));
+  gc_written = 1;
+  for(i = 0; i < GC_FILES; i++) {
+    if(i >= GC_KEPT) {
+      snprintf(name, sizeof(name), "g%u", i - GC_KEPT);
+      if(!check_file_big(name)) {
+        gc_lost++;
+      }
+      cfs_remove(name);
+    }
+    snprintf(name, sizeof(name), "g%u", i);
+    if(cfs_coffee_reserve(name, GC_SIZE) != 0 ||
+       !write_file(name, gc_data, GC_SIZE)) {
+      gc_written = 0;
+    }
+    for(j = 0; j <= (i * 5) % 16; j++) {
+      PROCESS_PAUSE();
+    }
+  }
+
+  etimer_set(&wait, CLOCK_SECOND);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+  UNIT_TEST_RUN(interleaved_gc);
+
+  for(i = GC_FILES - GC_KEPT; i < GC_FILES; i++) {
+    snprintf(name, sizeof(name), "g%u", i);
+    cfs_remove(name);
+  }
+  etimer_set(&wait, CLOCK_SECOND);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+
+  /* Remove a large file, then reserve a file at every step of the
+     collection, which must still get to the sectors of the large one. */
+  steady_written = cfs_coffee_reserve("late", LATE_SIZE) == 0 &&
+    write_file("late", buf, EXTENT);
+  steady_erasures = erase_total();
+  cfs_remove("late");
+  for(i = 0; i < STEADY_FILES; i++) {
+    snprintf(name, sizeof(name), "w%u", i);
+    if(cfs_coffee_reserve(name, STEADY_SIZE) != 0 ||
+       !write_file(name, buf, STEADY_SIZE)) {
+      steady_written = 0;
+    }
+    PROCESS_PAUSE();
+  }
+  UNIT_TEST_RUN(steady_writer);
+
+  printf("TEST: %lu sector erasures\n", erase_total());
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Fills an Antelope relation with readings and checks that
+ *         sequential scans through the storage cursor return the same
+ *         rows as reading them one at a time, and that selections over
+ *         the relation see every row. Then joins the readings with
+ *         relations that have no index on the join attribute, through a
+ *         block nested-loop join and a hash join.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "antelope.h"
+#include "cfs/cfs-coffee.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define READINGS     300
+#define THRESHOLD    1000
+#define GAINS        100
+#define GAIN_IDS     50
+#define LABELS       60
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static db_handle_t handle;
+
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static long
+reading_value(unsigned id)
+{
+  return (id * 7919L) % 2000;
+}
+/*---------------------------------------------------------------------------*/
+static db_result_t
+run_query(const char *query)
+{
+  db_result_t result;
+
+  result = db_query(&handle, query);
+  if(DB_ERROR(result)) {
+    printf("Query \"%s\" failed: %s\n", query, db_get_result_message(result));
+  }
+  db_free(&handle);
+  return result;
+}
+/*---------------------------------------------------------------------------*/
+static db_result_t
+create_readings(void)
+{
+  char query[AQL_MAX_QUERY_LENGTH];
+  unsigned id;
+
+  if(DB_ERROR(run_query("CREATE RELATION readings;")) ||
+     DB_ERROR(run_query("CREATE ATTRIBUTE id DOMAIN INT IN readings;")) ||
+     DB_ERROR(run_query("CREATE ATTRIBUTE value DOMAIN LONG IN readings;"))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  for(id = 0; id < READINGS; id++) {
+    snprintf(query, sizeof(query), "INSERT (%u, %ld) INTO readings;",
+             id, reading_value(id));
+    if(DB_ERROR(run_query(query))) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+  return DB_OK;
+}
+/*---------------------------------------------------------------------------*/
+static db_result_t
+create_gains(void)
+{
+  char query[AQL_MAX_QUERY_LENGTH];
+  unsigned i;
+
+  if(DB_ERROR(run_query("CREATE RELATION gains;")) ||
+     DB_ERROR(run_query("CREATE ATTRIBUTE id DOMAIN INT IN gains;")) ||
+     DB_ERROR(run_query("CREATE ATTRIBUTE gain DOMAIN LONG IN gains;"))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  /* Each ID appears twice. */
+  for(i = 0; i < GAINS; i++) {
+    snprintf(query, sizeof(query), "INSERT (%u, %u) INTO gains;",
+             i % GAIN_IDS, i);
+    if(DB_ERROR(run_query(query))) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+  return DB_OK;
+}
+/*---------------------------------------------------------------------------*/
+static db_result_t
+create_labels(void)
+{
+  char query[AQL_MAX_QUERY_LENGTH];
+  unsigned i;
+
+  /* Wide rows, so that few of them fit in a block. */
+  if(DB_ERROR(run_query("CREATE RELATION labels;")) ||
+     DB_ERROR(run_query("CREATE ATTRIBUTE id DOMAIN INT IN labels;")) ||
+     DB_ERROR(run_query("CREATE ATTRIBUTE name DOMAIN STRING(16) IN labels;")) ||
+     DB_ERROR(run_query("CREATE ATTRIBUTE unit DOMAIN STRING(16) IN labels;")) ||
+     DB_ERROR(run_query("CREATE ATTRIBUTE place DOMAIN STRING(16) IN labels;"))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  for(i = 0; i < LABELS; i++) {
+    snprintf(query, sizeof(query),
+             "INSERT (%u, 'L%u', 'mV', 'field') INTO labels;", i * 5, i * 5);
+    if(DB_ERROR(run_query(query))) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+  return DB_OK;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(cursor, "Cursor reads rows in batches");
+UNIT_TEST(cursor)
+{
+  static storage_cursor_t cursor;
+  static unsigned char row[DB_MAX_CHAR_SIZE_PER_ROW];
+  static unsigned char expected[DB_MAX_CHAR_SIZE_PER_ROW];
+  relation_t *rel;
+  tuple_id_t tuple_id, batch;
+
+  UNIT_TEST_BEGIN();
+
+  rel = relation_load("readings");
+  UNIT_TEST_ASSERT(rel != NULL);
+  UNIT_TEST_ASSERT(rel->row_length == 6);
+
+  storage_cursor_init(&cursor, rel);
+  for(tuple_id = 0;; tuple_id++) {
+    if(storage_cursor_get_row(&cursor, rel, &tuple_id, row) == DB_FINISHED) {
+      break;
+    }
+    UNIT_TEST_ASSERT(storage_get_row(rel, &tuple_id, expected) == DB_OK);
+    UNIT_TEST_ASSERT(memcmp(row, expected, rel->row_length) == 0);
+  }
+  UNIT_TEST_ASSERT(tuple_id == READINGS);
+
+  batch = DB_SCAN_BUFFER_SIZE / rel->row_length;
+  UNIT_TEST_ASSERT(cursor.reads == (READINGS + batch - 1) / batch);
+  UNIT_TEST_ASSERT(cursor.hits == READINGS - cursor.reads);
+
+  /* Stepping back into the buffered rows does not read them again. */
+  tuple_id = READINGS - 1;
+  UNIT_TEST_ASSERT(storage_cursor_get_row(&cursor, rel, &tuple_id, row) == DB_OK);
+  UNIT_TEST_ASSERT(cursor.hits == READINGS - cursor.reads + 1);
+
+  relation_release(rel);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(select, "Selection scans every row");
+UNIT_TEST(select)
+{
+  attribute_value_t id, value;
+  unsigned expected, matching, i;
+  db_result_t result;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = expected = 0; i < READINGS; i++) {
+    if(reading_value(i) > THRESHOLD) {
+      expected++;
+    }
+  }
+
+  result = db_query(&handle, "SELECT id, value FROM readings WHERE value > %d;",
+                    THRESHOLD);
+  UNIT_TEST_ASSERT(!DB_ERROR(result));
+
+  matching = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      UNIT_TEST_ASSERT(db_get_value(&id, &handle, 0) == DB_OK);
+      UNIT_TEST_ASSERT(db_get_value(&value, &handle, 1) == DB_OK);
+      UNIT_TEST_ASSERT(VALUE_LONG(&value) == reading_value(VALUE_INT(&id)));
+      UNIT_TEST_ASSERT(VALUE_LONG(&value) > THRESHOLD);
+      matching++;
+    } else if(result != DB_OK) {
+      UNIT_TEST_ASSERT(result == DB_FINISHED);
+      break;
+    }
+  }
+  db_free(&handle);
+
+  UNIT_TEST_ASSERT(matching == expected);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(block_join, "Block nested-loop join");
+UNIT_TEST(block_join)
+{
+  attribute_value_t id, value, gain;
+  unsigned matching;
+  db_result_t result;
+
+  UNIT_TEST_BEGIN();
+
+  result = db_query(&handle, "JOIN readings, gains ON id PROJECT id, value, gain;");
+  UNIT_TEST_ASSERT(!DB_ERROR(result));
+  UNIT_TEST_ASSERT(handle.flags & DB_HANDLE_FLAG_BLOCK_JOIN);
+
+  matching = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      UNIT_TEST_ASSERT(db_get_value(&id, &handle, 0) == DB_OK);
+      UNIT_TEST_ASSERT(db_get_value(&value, &handle, 1) == DB_OK);
+      UNIT_TEST_ASSERT(db_get_value(&gain, &handle, 2) == DB_OK);
+      UNIT_TEST_ASSERT(VALUE_INT(&id) < GAIN_IDS);
+      UNIT_TEST_ASSERT(VALUE_LONG(&value) == reading_value(VALUE_INT(&id)));
+      UNIT_TEST_ASSERT(VALUE_LONG(&gain) % GAIN_IDS == VALUE_INT(&id));
+      matching++;
+    } else if(result != DB_OK) {
+      UNIT_TEST_ASSERT(result == DB_FINISHED);
+      break;
+    }
+  }
+  db_free(&handle);
+
+  UNIT_TEST_ASSERT(matching == GAINS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(hash_join, "Hash join");
+UNIT_TEST(hash_join)
+{
+  attribute_value_t id, name;
+  char expected[8];
+  unsigned matching;
+  db_result_t result;
+
+  UNIT_TEST_BEGIN();
+
+  result = db_query(&handle, "JOIN readings, labels ON id PROJECT id, name;");
+  UNIT_TEST_ASSERT(!DB_ERROR(result));
+  UNIT_TEST_ASSERT(handle.flags & DB_HANDLE_FLAG_HASH_JOIN);
+
+  matching = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      UNIT_TEST_ASSERT(db_get_value(&id, &handle, 0) == DB_OK);
+      UNIT_TEST_ASSERT(db_get_value(&name, &handle, 1) == DB_OK);
+      snprintf(expected, sizeof(expected), "L%d", (int)VALUE_INT(&id));
+      UNIT_TEST_ASSERT(strcmp((char *)VALUE_STRING(&name), expected) == 0);
+      matching++;
+    } else if(result != DB_OK) {
+      UNIT_TEST_ASSERT(result == DB_FINISHED);
+      break;
+    }
+  }
+  db_free(&handle);
+
+  UNIT_TEST_ASSERT(matching == LABELS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  cfs_coffee_format();
+  db_init();
+
+  if(DB_ERROR(create_readings()) || DB_ERROR(create_gains()) ||
+     DB_ERROR(create_labels())) {
+    printf("=check-me= FAILED   - could not create the relations\n");
+  } else {
+    UNIT_TEST_RUN(cursor);
+    UNIT_TEST_RUN(select);
+    UNIT_TEST_RUN(block_join);
+    UNIT_TEST_RUN(hash_join);
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
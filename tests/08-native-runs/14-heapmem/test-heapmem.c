@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Checks that heapmem reuses freed chunks of the same size, merges
+ *         adjacent free chunks as they are freed, grows objects in place,
+ *         and keeps its contents intact and its searches short under a
+ *         random mix of allocations and deallocations.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "lib/heapmem.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define OBJECTS 48
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static uint8_t *objects[OBJECTS];
+static size_t lengths[OBJECTS];
+
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(uint8_t *data, size_t len, unsigned seed)
+{
+  size_t i;
+
+  for(i = 0; i < len; i++) {
+    data[i] = seed + i;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+check(const uint8_t *data, size_t len, unsigned seed)
+{
+  size_t i;
+
+  for(i = 0; i < len; i++) {
+    if(data[i] != (uint8_t)(seed + i)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static size_t
+footprint(void)
+{
+  heapmem_stats_t stats;
+
+  heapmem_stats(&stats);
+  return stats.footprint;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(reuse, "Freed chunks are reused by size");
+UNIT_TEST(reuse)
+{
+  void *a, *b, *c, *d, *e;
+  heapmem_stats_t stats;
+
+  UNIT_TEST_BEGIN();
+
+  a = heapmem_alloc(16);
+  b = heapmem_alloc(16);
+  c = heapmem_alloc(24);
+  d = heapmem_alloc(16);
+  UNIT_TEST_ASSERT(a != NULL && b != NULL && c != NULL && d != NULL);
+
+  /* Each freed chunk goes back to the list of its own size. */
+  heapmem_free(b);
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.free_chunks == 1);
+  e = heapmem_alloc(24);
+  UNIT_TEST_ASSERT(e != NULL && e != b);
+  UNIT_TEST_ASSERT(heapmem_alloc(16) == b);
+
+  heapmem_free(c);
+  UNIT_TEST_ASSERT(heapmem_alloc(20) == c);
+
+  heapmem_free(a);
+  heapmem_free(b);
+  heapmem_free(c);
+  heapmem_free(d);
+  heapmem_free(e);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(merge, "Adjacent free chunks are merged");
+UNIT_TEST(merge)
+{
+  uint8_t *a, *b, *c, *d, *e;
+  heapmem_stats_t stats;
+  size_t merged;
+
+  UNIT_TEST_BEGIN();
+
+  /* The earlier tests must have left the heap empty. */
+  UNIT_TEST_ASSERT(footprint() == 0);
+
+  a = heapmem_alloc(32);
+  b = heapmem_alloc(32);
+  c = heapmem_alloc(32);
+  d = heapmem_alloc(32);
+  UNIT_TEST_ASSERT(a != NULL && b != NULL && c != NULL && d != NULL);
+
+  /* Free a chunk after its neighbors, and before them. */
+  heapmem_free(a);
+  heapmem_free(c);
+  heapmem_free(b);
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.free_chunks == 1);
+  merged = (d - a) - (b - a - 32);
+  UNIT_TEST_ASSERT(stats.largest_free >= merged);
+
+  /* The merged chunk holds one large object at its start. */
+  e = heapmem_alloc(merged);
+  UNIT_TEST_ASSERT(e == a);
+  heapmem_free(e);
+
+  /* Freeing the last chunk gives everything back to the heap. */
+  heapmem_free(d);
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.footprint == 0);
+  UNIT_TEST_ASSERT(stats.free_chunks == 0);
+  UNIT_TEST_ASSERT(stats.largest_free == HEAPMEM_CONF_ARENA_SIZE);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(realloc, "Objects grow into free neighbors");
+UNIT_TEST(realloc)
+{
+  uint8_t *a, *b, *c;
+
+  UNIT_TEST_BEGIN();
+
+  a = heapmem_alloc(40);
+  b = heapmem_alloc(200);
+  c = heapmem_alloc(8);
+  UNIT_TEST_ASSERT(a != NULL && b != NULL && c != NULL);
+  fill(a, 40, 1);
+
+  heapmem_free(b);
+  UNIT_TEST_ASSERT(heapmem_realloc(a, 120) == a);
+  UNIT_TEST_ASSERT(check(a, 40, 1));
+
+  /* The rest of the neighbor is still free, and can grow further. */
+  fill(a, 120, 2);
+  UNIT_TEST_ASSERT(heapmem_realloc(a, 200) == a);
+  UNIT_TEST_ASSERT(check(a, 120, 2));
+
+  /* Shrinking leaves the tail for other objects. */
+  UNIT_TEST_ASSERT(heapmem_realloc(a, 16) == a);
+  b = heapmem_alloc(100);
+  UNIT_TEST_ASSERT(b > a && b < c);
+  UNIT_TEST_ASSERT(check(a, 16, 2));
+
+  heapmem_free(a);
+  heapmem_free(b);
+  heapmem_free(c);
+  UNIT_TEST_ASSERT(footprint() == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(random_mix, "Random allocations stay intact");
+UNIT_TEST(random_mix)
+{
+  unsigned round;
+  unsigned i;
+  size_t length;
+  uint8_t *resized;
+  heapmem_stats_t stats;
+
+  UNIT_TEST_BEGIN();
+
+  for(round = 0; round < 20000; round++) {
+    i = random_rand() % OBJECTS;
+    if(objects[i] != NULL) {
+      UNIT_TEST_ASSERT(check(objects[i], lengths[i], i));
+      if(random_rand() % 4 == 0) {
+        /* A failed resize leaves the object where it was. */
+        length = random_rand() % 200 + 1;
+        resized = heapmem_realloc(objects[i], length);
+        if(resized != NULL) {
+          UNIT_TEST_ASSERT(check(resized, MIN(length, lengths[i]), i));
+          objects[i] = resized;
+          lengths[i] = length;
+          fill(objects[i], lengths[i], i);
+        }
+      } else {
+        heapmem_free(objects[i]);
+        objects[i] = NULL;
+      }
+    } else {
+      /* Mostly small objects, with an occasional large one. */
+      lengths[i] = random_rand() % 8 == 0 ?
+        random_rand() % 400 + 1 : random_rand() % 48 + 1;
+      objects[i] = heapmem_alloc(lengths[i]);
+      if(objects[i] != NULL) {
+        fill(objects[i], lengths[i], i);
+      }
+    }
+  }
+
+  for(i = 0; i < OBJECTS; i++) {
+    if(objects[i] != NULL) {
+      UNIT_TEST_ASSERT(check(objects[i], lengths[i], i));
+      heapmem_free(objects[i]);
+      objects[i] = NULL;
+    }
+  }
+
+  heapmem_stats(&stats);
+  printf("TEST: longest search %u chunks, %u failed allocations\n",
+         (unsigned)stats.max_search, (unsigned)stats.failures);
+  UNIT_TEST_ASSERT(stats.footprint == 0);
+  UNIT_TEST_ASSERT(stats.allocated == 0);
+  UNIT_TEST_ASSERT(stats.available == HEAPMEM_CONF_ARENA_SIZE);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(reuse);
+  UNIT_TEST_RUN(merge);
+  UNIT_TEST_RUN(realloc);
+  UNIT_TEST_RUN(random_mix);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Sets a few hundred callback timers and checks that they are
+ *         called once each, in deadline order, unless stopped; that
+ *         periodic timers do not drift; that a callback that keeps
+ *         setting its timer to expire at once does not stall the system;
+ *         and that stopping a timer that was never set leaves the
+ *         pending timers alone.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TIMERS        300
+#define SPREAD        (CLOCK_SECOND / 2)
+#define PERIOD        (CLOCK_SECOND / 20)
+#define PERIODS       10
+#define RESTARTS      100
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static struct ctimer timers[TIMERS];
+static uint8_t calls[TIMERS];
+static clock_time_t last_expiration;
+static int out_of_order;
+
+static struct ctimer periodic;
+static clock_time_t first_expiration;
+static unsigned periods;
+static int drifted;
+
+static struct ctimer restarting;
+static unsigned restarts;
+
+static struct ctimer stale_ctimers[3];
+static struct etimer stale_etimers[3];
+static struct ctimer ctimer_copy;
+static struct etimer etimer_copy;
+static unsigned stale_calls;
+
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+count_call(void *ptr)
+{
+  struct ctimer *c = ptr;
+  clock_time_t expiration = etimer_expiration_time(&c->etimer);
+
+  if(expiration < last_expiration) {
+    out_of_order++;
+  }
+  last_expiration = expiration;
+  calls[c - timers]++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+periodic_call(void *ptr)
+{
+  periods++;
+  if(etimer_expiration_time(&periodic.etimer) !=
+     first_expiration + (periods - 1) * PERIOD) {
+    drifted = 1;
+  }
+  if(periods < PERIODS) {
+    ctimer_reset(&periodic);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+restart_call(void *ptr)
+{
+  if(++restarts < RESTARTS) {
+    ctimer_set(&restarting, 0, restart_call, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+stale_call(void *ptr)
+{
+  stale_calls++;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(set_all, "Timers are set and stopped");
+UNIT_TEST(set_all)
+{
+  unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < TIMERS; i++) {
+    UNIT_TEST_ASSERT(ctimer_expired(&timers[i]));
+    ctimer_set(&timers[i], random_rand() % SPREAD + 1, count_call, &timers[i]);
+    UNIT_TEST_ASSERT(!ctimer_expired(&timers[i]));
+  }
+
+  /* Stop some of the timers, one of them twice. */
+  for(i = 0; i < TIMERS; i += 7) {
+    ctimer_stop(&timers[i]);
+    UNIT_TEST_ASSERT(ctimer_expired(&timers[i]));
+  }
+  ctimer_stop(&timers[0]);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(called_once, "Timers are called once in deadline order");
+UNIT_TEST(called_once)
+{
+  unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < TIMERS; i++) {
+    UNIT_TEST_ASSERT(ctimer_expired(&timers[i]));
+    UNIT_TEST_ASSERT(calls[i] == (i % 7 == 0 ? 0 : 1));
+  }
+  UNIT_TEST_ASSERT(out_of_order == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(no_drift, "Reset timers do not drift");
+UNIT_TEST(no_drift)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(periods == PERIODS);
+  UNIT_TEST_ASSERT(!drifted);
+  UNIT_TEST_ASSERT(ctimer_expired(&periodic));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(no_stall, "Timers set to expire at once do not stall");
+UNIT_TEST(no_stall)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(restarts == RESTARTS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(stale_copies, "Stopping a stale timer copy is harmless");
+UNIT_TEST(stale_copies)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(stale_calls == 3);
+  for(i = 0; i < 3; i++) {
+    UNIT_TEST_ASSERT(ctimer_expired(&stale_ctimers[i]));
+    UNIT_TEST_ASSERT(etimer_expired(&stale_etimers[i]));
+  }
+  UNIT_TEST_ASSERT(ctimer_expired(&ctimer_copy));
+  UNIT_TEST_ASSERT(etimer_expired(&etimer_copy));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer wait;
+  static unsigned polls;
+  struct ctimer_stats stats;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(set_all);
+
+  etimer_set(&wait, SPREAD + CLOCK_SECOND / 10);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+  UNIT_TEST_RUN(called_once);
+
+  ctimer_set(&periodic, PERIOD, periodic_call, NULL);
+  first_expiration = etimer_expiration_time(&periodic.etimer);
+  etimer_set(&wait, PERIOD * PERIODS + CLOCK_SECOND / 10);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+  UNIT_TEST_RUN(no_drift);
+
+  /* This process must get to run while the callback restarts. */
+  ctimer_set(&restarting, 0, restart_call, NULL);
+  for(polls = 0; restarts < RESTARTS; polls++) {
+    process_poll(PROCESS_CURRENT());
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+  }
+  UNIT_TEST_RUN(no_stall);
+
+  /*
+   * The last timer ends up behind the second one among the children of
+   * the first. A copy of it, such as a timer in memory that was not
+   * cleared, must not be taken for the timer itself.
+   */
+  ctimer_set(&stale_ctimers[0], PERIOD, stale_call, NULL);
+  ctimer_set(&stale_ctimers[2], 3 * PERIOD, stale_call, NULL);
+  ctimer_set(&stale_ctimers[1], 2 * PERIOD, stale_call, NULL);
+  etimer_set(&stale_etimers[0], PERIOD);
+  etimer_set(&stale_etimers[2], 3 * PERIOD);
+  etimer_set(&stale_etimers[1], 2 * PERIOD);
+  memcpy(&ctimer_copy, &stale_ctimers[2], sizeof(ctimer_copy));
+  memcpy(&etimer_copy, &stale_etimers[2], sizeof(etimer_copy));
+  ctimer_stop(&ctimer_copy);
+  etimer_stop(&etimer_copy);
+  etimer_set(&wait, 3 * PERIOD + CLOCK_SECOND / 10);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+  UNIT_TEST_RUN(stale_copies);
+
+  ctimer_stats(&stats);
+  printf("TEST: %lu callbacks, %lu ticks average and %lu ticks maximum latency, "
+         "%u polls\n", stats.callbacks,
+         stats.callbacks ? stats.total_latency / stats.callbacks : 0,
+         (unsigned long)stats.max_latency, polls);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
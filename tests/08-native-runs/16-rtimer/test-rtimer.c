@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Runs thousands of real-time tasks from a few self-rescheduling
+ *         chains of different priorities, while the test process keeps
+ *         moving a task of its own, and checks that no task runs early,
+ *         that tasks of the same priority run in time order, and that the
+ *         jitter stays small. Also checks the priority order of tasks that
+ *         are due at once, and the overlap and rescheduling logic. Works
+ *         with both the timerfd and the signal backend of native.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "sys/rtimer.h"
+#include "sys/critical.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+
+#define CHAINS        8
+#define PRIORITIES    3
+#define RUNS          4000
+
+/* Independent of the rtimer resolution */
+#define MS(ms)        ((rtimer_clock_t)(ms) * (RTIMER_SECOND / 1000))
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+struct run {
+  rtimer_clock_t time;
+  rtimer_clock_t start;
+  uint8_t priority;
+};
+
+static struct rtimer chains[CHAINS];
+static rtimer_clock_t chains_started;
+static struct run runs[RUNS];
+static volatile unsigned run_count;
+
+static struct rtimer moving;
+static volatile unsigned moving_runs;
+
+static uint32_t seed = 1;
+
+static struct rtimer tasks[5];
+static volatile unsigned task_runs[5];
+static uint8_t order[3];
+static volatile unsigned order_count;
+static unsigned long overlaps;
+
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The tasks run in a signal handler, where rand() could deadlock. */
+static unsigned
+next_random(void)
+{
+  seed = seed * 1103515245 + 12345;
+  return seed >> 16;
+}
+/*---------------------------------------------------------------------------*/
+static void
+chain_run(struct rtimer *t, void *ptr)
+{
+  struct run *r;
+
+  if(run_count >= RUNS) {
+    return;
+  }
+
+  r = &runs[run_count++];
+  r->time = RTIMER_TIME(t);
+  r->start = RTIMER_NOW();
+  r->priority = t->priority;
+
+  /* Keep to the schedule, even when late. */
+  rtimer_set_with_priority(t, RTIMER_TIME(t) + MS(1 + next_random() % 8), 0,
+                           chain_run, NULL, t->priority);
+}
+/*---------------------------------------------------------------------------*/
+static void
+moving_run(struct rtimer *t, void *ptr)
+{
+  moving_runs++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+task_run(struct rtimer *t, void *ptr)
+{
+  task_runs[t - tasks]++;
+  if(order_count < sizeof(order)) {
+    order[order_count++] = t->priority;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+wait_ticks(rtimer_clock_t ticks)
+{
+  rtimer_clock_t start = RTIMER_NOW();
+
+  while(RTIMER_CLOCK_LT(RTIMER_NOW(), start + ticks));
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(stress, "Interleaved tasks run in order");
+UNIT_TEST(stress)
+{
+  unsigned i, j;
+  rtimer_clock_t total;
+  rtimer_clock_t lateness, max_lateness;
+  rtimer_clock_t last[PRIORITIES];
+  struct rtimer_stats stats;
+
+  UNIT_TEST_BEGIN();
+
+  rtimer_stats(&stats);
+  UNIT_TEST_ASSERT(run_count == RUNS);
+  UNIT_TEST_ASSERT(moving_runs > 0);
+  UNIT_TEST_ASSERT(stats.runs == RUNS + CHAINS + moving_runs);
+
+  total = 0;
+  max_lateness = 0;
+  for(j = 0; j < PRIORITIES; j++) {
+    last[j] = chains_started;
+  }
+  for(i = 0; i < RUNS; i++) {
+    /* A task never starts before its time. */
+    UNIT_TEST_ASSERT(!RTIMER_CLOCK_LT(runs[i].start, runs[i].time));
+    lateness = runs[i].start - runs[i].time;
+    total += lateness;
+    if(lateness > max_lateness) {
+      max_lateness = lateness;
+    }
+
+    /* Tasks of the same priority run in time order. */
+    UNIT_TEST_ASSERT(!RTIMER_CLOCK_LT(runs[i].time, last[runs[i].priority]));
+    last[runs[i].priority] = runs[i].time;
+  }
+
+  printf("TEST: %u runs, %lu us average and %lu us maximum lateness, "
+         "%lu missed\n", RUNS,
+         (unsigned long)(RTIMERTICKS_TO_US(total) / RUNS),
+         (unsigned long)RTIMERTICKS_TO_US(max_lateness), stats.missed);
+  UNIT_TEST_ASSERT(max_lateness < RTIMER_SECOND / 4);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_priority_tasks(void)
+{
+  rtimer_clock_t now;
+  int_master_status_t status;
+
+  /* Hold the tasks back until all three are due. */
+  status = critical_enter();
+  now = RTIMER_NOW();
+  rtimer_set_with_priority(&tasks[0], now + MS(1), 0, task_run, NULL, 0);
+  rtimer_set_with_priority(&tasks[1], now + MS(1), 0, task_run, NULL, 1);
+  rtimer_set_with_priority(&tasks[2], now + MS(2), 0, task_run, NULL, 2);
+  wait_ticks(MS(5));
+  critical_exit(status);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(priority, "Due tasks run in priority order");
+UNIT_TEST(priority)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(order_count == 3);
+  UNIT_TEST_ASSERT(order[0] == 2 && order[1] == 1 && order[2] == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_overlapping_tasks(void)
+{
+  unsigned i;
+  rtimer_clock_t now;
+  struct rtimer_stats before, after;
+
+  for(i = 0; i < 5; i++) {
+    task_runs[i] = 0;
+  }
+
+  rtimer_stats(&before);
+  now = RTIMER_NOW();
+  /* The second task starts within the first. */
+  rtimer_set(&tasks[0], now + MS(20), MS(10), task_run, NULL);
+  rtimer_set(&tasks[1], now + MS(25), 0, task_run, NULL);
+  /* The fourth task runs into the third. */
+  rtimer_set(&tasks[2], now + MS(50), MS(20), task_run, NULL);
+  rtimer_set(&tasks[3], now + MS(40), MS(15), task_run, NULL);
+  /* The last task is moved, and only runs once. */
+  rtimer_set(&tasks[4], now + MS(30), MS(5), task_run, NULL);
+  rtimer_set(&tasks[4], now + MS(80), MS(5), task_run, NULL);
+  rtimer_stats(&after);
+  overlaps = after.overlaps - before.overlaps;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(overlap, "Overlapping tasks are counted");
+UNIT_TEST(overlap)
+{
+  unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(overlaps == 2);
+  for(i = 0; i < 5; i++) {
+    UNIT_TEST_ASSERT(task_runs[i] == 1);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static unsigned i;
+  static struct etimer wait;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  chains_started = RTIMER_NOW();
+  for(i = 0; i < CHAINS; i++) {
+    rtimer_set_with_priority(&chains[i], chains_started + MS(1 + i), 0,
+                             chain_run, NULL, i % PRIORITIES);
+  }
+
+  /* Keep moving a task of our own ahead of the chains. */
+  while(run_count < RUNS) {
+    rtimer_set(&moving, RTIMER_NOW() + MS(random_rand() % 4), 0,
+               moving_run, NULL);
+    PROCESS_PAUSE();
+  }
+
+  /* Let the chains and the moving task run for the last time. */
+  etimer_set(&wait, CLOCK_SECOND / 10);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+  UNIT_TEST_RUN(stress);
+
+  set_priority_tasks();
+  etimer_set(&wait, CLOCK_SECOND / 10);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+  UNIT_TEST_RUN(priority);
+
+  set_overlapping_tasks();
+  etimer_set(&wait, CLOCK_SECOND / 5);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+  UNIT_TEST_RUN(overlap);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Logs records in binary, and checks the frames that are written
+ *         for them, both at once and from the process that drains the
+ *         ring, as well as truncated arguments, records dropped on a full
+ *         ring and records below the log level.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "sys/log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_MODULE "Test"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+#define ARGS_SIZE (LOG_BINARY_SLOT_SIZE - 10)
+#define SEP LOG_BINARY_SEPARATOR
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+struct frame {
+  uint8_t len;
+  uint32_t id;
+  const uint8_t *args;
+};
+
+extern const char __start_log_fmt[];
+
+static uint8_t output[2048];
+static unsigned output_len;
+static unsigned long later_len;
+
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+test_output(const unsigned char *data, unsigned char len)
+{
+  if(output_len + len <= sizeof(output)) {
+    memcpy(&output[output_len], data, len);
+    output_len += len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Reads the frame at an offset of the output, and returns the next one. */
+static unsigned
+read_frame(unsigned offset, struct frame *f)
+{
+  uint8_t sum;
+  unsigned i;
+
+  if(offset + 11 > output_len || output[offset] != LOG_BINARY_MAGIC) {
+    return 0;
+  }
+  f->len = output[offset + 1];
+  if(offset + 11 + f->len > output_len) {
+    return 0;
+  }
+  sum = 0;
+  for(i = offset + 1; i < offset + 11 + f->len; i++) {
+    sum += output[i];
+  }
+  if(sum != 0xff) {
+    return 0;
+  }
+  f->id = output[offset + 2] | output[offset + 3] << 8 |
+    (uint32_t)output[offset + 4] << 16 | (uint32_t)output[offset + 5] << 24;
+  f->args = &output[offset + 10];
+  return offset + 11 + f->len;
+}
+/*---------------------------------------------------------------------------*/
+static const char *
+record(const struct frame *f)
+{
+  return __start_log_fmt + f->id;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(frame, "Records are written on a flush");
+UNIT_TEST(frame)
+{
+  struct frame f;
+  int i;
+  long l;
+
+  UNIT_TEST_BEGIN();
+
+  output_len = 0;
+  LOG_INFO("value %d %s %lu\n", -5, "abc", 123456789UL);
+  LOG_INFO_("%c\n", 'x');
+  UNIT_TEST_ASSERT(output_len == 0);
+  log_binary_flush();
+
+  UNIT_TEST_ASSERT(read_frame(0, &f) != 0);
+  UNIT_TEST_ASSERT(f.len == sizeof(int) + 4 + sizeof(long));
+  UNIT_TEST_ASSERT(!strcmp(record(&f), "1" SEP "INFO" SEP "Test" SEP SEP
+                           "value %d %s %lu\n"));
+  memcpy(&i, f.args, sizeof(i));
+  UNIT_TEST_ASSERT(i == -5);
+  UNIT_TEST_ASSERT(!strcmp((const char *)f.args + sizeof(i), "abc"));
+  memcpy(&l, f.args + sizeof(i) + 4, sizeof(l));
+  UNIT_TEST_ASSERT(l == 123456789L);
+
+  UNIT_TEST_ASSERT(read_frame(11 + f.len, &f) == output_len);
+  UNIT_TEST_ASSERT(!strcmp(record(&f), "0" SEP "INFO" SEP "Test" SEP SEP
+                           "%c\n"));
+  memcpy(&i, f.args, sizeof(i));
+  UNIT_TEST_ASSERT(i == 'x');
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(process, "Records are written by the process");
+UNIT_TEST(process)
+{
+  struct frame f;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(later_len == 0);
+  UNIT_TEST_ASSERT(read_frame(0, &f) == output_len);
+  UNIT_TEST_ASSERT(!strcmp(record(&f), "1" SEP "WARN" SEP "Test" SEP SEP
+                           "later %u\n"));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(truncate, "Long arguments are truncated");
+UNIT_TEST(truncate)
+{
+  struct frame f;
+  char text[ARGS_SIZE * 2];
+  struct log_binary_stats before, after;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  memset(text, 'a', sizeof(text) - 1);
+  text[sizeof(text) - 1] = '\0';
+
+  log_binary_stats(&before);
+  output_len = 0;
+  LOG_INFO("%s %d\n", text, 1);
+  /* The text need not be terminated within the precision. */
+  LOG_INFO("%.*s\n", 3, "abcdef");
+  log_binary_flush();
+  log_binary_stats(&after);
+
+  UNIT_TEST_ASSERT(read_frame(0, &f) != 0);
+  UNIT_TEST_ASSERT(f.len == ARGS_SIZE);
+  UNIT_TEST_ASSERT(strlen((const char *)f.args) == ARGS_SIZE - 1);
+  UNIT_TEST_ASSERT(after.truncated == before.truncated + 1);
+
+  UNIT_TEST_ASSERT(read_frame(11 + f.len, &f) == output_len);
+  UNIT_TEST_ASSERT(f.len == sizeof(int) + 4);
+  memcpy(&i, f.args, sizeof(i));
+  UNIT_TEST_ASSERT(i == 3);
+  UNIT_TEST_ASSERT(!strcmp((const char *)f.args + sizeof(i), "abc"));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(drop, "Records are dropped on a full ring");
+UNIT_TEST(drop)
+{
+  struct frame f;
+  struct log_binary_stats before, after;
+  unsigned offset, next;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  log_binary_stats(&before);
+  output_len = 0;
+  for(i = 0; i < LOG_BINARY_SLOTS + 3; i++) {
+    LOG_INFO("record %d\n", i);
+  }
+  log_binary_flush();
+  log_binary_stats(&after);
+
+  UNIT_TEST_ASSERT(after.records == before.records + LOG_BINARY_SLOTS);
+  UNIT_TEST_ASSERT(after.dropped == before.dropped + 3);
+
+  /* The records that fit are kept in order, and the drops reported last. */
+  offset = 0;
+  for(i = 0; i < LOG_BINARY_SLOTS; i++) {
+    next = read_frame(offset, &f);
+    UNIT_TEST_ASSERT(next != 0);
+    UNIT_TEST_ASSERT(!memcmp(f.args, &i, sizeof(i)));
+    offset = next;
+  }
+  UNIT_TEST_ASSERT(read_frame(offset, &f) == output_len);
+  UNIT_TEST_ASSERT(f.id == LOG_BINARY_ID_DROPPED);
+  UNIT_TEST_ASSERT(f.len == 2 && f.args[0] == 3 && f.args[1] == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(level, "Records below the log level are not logged");
+UNIT_TEST(level)
+{
+  UNIT_TEST_BEGIN();
+
+  output_len = 0;
+  LOG_DBG("hidden %d\n", 1);
+  log_binary_flush();
+  UNIT_TEST_ASSERT(output_len == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer wait;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  /* Leave out the records of the boot. */
+  log_binary_flush();
+
+  UNIT_TEST_RUN(frame);
+
+  output_len = 0;
+  LOG_WARN("later %u\n", 7u);
+  later_len = output_len;
+  etimer_set(&wait, 1);
+  PROCESS_WAIT_UNTIL(etimer_expired(&wait));
+  UNIT_TEST_RUN(process);
+
+  UNIT_TEST_RUN(truncate);
+  UNIT_TEST_RUN(drop);
+  UNIT_TEST_RUN(level);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
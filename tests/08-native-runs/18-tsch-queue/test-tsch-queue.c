@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Checks which unicast packets TSCH picks for slots to the broadcast
+ *         address: a neighbor in backoff is served in dedicated slots but
+ *         not in shared ones until its backoff expires, and neighbors are
+ *         served in turn in shared slots.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "net/packetbuf.h"
+#include "net/mac/tsch/tsch.h"
+
+#include <stdio.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* The parts of tsch.c that the queue uses */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff } };
+const linkaddr_t tsch_eb_address = { { 0, 0, 0, 0, 0, 0, 0, 0 } };
+int tsch_is_coordinator;
+
+static struct tsch_link shared_link = {
+  .link_options = LINK_OPTION_TX | LINK_OPTION_SHARED,
+};
+static struct tsch_link dedicated_link = {
+  .link_options = LINK_OPTION_TX,
+};
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_neighbor *
+add_packet(uint8_t id)
+{
+  linkaddr_t addr = { { id } };
+
+  packetbuf_clear();
+  if(tsch_queue_add_packet(&addr, 1, NULL, NULL) == NULL) {
+    return NULL;
+  }
+  return tsch_queue_get_nbr(&addr);
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the neighbor whose packet is picked for the link, and sends it */
+static struct tsch_neighbor *
+send_any(struct tsch_link *link)
+{
+  struct tsch_neighbor *n = NULL;
+  struct tsch_packet *p = tsch_queue_get_unicast_packet_for_any(&n, link);
+
+  if(p == NULL) {
+    return NULL;
+  }
+  tsch_queue_packet_sent(n, p, link, MAC_TX_OK);
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(backoff, "Backoff on dedicated and shared links");
+UNIT_TEST(backoff)
+{
+  struct tsch_neighbor *n;
+  struct tsch_packet *p;
+  struct tsch_neighbor *picked;
+
+  UNIT_TEST_BEGIN();
+
+  n = add_packet(1);
+  UNIT_TEST_ASSERT(n != NULL);
+  tsch_queue_backoff_inc(n);
+  UNIT_TEST_ASSERT(!tsch_queue_backoff_expired(n));
+
+  /* Not in a shared slot, but in a dedicated one */
+  picked = NULL;
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&picked, &shared_link) == NULL);
+  p = tsch_queue_get_unicast_packet_for_any(&picked, &dedicated_link);
+  UNIT_TEST_ASSERT(p != NULL);
+  UNIT_TEST_ASSERT(picked == n);
+
+  /* In a shared slot once the backoff has expired */
+  while(!tsch_queue_backoff_expired(n)) {
+    UNIT_TEST_ASSERT(send_any(&shared_link) == NULL);
+    tsch_queue_update_all_backoff_windows(&tsch_broadcast_address);
+  }
+  UNIT_TEST_ASSERT(send_any(&shared_link) == n);
+  UNIT_TEST_ASSERT(tsch_queue_is_empty(n));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(turns, "Neighbors served in turn in shared slots");
+UNIT_TEST(turns)
+{
+  struct tsch_neighbor *nbrs[3];
+  int i;
+  int j;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < 2; i++) {
+    for(j = 0; j < 3; j++) {
+      nbrs[j] = add_packet(2 + j);
+      UNIT_TEST_ASSERT(nbrs[j] != NULL);
+    }
+  }
+
+  for(i = 0; i < 2; i++) {
+    for(j = 0; j < 3; j++) {
+      UNIT_TEST_ASSERT(send_any(&shared_link) == nbrs[j]);
+    }
+  }
+  UNIT_TEST_ASSERT(send_any(&shared_link) == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  tsch_queue_init();
+
+  UNIT_TEST_RUN(backoff);
+  UNIT_TEST_RUN(turns);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Builds random TSCH schedules, with links and slotframes added and
+ *         removed in any order, and checks the links that the schedule
+ *         index finds against a walk of the link lists, which is how they
+ *         are found without the index.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "lib/random.h"
+#include "net/mac/tsch/tsch.h"
+
+#include <stdio.h>
+
+#define OPERATIONS   3000
+#define CHECKS       8
+#define HANDLES      TSCH_SCHEDULE_MAX_SLOTFRAMES
+#define MAX_SIZE     32
+#define CHANNELS     2
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* The parts of tsch.c that the schedule and the queue use */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff } };
+const linkaddr_t tsch_eb_address = { { 0, 0, 0, 0, 0, 0, 0, 0 } };
+int tsch_is_coordinator;
+struct tsch_link *current_link;
+
+static const uint8_t options[] = {
+  LINK_OPTION_TX,
+  LINK_OPTION_RX,
+  LINK_OPTION_TX | LINK_OPTION_RX,
+  LINK_OPTION_TX | LINK_OPTION_RX | LINK_OPTION_SHARED,
+};
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The link at a timeslot and channel offset, from the link list */
+static struct tsch_link *
+walk_link_by_timeslot(struct tsch_slotframe *sf,
+                      uint16_t timeslot, uint16_t channel_offset)
+{
+  struct tsch_link *l;
+
+  for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+    if(l->timeslot == timeslot && l->channel_offset == channel_offset) {
+      return l;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* The next active link and its backup, from the link lists. No packets are
+ * queued, so of two Tx links of a slotframe, the first one is selected. */
+static struct tsch_link *
+walk_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset,
+                      struct tsch_link **backup_link)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_link *best = NULL;
+  struct tsch_link *backup = NULL;
+  uint16_t time_to_best = 0;
+
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+    struct tsch_link *l;
+    for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+      uint16_t time_to_timeslot = l->timeslot > timeslot ?
+        l->timeslot - timeslot : sf->size.val + l->timeslot - timeslot;
+      if(best == NULL || time_to_timeslot < time_to_best) {
+        time_to_best = time_to_timeslot;
+        best = l;
+        backup = NULL;
+      } else if(time_to_timeslot == time_to_best) {
+        struct tsch_link *new_best = NULL;
+        if((best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+          if(l->slotframe_handle < best->slotframe_handle) {
+            new_best = l;
+          } else if(l->slotframe_handle == best->slotframe_handle) {
+            new_best = best;
+          }
+        } else if(l->link_options & LINK_OPTION_TX) {
+          new_best = l;
+        }
+        if(backup == NULL) {
+          if(new_best != l && (l->link_options & LINK_OPTION_RX)) {
+            backup = l;
+          }
+          if(new_best != best && (best->link_options & LINK_OPTION_RX)) {
+            backup = best;
+          }
+        }
+        if(new_best != NULL) {
+          best = new_best;
+        }
+      }
+    }
+  }
+  *time_offset = time_to_best;
+  *backup_link = backup;
+  return best;
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_slotframe *
+random_slotframe(void)
+{
+  return tsch_schedule_get_slotframe_by_handle(random_rand() % HANDLES);
+}
+/*---------------------------------------------------------------------------*/
+/* Adds or removes a slotframe or a link at random */
+static void
+change_schedule(void)
+{
+  unsigned op = random_rand() % 16;
+  struct tsch_slotframe *sf = random_slotframe();
+
+  if(op == 0) {
+    if(sf != NULL) {
+      tsch_schedule_remove_slotframe(sf);
+    } else {
+      tsch_schedule_add_slotframe(random_rand() % HANDLES,
+                                  1 + random_rand() % MAX_SIZE);
+    }
+  } else if(sf != NULL) {
+    uint16_t timeslot = random_rand() % sf->size.val;
+    uint16_t channel_offset = random_rand() % CHANNELS;
+    if(op < 10) {
+      linkaddr_t addr = { { 1 + random_rand() % 3 } };
+      tsch_schedule_add_link(sf, options[random_rand() % sizeof(options)],
+                             LINK_TYPE_NORMAL,
+                             random_rand() % 4 ? &addr : &tsch_broadcast_address,
+                             timeslot, channel_offset);
+    } else {
+      tsch_schedule_remove_link_by_timeslot(sf, timeslot, channel_offset);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(random_schedules, "Links found with the index");
+UNIT_TEST(random_schedules)
+{
+  static unsigned links_found;
+  int i;
+  int j;
+
+  UNIT_TEST_BEGIN();
+
+  random_init(0x5eed);
+  tsch_schedule_init();
+  links_found = 0;
+
+  for(i = 0; i < OPERATIONS; i++) {
+    change_schedule();
+
+    for(j = 0; j < CHECKS; j++) {
+      struct tsch_asn_t asn;
+      struct tsch_link *l;
+      struct tsch_link *backup;
+      struct tsch_link *walk_backup;
+      uint16_t time_offset;
+      uint16_t walk_time_offset;
+      struct tsch_slotframe *sf = random_slotframe();
+
+      asn.ls4b = ((uint32_t)random_rand() << 16) | random_rand();
+      asn.ms1b = random_rand() % 2;
+      l = tsch_schedule_get_next_active_link(&asn, &time_offset, &backup);
+      UNIT_TEST_ASSERT(l == walk_next_active_link(&asn, &walk_time_offset,
+                                                  &walk_backup));
+      UNIT_TEST_ASSERT(backup == walk_backup);
+      if(l != NULL) {
+        UNIT_TEST_ASSERT(time_offset == walk_time_offset);
+      }
+
+      if(sf != NULL) {
+        uint16_t timeslot = random_rand() % sf->size.val;
+        uint16_t channel_offset = random_rand() % CHANNELS;
+        l = tsch_schedule_get_link_by_timeslot(sf, timeslot, channel_offset);
+        UNIT_TEST_ASSERT(l == walk_link_by_timeslot(sf, timeslot, channel_offset));
+        links_found += l != NULL;
+      }
+    }
+  }
+
+  /* The schedules were neither empty nor full most of the time */
+  printf("Links found by timeslot: %u\n", links_found);
+  UNIT_TEST_ASSERT(links_found > OPERATIONS * CHECKS / 20);
+  UNIT_TEST_ASSERT(links_found < OPERATIONS * CHECKS / 2);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  tsch_queue_init();
+
+  UNIT_TEST_RUN(random_schedules);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
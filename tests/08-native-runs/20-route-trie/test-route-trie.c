@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Adds host routes until the route trie runs out of nodes, and
+ *         checks that a route that cannot be indexed is neither added
+ *         nor announced, that the routes already added are still found,
+ *         and that the route can be added once another one is removed.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "net/netstack.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOSTS 6
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static uip_ipaddr_t nexthop;
+static uip_ipaddr_t hosts[HOSTS];
+static int added;
+static struct uip_ds6_notification notification;
+static int route_adds, route_rms;
+
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+sink_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+sink_output(const linkaddr_t *localdest)
+{
+  uipbuf_clear();
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const struct network_driver route_sink_driver = {
+  "route sink",
+  sink_init,
+  NULL,
+  sink_output
+};
+/*---------------------------------------------------------------------------*/
+static void
+count_notification(int event, const uip_ipaddr_t *route,
+                   const uip_ipaddr_t *nexthop, int num_routes)
+{
+  if(event == UIP_DS6_NOTIFICATION_ROUTE_ADD) {
+    route_adds++;
+  } else if(event == UIP_DS6_NOTIFICATION_ROUTE_RM) {
+    route_rms++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+found(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r = uip_ds6_route_lookup(addr);
+
+  return r != NULL && uip_ipaddr_cmp(&r->ipaddr, addr);
+}
+/*---------------------------------------------------------------------------*/
+static int
+count_routes(void)
+{
+  uip_ds6_route_t *r;
+  int n = 0;
+
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    n++;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(full, "A route is not added when the trie is full");
+UNIT_TEST(full)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(added = 0; added < HOSTS; added++) {
+    if(uip_ds6_route_add(&hosts[added], 128, &nexthop) == NULL) {
+      break;
+    }
+  }
+  UNIT_TEST_ASSERT(added > 0 && added < HOSTS);
+  UNIT_TEST_ASSERT(added < UIP_DS6_ROUTE_NB);
+
+  /* The route that could not be added was not announced either */
+  UNIT_TEST_ASSERT(route_adds == added && route_rms == 0);
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == added);
+  UNIT_TEST_ASSERT(count_routes() == added);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&hosts[added]) == NULL);
+  for(i = 0; i < added; i++) {
+    UNIT_TEST_ASSERT(found(&hosts[i]));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(room, "A route is added once there is room in the trie");
+UNIT_TEST(room)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  uip_ds6_route_rm(uip_ds6_route_lookup(&hosts[0]));
+  UNIT_TEST_ASSERT(uip_ds6_route_add(&hosts[added], 128, &nexthop) != NULL);
+
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == added);
+  UNIT_TEST_ASSERT(count_routes() == added);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&hosts[0]) == NULL);
+  for(i = 1; i <= added; i++) {
+    UNIT_TEST_ASSERT(found(&hosts[i]));
+  }
+
+  /* Removing every route empties the trie */
+  while(uip_ds6_route_head() != NULL) {
+    uip_ds6_route_rm(uip_ds6_route_head());
+  }
+  for(i = 0; i < HOSTS; i++) {
+    UNIT_TEST_ASSERT(uip_ds6_route_lookup(&hosts[i]) == NULL);
+  }
+  UNIT_TEST_ASSERT(uip_ds6_route_add(&hosts[HOSTS - 1], 128, &nexthop) != NULL);
+  UNIT_TEST_ASSERT(found(&hosts[HOSTS - 1]));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  uip_lladdr_t lladdr;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  memset(&lladdr, 0, sizeof(lladdr));
+  lladdr.addr[0] = 0x02;
+  lladdr.addr[sizeof(lladdr) - 1] = 1;
+  uip_ip6addr(&nexthop, 0xfe80, 0, 0, 0, 0, 0, 0, 1);
+  uip_ds6_notification_add(&notification, count_notification);
+  uip_ds6_nbr_add(&nexthop, &lladdr, 1, NBR_REACHABLE,
+                  NBR_TABLE_REASON_UNDEFINED, NULL);
+  for(i = 0; i < HOSTS; i++) {
+    uip_ip6addr(&hosts[i], 0x2001, 0xdb8, 0, 0, 0, 0, 0, i + 1);
+  }
+
+  UNIT_TEST_RUN(full);
+  UNIT_TEST_RUN(room);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
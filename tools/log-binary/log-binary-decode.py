@@ -0,0 +1,329 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2026, RISE Research Institutes of Sweden AB
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+# 3. Neither the name of the copyright holder nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+# STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+# OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+"""Decode the binary log of a Contiki-NG firmware built with LOG_CONF_BINARY.
+
+The log is read from a file or from standard input, for example from
+serialdump or from the output of a native node, and printed as the text
+that the LOG macros would have printed. The format strings are read from
+the log_fmt section of the ELF file of the firmware, and the sizes of the
+arguments follow from its machine type. Bytes outside of log frames, such
+as printf output, are passed through as they are.
+
+Usage: log-binary-decode.py [-t] firmware.elf [log]
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MAGIC = 0x1e
+SEPARATOR = '\x1f'
+HEADER_SIZE = 10
+ID_DROPPED = 0xffffffff
+
+EM_AVR = 83
+EM_MSP430 = 105
+
+CONVERSION = re.compile(
+    r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|z|j|t|L)?([diouxXcpsfFeEgGaAn%])')
+
+
+class Firmware:
+    """The format table and the type sizes of a firmware."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            elf = f.read()
+        if elf[:4] != b'\x7fELF':
+            raise ValueError('%s is not an ELF file' % path)
+        is64 = elf[4] == 2
+        self.order = '<' if elf[5] == 1 else '>'
+        machine, = struct.unpack_from(self.order + 'H', elf, 18)
+
+        int_size = 2 if machine in (EM_AVR, EM_MSP430) else 4
+        ptr_size = 8 if is64 else int_size if int_size == 2 else 4
+        self.sizes = {
+            '': int_size,
+            'h': int_size,
+            'hh': int_size,
+            'l': 8 if is64 else 4,
+            'll': 8,
+            'j': 8,
+            'z': ptr_size,
+            't': ptr_size,
+            'p': ptr_size,
+        }
+
+        if is64:
+            shoff, = struct.unpack_from(self.order + 'Q', elf, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(
+                self.order + 'HHH', elf, 0x3a)
+            section = self.order + 'IIQQQQ'
+        else:
+            shoff, = struct.unpack_from(self.order + 'I', elf, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(
+                self.order + 'HHH', elf, 0x2e)
+            section = self.order + 'IIIIII'
+
+        sections = [struct.unpack_from(section, elf, shoff + i * shentsize)
+                    for i in range(shnum)]
+        names = sections[shstrndx]
+        self.table = None
+        for name, _, _, _, offset, size in sections:
+            start = names[4] + name
+            if elf[start:elf.index(b'\0', start)] == b'log_fmt':
+                self.table = elf[offset:offset + size]
+        if self.table is None:
+            raise ValueError('%s has no log_fmt section' % path)
+        if len(self.table) >= ID_DROPPED:
+            raise ValueError('the log_fmt section of %s is too large for '
+                             'the record ids' % path)
+
+    def record(self, record_id):
+        """Return the fields of the record at an offset of the table."""
+        if record_id >= len(self.table):
+            return None
+        end = self.table.index(b'\0', record_id)
+        fields = self.table[record_id:end].decode('utf-8', 'replace')
+        fields = fields.split(SEPARATOR, 4)
+        return fields if len(fields) == 5 else None
+
+
+class Arguments:
+    """The raw arguments of a frame, consumed in order."""
+
+    def __init__(self, firmware, data):
+        self.firmware = firmware
+        self.data = data
+        self.pos = 0
+
+    def integer(self, size, signed):
+        if self.pos + size > len(self.data):
+            raise IndexError
+        value = int.from_bytes(self.data[self.pos:self.pos + size],
+                               'little' if self.firmware.order == '<' else 'big',
+                               signed=signed)
+        self.pos += size
+        return value
+
+    def double(self):
+        if self.pos + 8 > len(self.data):
+            raise IndexError
+        value, = struct.unpack_from(self.firmware.order + 'd',
+                                    self.data, self.pos)
+        self.pos += 8
+        return value
+
+    def string(self):
+        if self.pos >= len(self.data):
+            raise IndexError
+        end = self.data.find(b'\0', self.pos)
+        if end < 0:
+            end = len(self.data)
+        value = self.data[self.pos:end].decode('utf-8', 'replace')
+        self.pos = end + 1
+        return value
+
+
+def convert(match, args):
+    """Format one conversion of a format string, as printf would."""
+    flags, width, precision, length, conv = match.groups()
+    length = length or ''
+    if conv == '%':
+        return '%'
+    if conv == 'n':
+        return ''
+
+    if width == '*':
+        width = args.integer(args.firmware.sizes[''], True)
+        if width < 0:
+            flags += '-'
+            width = -width
+        width = str(width)
+    if precision == '*':
+        precision = args.integer(args.firmware.sizes[''], True)
+        precision = None if precision < 0 else str(precision)
+    elif precision == '':
+        precision = '0'
+
+    if conv in 'di':
+        value = args.integer(args.firmware.sizes[length], True)
+        if length == 'h':
+            value = (value + 0x8000) % 0x10000 - 0x8000
+        elif length == 'hh':
+            value = (value + 0x80) % 0x100 - 0x80
+        conv = 'd'
+    elif conv in 'ouxX':
+        value = args.integer(args.firmware.sizes[length], False)
+        if length == 'h':
+            value &= 0xffff
+        elif length == 'hh':
+            value &= 0xff
+        if conv == 'u':
+            conv = 'd'
+        elif conv == 'o' and '#' in flags:
+            # Python would prefix 0o rather than 0.
+            flags = flags.replace('#', '').replace('0', '')
+            return ('%' + flags + (width or '') + 's') % \
+                ('0%o' % value if value else '0')
+    elif conv == 'c':
+        value = args.integer(args.firmware.sizes[''], True) & 0xff
+    elif conv == 'p':
+        value = '0x%x' % args.integer(args.firmware.sizes['p'], False)
+        conv = 's'
+        precision = None
+    elif conv == 's':
+        value = args.string()
+    elif conv in 'aA':
+        value = float.hex(args.double())
+        value = value.upper() if conv == 'A' else value
+        conv = 's'
+        precision = None
+    else:
+        value = args.double()
+
+    spec = '%' + flags + (width or '')
+    if precision is not None:
+        spec += '.' + precision
+    return (spec + conv) % value
+
+
+def format_message(firmware, fmt, data):
+    """Format a message, marking the arguments that did not fit a frame."""
+    args = Arguments(firmware, data)
+    missing = [False]
+
+    def replace(match):
+        if missing[0]:
+            return '?' if match.group(5) not in '%n' else convert(match, args)
+        try:
+            return convert(match, args)
+        except (IndexError, ValueError, TypeError, OverflowError):
+            missing[0] = True
+            return '?'
+
+    message = CONVERSION.sub(replace, fmt)
+    if missing[0]:
+        message = message.rstrip('\n') + ' [truncated]' + \
+            ('\n' if message.endswith('\n') else '')
+    return message
+
+
+def decode_frame(firmware, record_id, time, data, with_time):
+    """Return the text of a frame."""
+    if record_id == ID_DROPPED:
+        dropped = int.from_bytes(data[:2], 'little')
+        return '[binary log: %u records dropped]\n' % dropped
+
+    record = firmware.record(record_id)
+    if record is None:
+        return '[binary log: unknown record %u]\n' % record_id
+
+    newline, level, module, location, fmt = record
+    text = ''
+    if newline != '0':
+        if with_time:
+            text += '%10u ' % time
+        if module:
+            text += '[%-4s: %-10s] ' % (level, module)
+        if location:
+            text += '[%s] ' % location
+    return text + format_message(firmware, fmt, data)
+
+
+def decode(firmware, stream, out, with_time):
+    """Decode a stream until its end, writing text as soon as it is known."""
+    buf = b''
+    while True:
+        chunk = stream.read1(4096) if hasattr(stream, 'read1') \
+            else stream.read(4096)
+        if not chunk:
+            break
+        buf += chunk
+        pos = 0
+        text = bytearray()
+        while pos < len(buf):
+            start = buf.find(bytes([MAGIC]), pos)
+            if start < 0:
+                text += buf[pos:]
+                pos = len(buf)
+                break
+            text += buf[pos:start]
+            pos = start
+            if len(buf) - start < HEADER_SIZE:
+                break
+            length = buf[start + 1]
+            end = start + HEADER_SIZE + length + 1
+            if len(buf) < end:
+                break
+            if (sum(buf[start + 1:end - 1]) + buf[end - 1]) & 0xff != 0xff:
+                # Not a frame, but a byte of other output.
+                text.append(MAGIC)
+                pos = start + 1
+                continue
+            record_id, time = struct.unpack_from('<II', buf, start + 2)
+            text += decode_frame(firmware, record_id, time,
+                                 buf[start + HEADER_SIZE:end - 1],
+                                 with_time).encode('utf-8')
+            pos = end
+        buf = buf[pos:]
+        out.write(text)
+        out.flush()
+    out.write(buf)
+    out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode the binary log of a Contiki-NG firmware.')
+    parser.add_argument('-t', '--time', action='store_true',
+                        help='prefix each line with the clock time')
+    parser.add_argument('firmware', help='the ELF file of the firmware')
+    parser.add_argument('log', nargs='?',
+                        help='the log to decode, or standard input')
+    options = parser.parse_args()
+
+    try:
+        firmware = Firmware(options.firmware)
+    except (OSError, ValueError) as e:
+        sys.exit('log-binary-decode: %s' % e)
+
+    if options.log is None:
+        decode(firmware, sys.stdin.buffer, sys.stdout.buffer, options.time)
+    else:
+        with open(options.log, 'rb') as stream:
+            decode(firmware, stream, sys.stdout.buffer, options.time)
+
+
+if __name__ == '__main__':
+    main()